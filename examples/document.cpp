@@ -0,0 +1,105 @@
+#include <loltoml/document.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+/*
+ * This example loads a document into the built-in DOM and prints it back as JSON.
+ */
+
+
+void print_string(loltoml::string_view_t s) {
+    const char *hex_digits = "0123456789abcdef";
+
+    std::cout << "\"";
+
+    for (auto it = s.begin(); it != s.end(); ++it) {
+        char ch = *it;
+
+        if (ch == '\\') {
+            std::cout << "\\\\";
+        } else if (ch == '\"') {
+            std::cout << "\\\"";
+        } else if (static_cast<unsigned char>(ch) < 32) {
+            std::cout << "\\u00"
+                      << hex_digits[static_cast<unsigned char>(ch) / 16]
+                      << hex_digits[static_cast<unsigned char>(ch) % 16];
+        } else {
+            std::cout << ch;
+        }
+    }
+
+    std::cout << "\"";
+}
+
+void print_value(const loltoml::value_t &value) {
+    switch (value.type()) {
+    case loltoml::value_type_t::string: {
+        print_string(value.as_string());
+    } break;
+    case loltoml::value_type_t::integer: {
+        std::cout << value.as_integer();
+    } break;
+    case loltoml::value_type_t::floating_point: {
+        std::cout << value.as_floating_point();
+    } break;
+    case loltoml::value_type_t::boolean: {
+        std::cout << (value.as_boolean() ? "true" : "false");
+    } break;
+    case loltoml::value_type_t::datetime: {
+        print_string(value.as_datetime());
+    } break;
+    case loltoml::value_type_t::array: {
+        std::cout << "[";
+
+        bool first = true;
+        for (const loltoml::value_t &item : value.as_array()) {
+            if (!first) {
+                std::cout << ", ";
+            } else {
+                first = false;
+            }
+
+            print_value(item);
+        }
+
+        std::cout << "]";
+    } break;
+    case loltoml::value_type_t::table: {
+        std::cout << "{";
+
+        bool first = true;
+        for (const loltoml::table_member_t &member : value.as_table()) {
+            if (!first) {
+                std::cout << ", ";
+            } else {
+                first = false;
+            }
+
+            print_string(member.key);
+            std::cout << ": ";
+            print_value(member.value);
+        }
+
+        std::cout << "}";
+    } break;
+    }
+}
+
+int main() {
+    try {
+        loltoml::document_t document;
+        document.parse(std::cin);
+
+        print_value(document.root());
+        std::cout << "\n";
+    } catch (const loltoml::parser_error_t &e) {
+        std::cerr << "Parser error at " << e.offset() << ": " << e.message() << std::endl;
+        return 1;
+    } catch (const std::exception &e) {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,9 +1,8 @@
-#include <loltoml/parse.hpp>
+#include <loltoml/parser.hpp>
 
 #include <kora/dynamic.hpp>
 
 #include <iostream>
-#include <set>
 #include <stack>
 #include <stdexcept>
 #include <vector>
@@ -17,9 +16,7 @@
 
 
 struct handler_t {
-    // Since table [a] may appear after [a.b], we should track assigned/unassigned keys separately.
-    std::set<std::vector<std::string>> assigned_keys;
-    // Path to the current value (only keys from tables). It's used to add paths to assigned_keys.
+    // Path to the current value (only keys from tables).
     std::vector<std::string> path;
     // All the parent objects of the current value including arrays.
     std::stack<kora::dynamic_t*> stack;
@@ -60,7 +57,6 @@ struct handler_t {
 
     void array_table(loltoml::key_iterator_t begin, loltoml::key_iterator_t end) {
         path.assign(begin, end);
-        assigned_keys.insert(path);
 
         while (!stack.empty()) {
             stack.pop();
@@ -105,10 +101,6 @@ struct handler_t {
     void table(loltoml::key_iterator_t begin, loltoml::key_iterator_t end) {
         path.assign(begin, end);
 
-        if (!assigned_keys.insert(path).second) {
-            throw std::runtime_error("Duplicate key");
-        }
-
         while (!stack.empty()) {
             stack.pop();
         }
@@ -134,15 +126,6 @@ struct handler_t {
 
     void key(const std::string &key) {
         path.push_back(key);
-
-        // If path.size() != stack.size() then one of the parent objects is an array.
-        // Since every element of any array is processed only once,
-        // there is no need to track uniqueness of paths comming through arrays.
-        if (path.size() == stack.size()) {
-            if (!assigned_keys.insert(path).second) {
-                throw std::runtime_error("Duplicate key");
-            }
-        }
     }
 
     void start_array() {
@@ -190,7 +173,10 @@ struct handler_t {
 int main() {
     try {
         handler_t handler;
-        loltoml::parse(std::cin, handler);
+        loltoml::parser_t<handler_t> parser(handler);
+        // Uniqueness of keys and tables is checked by the parser.
+        parser.set_key_validation(true);
+        parser.parse(std::cin);
 
         kora::write_pretty_json(std::cout, handler.result);
     } catch (const std::exception &e) {
@@ -0,0 +1,33 @@
+#ifndef LOLTOML_ACTION_HPP
+#define LOLTOML_ACTION_HPP
+
+#include "loltoml/detail/common.hpp"
+
+LOLTOML_OPEN_NAMESPACE
+
+
+/*! What the parser should do after an event.
+ *
+ * Methods key(), table() and array_table() of the handler may return it instead of void. See loltoml::parse().
+ */
+enum class action_t {
+    //! Parse the value and emit its events as usual.
+    proceed,
+    /*! Skip the value of the key or the content of the table without emitting any events for it.
+     *
+     * The parser only tracks brackets and quotes of the values, so it doesn't unescape strings or convert numbers.
+     * Because of this, the skipped values are checked only for terminated strings and balanced brackets.
+     * Content of a table is skipped up to the next table header.
+     */
+    skip_value,
+    /*! Stop parsing right away.
+     *
+     * The parser returns false without reading the rest of the input and without calling finish_document().
+     */
+    stop
+};
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_ACTION_HPP
@@ -0,0 +1,499 @@
+#ifndef LOLTOML_BIND_HPP
+#define LOLTOML_BIND_HPP
+
+#include "loltoml/action.hpp"
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/for_each.hpp"
+#include "loltoml/detail/parser.hpp"
+#include "loltoml/error.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*! Bind members of a struct to TOML keys with the same names.
+ *
+ * Must be used in the namespace of the struct after its definition:
+ *
+ *     struct server_t { std::string host; std::uint16_t port; };
+ *     LOLTOML_BIND(server_t, host, port)
+ *
+ * Then loltoml::parse_into() can fill the struct. Supported member types are bool, integral types,
+ * floating point types, std::string, std::vector of supported types and other bound structs.
+ * The macro generates a function comparing length of the key first and then the key itself with constant strings,
+ * so no strings are hashed or allocated. Up to 64 members may be bound.
+ */
+#define LOLTOML_BIND(Type, ...) \
+    inline bool loltoml_bind_field(Type &loltoml_object, \
+                                   ::loltoml::string_view_t loltoml_key, \
+                                   ::loltoml::detail::field_visitor_t &loltoml_visitor) \
+    { \
+        LOLTOML_DETAIL_FOR_EACH(LOLTOML_DETAIL_BIND_FIELD, __VA_ARGS__) \
+        return false; \
+    }
+
+// Sizes are compile-time constants, so the compiler turns this into comparisons of integers.
+#define LOLTOML_DETAIL_BIND_FIELD(member) \
+    if (loltoml_key.size() == sizeof(#member) - 1 && \
+        std::memcmp(loltoml_key.data(), #member, sizeof(#member) - 1) == 0) \
+    { \
+        loltoml_visitor(loltoml_object.member); \
+        return true; \
+    }
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Thrown by the binding handler if a value doesn't match the type of the member.
+struct binding_error_t {
+    const char *message;
+};
+
+
+struct sink_ops_t;
+
+// Destination of a value: pointer to an object and operations applicable to it.
+struct sink_t {
+    void *object;
+    const sink_ops_t *ops;
+};
+
+// Unsupported operations are nullptr.
+struct sink_ops_t {
+    // Tables. Sets result to the member with the key (unknown keys give a sink ignoring everything).
+    bool (*field)(void *object, string_view_t key, sink_t &result);
+    // Arrays. item() appends a new item, last() returns the last one or false if the array is empty.
+    void (*item)(void *object, sink_t &result);
+    bool (*last)(void *object, sink_t &result);
+
+    void (*boolean)(void *object, bool value);
+    void (*integer)(void *object, std::int64_t value);
+    void (*floating_point)(void *object, double value);
+    void (*string)(void *object, string_view_t value);
+    void (*datetime)(void *object, string_view_t value);
+
+    // Error message for unsupported operations.
+    const char *expected;
+};
+
+
+template<class T, class Enable = void>
+struct binder_t;
+
+template<class T>
+sink_t make_sink(T &object) {
+    return sink_t {&object, &binder_t<T>::ops()};
+}
+
+
+// Passed to loltoml_bind_field() generated by LOLTOML_BIND.
+class field_visitor_t {
+public:
+    explicit field_visitor_t(sink_t &result) :
+        m_result(result)
+    { }
+
+    template<class T>
+    void operator()(T &member) {
+        m_result = make_sink(member);
+    }
+
+private:
+    sink_t &m_result;
+};
+
+
+template<class T>
+class is_bound_t {
+    template<class U>
+    static auto test(int) -> decltype(loltoml_bind_field(std::declval<U &>(),
+                                                         std::declval<string_view_t>(),
+                                                         std::declval<field_visitor_t &>()),
+                                      std::true_type());
+
+    template<class U>
+    static std::false_type test(...);
+
+public:
+    static const bool value = decltype(test<T>(0))::value;
+};
+
+
+// Accepts anything. Used for unknown keys.
+struct ignore_binder_t {
+    static bool field(void *, string_view_t, sink_t &result) {
+        result = sink();
+        return true;
+    }
+
+    static void item(void *, sink_t &result) {
+        result = sink();
+    }
+
+    static bool last(void *, sink_t &result) {
+        result = sink();
+        return true;
+    }
+
+    static void boolean(void *, bool) { }
+    static void integer(void *, std::int64_t) { }
+    static void floating_point(void *, double) { }
+    static void string(void *, string_view_t) { }
+
+    static sink_t sink() {
+        static const sink_ops_t ops = {
+            &field, &item, &last, &boolean, &integer, &floating_point, &string, &string, "Unexpected value"
+        };
+
+        return sink_t {nullptr, &ops};
+    }
+};
+
+
+template<>
+struct binder_t<bool> {
+    static void boolean(void *object, bool value) {
+        *static_cast<bool *>(object) = value;
+    }
+
+    static const sink_ops_t &ops() {
+        static const sink_ops_t result = {
+            nullptr, nullptr, nullptr, &boolean, nullptr, nullptr, nullptr, nullptr, "Expected a boolean"
+        };
+
+        return result;
+    }
+};
+
+
+template<class T>
+struct binder_t<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+    static void integer(void *object, std::int64_t value) {
+        if (!fits(value, std::is_signed<T>())) {
+            throw binding_error_t {"Integer is out of range"};
+        }
+
+        *static_cast<T *>(object) = static_cast<T>(value);
+    }
+
+    static bool fits(std::int64_t value, std::true_type) {
+        return value >= static_cast<std::int64_t>(std::numeric_limits<T>::min()) &&
+               value <= static_cast<std::int64_t>(std::numeric_limits<T>::max());
+    }
+
+    static bool fits(std::int64_t value, std::false_type) {
+        return value >= 0 &&
+               static_cast<std::uint64_t>(value) <= static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    }
+
+    static const sink_ops_t &ops() {
+        static const sink_ops_t result = {
+            nullptr, nullptr, nullptr, nullptr, &integer, nullptr, nullptr, nullptr, "Expected an integer"
+        };
+
+        return result;
+    }
+};
+
+
+// Integers are accepted too.
+template<class T>
+struct binder_t<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    static void integer(void *object, std::int64_t value) {
+        *static_cast<T *>(object) = static_cast<T>(value);
+    }
+
+    static void floating_point(void *object, double value) {
+        *static_cast<T *>(object) = static_cast<T>(value);
+    }
+
+    static const sink_ops_t &ops() {
+        static const sink_ops_t result = {
+            nullptr, nullptr, nullptr, nullptr, &integer, &floating_point, nullptr, nullptr, "Expected a float"
+        };
+
+        return result;
+    }
+};
+
+
+// Datetimes are stored as strings.
+template<>
+struct binder_t<std::string> {
+    static void string(void *object, string_view_t value) {
+        static_cast<std::string *>(object)->assign(value.data(), value.size());
+    }
+
+    static const sink_ops_t &ops() {
+        static const sink_ops_t result = {
+            nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, &string, &string, "Expected a string"
+        };
+
+        return result;
+    }
+};
+
+
+template<class T, class Allocator>
+struct binder_t<std::vector<T, Allocator>> {
+    typedef std::vector<T, Allocator> vector_t;
+
+    static void item(void *object, sink_t &result) {
+        vector_t &vector = *static_cast<vector_t *>(object);
+        vector.emplace_back();
+        result = make_sink(vector.back());
+    }
+
+    static bool last(void *object, sink_t &result) {
+        vector_t &vector = *static_cast<vector_t *>(object);
+
+        if (vector.empty()) {
+            return false;
+        }
+
+        result = make_sink(vector.back());
+        return true;
+    }
+
+    static const sink_ops_t &ops() {
+        static const sink_ops_t result = {
+            nullptr, &item, &last, nullptr, nullptr, nullptr, nullptr, nullptr, "Expected an array"
+        };
+
+        return result;
+    }
+};
+
+
+// Unknown keys are ignored.
+template<class T>
+struct binder_t<T, typename std::enable_if<is_bound_t<T>::value>::type> {
+    static bool field(void *object, string_view_t key, sink_t &result) {
+        field_visitor_t visitor(result);
+
+        if (!loltoml_bind_field(*static_cast<T *>(object), key, visitor)) {
+            result = ignore_binder_t::sink();
+        }
+
+        return true;
+    }
+
+    static const sink_ops_t &ops() {
+        static const sink_ops_t result = {
+            &field, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, "Expected a table"
+        };
+
+        return result;
+    }
+};
+
+
+// SAX handler writing values into a bound struct.
+template<class T>
+class binding_handler_t {
+public:
+    explicit binding_handler_t(T &object) :
+        m_root(make_sink(object))
+    { }
+
+    void start_document() {
+        m_stack.assign(1, m_root);
+        m_pending = m_root;
+    }
+
+    void finish_document() { }
+
+    void comment(string_view_t) { }
+
+    void table(key_iterator_t begin, key_iterator_t end) {
+        sink_t table = walk(begin, end);
+        require_table(table);
+        m_stack.assign(1, table);
+    }
+
+    void array_table(key_iterator_t begin, key_iterator_t end) {
+        sink_t array = walk(begin, end);
+
+        if (!array.ops->item) {
+            throw binding_error_t {array.ops->expected};
+        }
+
+        sink_t item;
+        array.ops->item(array.object, item);
+        require_table(item);
+        m_stack.assign(1, item);
+    }
+
+    // Values of unknown keys are skipped without parsing.
+    action_t key(string_view_t key) {
+        const sink_t &table = m_stack.back();
+        table.ops->field(table.object, key, m_pending);
+
+        return (m_pending.ops == ignore_binder_t::sink().ops) ? action_t::skip_value : action_t::proceed;
+    }
+
+    void start_array() {
+        sink_t array = next_value();
+
+        if (!array.ops->item) {
+            throw binding_error_t {array.ops->expected};
+        }
+
+        m_stack.push_back(array);
+    }
+
+    void finish_array(std::size_t) {
+        m_stack.pop_back();
+    }
+
+    void start_inline_table() {
+        sink_t table = next_value();
+        require_table(table);
+        m_stack.push_back(table);
+    }
+
+    void finish_inline_table(std::size_t) {
+        m_stack.pop_back();
+    }
+
+    void boolean(bool value) {
+        sink_t sink = next_value();
+        check(sink.ops->boolean, sink)(sink.object, value);
+    }
+
+    void string(string_view_t value) {
+        sink_t sink = next_value();
+        check(sink.ops->string, sink)(sink.object, value);
+    }
+
+    void datetime(string_view_t value) {
+        sink_t sink = next_value();
+        check(sink.ops->datetime, sink)(sink.object, value);
+    }
+
+    void integer(std::int64_t value) {
+        sink_t sink = next_value();
+        check(sink.ops->integer, sink)(sink.object, value);
+    }
+
+    void floating_point(double value) {
+        sink_t sink = next_value();
+        check(sink.ops->floating_point, sink)(sink.object, value);
+    }
+
+private:
+    template<class Function>
+    static Function check(Function function, const sink_t &sink) {
+        if (!function) {
+            throw binding_error_t {sink.ops->expected};
+        }
+
+        return function;
+    }
+
+    static void require_table(const sink_t &sink) {
+        if (!sink.ops->field) {
+            throw binding_error_t {sink.ops->expected};
+        }
+    }
+
+    // Either value of the last key or a new item of the current array.
+    sink_t next_value() {
+        const sink_t &parent = m_stack.back();
+
+        if (parent.ops->item && !parent.ops->field) {
+            sink_t item;
+            parent.ops->item(parent.object, item);
+            return item;
+        }
+
+        return m_pending;
+    }
+
+    // Returns member pointed by the path. Arrays of tables in the middle of the path resolve to their last items.
+    sink_t walk(key_iterator_t begin, key_iterator_t end) {
+        sink_t current = m_root;
+
+        for (; begin != end; ++begin) {
+            require_table(current);
+
+            sink_t next;
+            current.ops->field(current.object, *begin, next);
+
+            if (begin + 1 != end && next.ops->last && !next.ops->field) {
+                if (!next.ops->last(next.object, next)) {
+                    throw binding_error_t {"Expected a table"};
+                }
+            }
+
+            current = next;
+        }
+
+        return current;
+    }
+
+    sink_t m_root;
+    sink_t m_pending;
+    // Current table followed by inline tables and arrays being parsed.
+    std::vector<sink_t> m_stack;
+};
+
+
+template<class T, class Input>
+void parse_into(Input &input, T &object) {
+    binding_handler_t<T> handler(object);
+    parser_buffers_t buffers;
+    parser_t<Input, binding_handler_t<T>> parser(input, handler, buffers);
+
+    try {
+        parser.parse();
+    } catch (const binding_error_t &e) {
+        throw parser_error_t(e.message, input.processed());
+    }
+}
+
+
+} // namespace detail
+
+
+/*! Parse a TOML document from the stream into a struct bound with LOLTOML_BIND.
+ *
+ * Members which don't appear in the document keep their values, unknown keys are ignored.
+ * Values of unknown keys are skipped without parsing (see loltoml::action_t::skip_value).
+ * Uniqueness of keys isn't checked. Offsets of type mismatch errors point right after the offending value.
+ *
+ * \throws loltoml::parser_error_t if the input contains an invalid TOML document
+ *     or a value doesn't match the type of the member.
+ * \throws loltoml::stream_error_t if input.bad() becomes true.
+ */
+template<class T>
+inline void parse_into(std::istream &input, T &object) {
+    detail::input_stream_t stream(input);
+    detail::parse_into(stream, object);
+}
+
+//! Same as parse_into(std::istream &, T &) but reads the document from memory.
+template<class T>
+inline void parse_into(const char *data, std::size_t size, T &object) {
+    detail::input_buffer_t buffer(data, size);
+    detail::parse_into(buffer, object);
+}
+
+//! Same as parse_into(input.data(), input.size(), object).
+template<class T>
+inline void parse_into(string_view_t input, T &object) {
+    parse_into(input.data(), input.size(), object);
+}
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_BIND_HPP
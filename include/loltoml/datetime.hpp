@@ -0,0 +1,158 @@
+#ifndef LOLTOML_DATETIME_HPP
+#define LOLTOML_DATETIME_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+LOLTOML_OPEN_NAMESPACE
+
+
+/*! Datetime value split into fields.
+ *
+ * Handlers receive it if they have method datetime(const loltoml::datetime_t &).
+ * The fields are range-checked: month is 1-12, day exists in the month, hour is 0-23, minute is 0-59
+ * and second is 0-60 (60 is a leap second). The time is local, offset_minutes tells its offset from UTC.
+ */
+struct datetime_t {
+    int year;
+    int month;
+    int day;
+    int hour;
+    int minute;
+    int second;
+    //! Fractional part of the second. Digits beyond nanoseconds are dropped.
+    std::uint32_t nanoseconds;
+    //! Offset of the local time from UTC in minutes, e.g. -90 for "-01:30". It's 0 for "Z".
+    int offset_minutes;
+};
+
+
+namespace detail {
+
+
+inline bool is_leap_year(int year) {
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+inline int days_in_month(int year, int month) {
+    static const int days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (month == 2 && is_leap_year(year)) ? 29 : days[month - 1];
+}
+
+// Number of days since 1970-01-01 in the proleptic Gregorian calendar.
+// See http://howardhinnant.github.io/date_algorithms.html#days_from_civil
+inline std::int64_t days_from_civil(int year, int month, int day) {
+    std::int64_t y = month <= 2 ? year - 1 : year;
+    std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    std::int64_t year_of_era = y - era * 400;
+    std::int64_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    std::int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+inline int datetime_number(const char *digits, std::size_t size) {
+    int result = 0;
+
+    for (std::size_t i = 0; i < size; ++i) {
+        result = 10 * result + (digits[i] - '0');
+    }
+
+    return result;
+}
+
+/*! Splits a datetime into fields and checks their ranges.
+ *
+ * The text must be a well-formed datetime: "YYYY-MM-DDTHH:MM:SS", optional fraction of the second,
+ * and "Z" or "+HH:MM"/"-HH:MM".
+ * Returns nullptr on success. Otherwise returns an error message and sets error_position
+ * to the position of the bad field in the text.
+ */
+inline const char *decode_datetime(string_view_t text, datetime_t &result, std::size_t &error_position) {
+    const char *data = text.data();
+
+    result.year = datetime_number(data, 4);
+    result.month = datetime_number(data + 5, 2);
+    result.day = datetime_number(data + 8, 2);
+    result.hour = datetime_number(data + 11, 2);
+    result.minute = datetime_number(data + 14, 2);
+    result.second = datetime_number(data + 17, 2);
+    result.nanoseconds = 0;
+    result.offset_minutes = 0;
+
+    std::size_t position = 19;
+
+    if (data[position] == '.') {
+        std::uint32_t scale = 100000000;
+
+        for (++position; data[position] >= '0' && data[position] <= '9'; ++position) {
+            result.nanoseconds += scale * static_cast<std::uint32_t>(data[position] - '0');
+            scale /= 10;
+        }
+    }
+
+    std::size_t offset_position = position;
+
+    if (data[position] == '+' || data[position] == '-') {
+        int offset = 60 * datetime_number(data + position + 1, 2) + datetime_number(data + position + 4, 2);
+        result.offset_minutes = data[position] == '-' ? -offset : offset;
+    }
+
+    if (result.month < 1 || result.month > 12) {
+        error_position = 5;
+        return "Bad datetime. Month is out of range.";
+    } else if (result.day < 1 || result.day > days_in_month(result.year, result.month)) {
+        error_position = 8;
+        return "Bad datetime. Day is out of range.";
+    } else if (result.hour > 23) {
+        error_position = 11;
+        return "Bad datetime. Hour is out of range.";
+    } else if (result.minute > 59) {
+        error_position = 14;
+        return "Bad datetime. Minute is out of range.";
+    } else if (result.second > 60) {
+        error_position = 17;
+        return "Bad datetime. Second is out of range.";
+    } else if (data[offset_position] != 'z' && data[offset_position] != 'Z' &&
+               (datetime_number(data + offset_position + 1, 2) > 23 ||
+                datetime_number(data + offset_position + 4, 2) > 59))
+    {
+        error_position = offset_position;
+        return "Bad datetime. Time offset is out of range.";
+    }
+
+    return nullptr;
+}
+
+
+} // namespace detail
+
+
+/*! Converts the datetime to a point of time of the system clock.
+ *
+ * The system clock is assumed to count time since 1970-01-01T00:00:00Z (which is the case on all major platforms).
+ * Leap seconds are counted as the first second of the next minute.
+ * The datetime must be representable by std::chrono::system_clock::duration
+ * (e.g. years 1678-2261 for nanosecond durations).
+ */
+inline std::chrono::system_clock::time_point to_time_point(const datetime_t &value) {
+    std::int64_t seconds = detail::days_from_civil(value.year, value.month, value.day) * 86400 +
+                           value.hour * 3600 +
+                           value.minute * 60 +
+                           value.second -
+                           value.offset_minutes * 60;
+
+    typedef std::chrono::system_clock::duration duration_t;
+
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<duration_t>(std::chrono::seconds(seconds)) +
+        std::chrono::duration_cast<duration_t>(std::chrono::nanoseconds(value.nanoseconds))
+    );
+}
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DATETIME_HPP
@@ -0,0 +1,162 @@
+#ifndef LOLTOML_DETAIL_ARENA_HPP
+#define LOLTOML_DETAIL_ARENA_HPP
+
+#include "loltoml/detail/common.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Bump allocator. Memory is taken from a list of blocks growing geometrically and is freed all at once.
+// Objects allocated from the arena are never destroyed, so they must be trivially destructible.
+class arena_t {
+public:
+    enum : std::size_t {
+        min_block_size = 4096,
+        max_block_size = 16 * 1024 * 1024
+    };
+
+    arena_t() :
+        m_blocks(nullptr),
+        m_position(nullptr),
+        m_end(nullptr)
+    { }
+
+    arena_t(arena_t &&other) :
+        m_blocks(other.m_blocks),
+        m_position(other.m_position),
+        m_end(other.m_end)
+    {
+        other.m_blocks = nullptr;
+        other.m_position = nullptr;
+        other.m_end = nullptr;
+    }
+
+    arena_t &operator=(arena_t &&other) {
+        if (this != &other) {
+            free_blocks(m_blocks);
+
+            m_blocks = other.m_blocks;
+            m_position = other.m_position;
+            m_end = other.m_end;
+
+            other.m_blocks = nullptr;
+            other.m_position = nullptr;
+            other.m_end = nullptr;
+        }
+
+        return *this;
+    }
+
+    ~arena_t() {
+        free_blocks(m_blocks);
+    }
+
+    // Makes sure that at least size bytes can be allocated without allocating a new block.
+    void reserve(std::size_t size) {
+        if (static_cast<std::size_t>(m_end - m_position) < size) {
+            add_block(size);
+        }
+    }
+
+    void *allocate(std::size_t size, std::size_t alignment) {
+        assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+        std::size_t padding = padding_for(m_position, alignment);
+
+        if (!m_position || static_cast<std::size_t>(m_end - m_position) < size + padding) {
+            add_block(size + alignment);
+            padding = padding_for(m_position, alignment);
+        }
+
+        char *result = m_position + padding;
+        m_position = result + size;
+        return result;
+    }
+
+    template<class T>
+    T *allocate_array(std::size_t size) {
+        return static_cast<T *>(allocate(sizeof(T) * size, alignof(T)));
+    }
+
+    const char *copy_string(const char *data, std::size_t size) {
+        if (size == 0) {
+            return "";
+        }
+
+        char *result = static_cast<char *>(allocate(size, 1));
+        std::memcpy(result, data, size);
+        return result;
+    }
+
+    // Frees all the memory except the last (the largest) block, which is reused.
+    void clear() {
+        if (m_blocks) {
+            free_blocks(m_blocks->next);
+            m_blocks->next = nullptr;
+            m_position = m_blocks->data();
+        }
+    }
+
+private:
+    arena_t(const arena_t &);
+    arena_t &operator=(const arena_t &);
+
+    struct block_t {
+        block_t *next;
+        std::size_t size;
+
+        char *data() {
+            return reinterpret_cast<char *>(this + 1);
+        }
+    };
+
+    static std::size_t padding_for(const char *position, std::size_t alignment) {
+        return (alignment - reinterpret_cast<std::size_t>(position) % alignment) % alignment;
+    }
+
+    static void free_blocks(block_t *block) {
+        while (block) {
+            block_t *next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+    }
+
+    void add_block(std::size_t size) {
+        std::size_t block_size = m_blocks ? m_blocks->size * 2 : min_block_size;
+
+        if (block_size > max_block_size) {
+            block_size = max_block_size;
+        }
+
+        if (block_size < size) {
+            block_size = size;
+        }
+
+        block_t *block = static_cast<block_t *>(::operator new(sizeof(block_t) + block_size));
+        block->next = m_blocks;
+        block->size = block_size;
+
+        m_blocks = block;
+        m_position = block->data();
+        m_end = m_position + block_size;
+    }
+
+    block_t *m_blocks;
+    char *m_position;
+    char *m_end;
+};
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_ARENA_HPP
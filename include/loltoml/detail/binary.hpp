@@ -0,0 +1,55 @@
+#ifndef LOLTOML_DETAIL_BINARY_HPP
+#define LOLTOML_DETAIL_BINARY_HPP
+
+#include "loltoml/detail/common.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Little-endian integers of binary formats (section index, snapshots).
+// Compilers turn the loops into plain loads and stores on little-endian platforms.
+
+inline void write_uint(std::string &output, std::uint64_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        output.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+inline void store_uint(char *data, std::uint64_t value, std::size_t bytes) {
+    for (std::size_t i = 0; i < bytes; ++i) {
+        data[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+inline std::uint64_t load_uint(const char *data, std::size_t bytes) {
+    std::uint64_t value = 0;
+
+    for (std::size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+
+    return value;
+}
+
+inline bool read_uint(const char *&it, const char *end, std::size_t bytes, std::uint64_t &value) {
+    if (static_cast<std::size_t>(end - it) < bytes) {
+        return false;
+    }
+
+    value = load_uint(it, bytes);
+    it += bytes;
+    return true;
+}
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_BINARY_HPP
@@ -0,0 +1,81 @@
+#ifndef LOLTOML_DETAIL_FOR_EACH_HPP
+#define LOLTOML_DETAIL_FOR_EACH_HPP
+
+// LOLTOML_DETAIL_FOR_EACH(m, a, b, c) expands to m(a) m(b) m(c).
+
+#define LOLTOML_DETAIL_CONCAT(a, b) LOLTOML_DETAIL_CONCAT_IMPL(a, b)
+#define LOLTOML_DETAIL_CONCAT_IMPL(a, b) a##b
+
+// Number of arguments (1 to 64). The trailing 0 keeps "..." of the implementation non-empty.
+#define LOLTOML_DETAIL_NARGS(...) \
+    LOLTOML_DETAIL_NARGS_IMPL(__VA_ARGS__, 64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOLTOML_DETAIL_NARGS_IMPL(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, _33, _34, _35, _36, _37, _38, _39, _40, _41, _42, _43, _44, _45, _46, _47, _48, _49, _50, _51, _52, _53, _54, _55, _56, _57, _58, _59, _60, _61, _62, _63, _64, n, ...) n
+
+#define LOLTOML_DETAIL_FOR_EACH(m, ...) \
+    LOLTOML_DETAIL_CONCAT(LOLTOML_DETAIL_FOR_EACH_, LOLTOML_DETAIL_NARGS(__VA_ARGS__))(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_1(m, x) m(x)
+#define LOLTOML_DETAIL_FOR_EACH_2(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_1(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_3(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_2(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_4(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_3(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_5(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_4(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_6(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_5(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_7(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_6(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_8(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_7(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_9(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_8(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_10(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_9(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_11(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_10(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_12(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_11(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_13(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_12(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_14(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_13(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_15(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_14(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_16(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_15(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_17(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_16(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_18(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_17(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_19(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_18(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_20(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_19(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_21(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_20(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_22(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_21(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_23(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_22(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_24(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_23(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_25(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_24(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_26(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_25(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_27(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_26(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_28(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_27(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_29(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_28(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_30(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_29(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_31(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_30(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_32(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_31(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_33(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_32(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_34(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_33(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_35(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_34(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_36(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_35(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_37(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_36(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_38(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_37(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_39(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_38(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_40(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_39(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_41(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_40(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_42(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_41(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_43(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_42(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_44(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_43(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_45(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_44(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_46(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_45(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_47(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_46(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_48(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_47(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_49(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_48(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_50(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_49(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_51(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_50(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_52(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_51(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_53(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_52(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_54(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_53(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_55(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_54(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_56(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_55(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_57(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_56(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_58(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_57(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_59(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_58(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_60(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_59(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_61(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_60(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_62(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_61(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_63(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_62(m, __VA_ARGS__)
+#define LOLTOML_DETAIL_FOR_EACH_64(m, x, ...) m(x) LOLTOML_DETAIL_FOR_EACH_63(m, __VA_ARGS__)
+
+#endif // LOLTOML_DETAIL_FOR_EACH_HPP
@@ -0,0 +1,123 @@
+#ifndef LOLTOML_DETAIL_HANDLER_TRAITS_HPP
+#define LOLTOML_DETAIL_HANDLER_TRAITS_HPP
+
+#include "loltoml/action.hpp"
+#include "loltoml/datetime.hpp"
+#include "loltoml/detail/common.hpp"
+#include "loltoml/string_view.hpp"
+#include "loltoml/symbol_table.hpp"
+
+#include <type_traits>
+#include <utility>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Detects which optional parts of the handler protocol the handler implements.
+template<class Handler>
+class handler_traits_t {
+    template<class H>
+    static auto test_key_view(int) -> decltype(std::declval<H &>().key(std::declval<string_view_t>()), std::true_type());
+
+    template<class H>
+    static std::false_type test_key_view(...);
+
+    template<class H>
+    static auto test_string_view(int) -> decltype(std::declval<H &>().string(std::declval<string_view_t>()), std::true_type());
+
+    template<class H>
+    static std::false_type test_string_view(...);
+
+    template<class H>
+    static auto test_comment_view(int) -> decltype(std::declval<H &>().comment(std::declval<string_view_t>()), std::true_type());
+
+    template<class H>
+    static std::false_type test_comment_view(...);
+
+    template<class H>
+    static auto test_datetime_view(int) -> decltype(std::declval<H &>().datetime(std::declval<string_view_t>()), std::true_type());
+
+    template<class H>
+    static std::false_type test_datetime_view(...);
+
+    template<class H>
+    static auto test_datetime_fields(int) -> decltype(std::declval<H &>().datetime(std::declval<const datetime_t &>()),
+                                                      std::true_type());
+
+    template<class H>
+    static std::false_type test_datetime_fields(...);
+
+    template<class H>
+    static auto test_key_symbol(int) -> decltype(std::declval<H &>().key(std::declval<const symbol_t &>()), std::true_type());
+
+    template<class H>
+    static std::false_type test_key_symbol(...);
+
+    template<class H>
+    static auto test_table_symbols(int) -> decltype(std::declval<H &>().table(std::declval<symbol_iterator_t>(),
+                                                                              std::declval<symbol_iterator_t>()),
+                                                    std::true_type());
+
+    template<class H>
+    static std::false_type test_table_symbols(...);
+
+    template<class H>
+    static auto test_array_table_symbols(int) -> decltype(std::declval<H &>().array_table(std::declval<symbol_iterator_t>(),
+                                                                                          std::declval<symbol_iterator_t>()),
+                                                          std::true_type());
+
+    template<class H>
+    static std::false_type test_array_table_symbols(...);
+
+public:
+    // std::true_type if the handler accepts loltoml::string_view_t in the corresponding method.
+    typedef decltype(test_key_view<Handler>(0)) view_key_t;
+    typedef decltype(test_string_view<Handler>(0)) view_string_t;
+    typedef decltype(test_comment_view<Handler>(0)) view_comment_t;
+    typedef decltype(test_datetime_view<Handler>(0)) view_datetime_t;
+
+    // std::true_type if the handler accepts loltoml::datetime_t in datetime().
+    typedef decltype(test_datetime_fields<Handler>(0)) structured_datetime_t;
+
+    // std::true_type if the handler accepts loltoml::symbol_t (or loltoml::symbol_iterator_t for table paths).
+    typedef decltype(test_key_symbol<Handler>(0)) symbol_key_t;
+    typedef decltype(test_table_symbols<Handler>(0)) symbol_table_path_t;
+    typedef decltype(test_array_table_symbols<Handler>(0)) symbol_array_table_path_t;
+};
+
+
+// Calls the function returning either loltoml::action_t or anything else, which means action_t::proceed.
+template<class Function>
+action_t invoke_for_action(Function function, std::true_type) {
+    return function();
+}
+
+template<class Function>
+action_t invoke_for_action(Function function, std::false_type) {
+    function();
+    return action_t::proceed;
+}
+
+template<class Function>
+action_t invoke_for_action(Function function) {
+    return invoke_for_action(function, std::is_same<decltype(function()), action_t>());
+}
+
+
+// Text of a key of a table path, which handlers may receive as strings or symbols.
+inline string_view_t path_key_text(string_view_t key) {
+    return key;
+}
+
+inline string_view_t path_key_text(const symbol_t &key) {
+    return key.text;
+}
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_HANDLER_TRAITS_HPP
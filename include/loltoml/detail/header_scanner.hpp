@@ -0,0 +1,250 @@
+#ifndef LOLTOML_DETAIL_HEADER_SCANNER_HPP
+#define LOLTOML_DETAIL_HEADER_SCANNER_HPP
+
+#include "loltoml/action.hpp"
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/input_buffer.hpp"
+#include "loltoml/detail/parser.hpp"
+#include "loltoml/detail/scan.hpp"
+#include "loltoml/error.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Characters which may change state of find_header_lines().
+inline bool is_structural(char ch) {
+    static const std::uint64_t mask[4] = {
+        (1ull << '\n') | (1ull << '#') | (1ull << '"') | (1ull << '\''),
+        (1ull << ('[' - 64)) | (1ull << (']' - 64)) | (1ull << ('{' - 64)) | (1ull << ('}' - 64)),
+        0,
+        0
+    };
+
+    unsigned char index = static_cast<unsigned char>(ch);
+    return (mask[index >> 6] >> (index & 63)) & 1;
+}
+
+inline bool starts_with_triple(const char *it, const char *end, char quote) {
+    return end - it >= 3 && it[0] == quote && it[1] == quote && it[2] == quote;
+}
+
+// Finds lines starting with top-level table headers and returns their offsets, skipping headers closer than
+// min_distance bytes to the previous one. Strings, comments and arrays are skipped, so '[' at the start of a line
+// inside a multiline string or array isn't taken for a header.
+// The result is exact for valid documents. For invalid ones it may be anything, but then parsing of some chunk fails.
+inline void find_header_lines(const char *data,
+                              std::size_t size,
+                              std::size_t min_distance,
+                              std::vector<std::size_t> &result)
+{
+    const char *end = data + size;
+    const char *last = data;
+    const char *it = data;
+    bool line_start = true;
+    std::size_t depth = 0;
+
+    while (it < end) {
+        if (line_start) {
+            const char *line = it;
+            line_start = false;
+
+            while (it < end && (*it == ' ' || *it == '\t')) {
+                ++it;
+            }
+
+            if (it == end) {
+                break;
+            }
+
+            if (*it == '[' && depth == 0 && line != data && static_cast<std::size_t>(line - last) >= min_distance) {
+                result.push_back(line - data);
+                last = line;
+            }
+        }
+
+        switch (*it) {
+            case '\n': {
+                ++it;
+                line_start = true;
+            } continue; // Spaces at the start of the line must not be skipped below.
+            case '#': {
+                it = scan_comment(it + 1, end);
+            } break;
+            case '[':
+            case '{': {
+                ++depth;
+                ++it;
+            } break;
+            case ']':
+            case '}': {
+                if (depth > 0) {
+                    --depth;
+                }
+
+                ++it;
+            } break;
+            case '"': {
+                if (starts_with_triple(it, end, '"')) {
+                    it += 3;
+
+                    while (it < end) {
+                        it = scan_multiline_string(it, end);
+
+                        if (it == end) {
+                            break;
+                        } else if (*it == '\\') {
+                            it = std::min(it + 2, end);
+                        } else if (starts_with_triple(it, end, '"')) {
+                            it += 3;
+                            break;
+                        } else {
+                            ++it;
+                        }
+                    }
+                } else {
+                    // Single-line strings are usually short, so a plain loop is faster than SIMD here.
+                    // Stop at a new-line in an invalid string too.
+                    for (++it; it < end && *it != '"' && *it != '\n'; ++it) {
+                        if (*it == '\\' && it + 1 < end) {
+                            ++it;
+                        }
+                    }
+
+                    if (it < end && *it == '"') {
+                        ++it;
+                    }
+                }
+            } break;
+            case '\'': {
+                if (starts_with_triple(it, end, '\'')) {
+                    it += 3;
+
+                    while (it < end) {
+                        it = scan_multiline_literal_string(it, end);
+
+                        if (it == end) {
+                            break;
+                        } else if (starts_with_triple(it, end, '\'')) {
+                            it += 3;
+                            break;
+                        } else {
+                            ++it;
+                        }
+                    }
+                } else {
+                    for (++it; it < end && *it != '\'' && *it != '\n'; ++it) { }
+
+                    if (it < end && *it == '\'') {
+                        ++it;
+                    }
+                }
+            } break;
+            default: {
+                ++it;
+            } break;
+        }
+
+        while (it < end && !is_structural(*it)) {
+            ++it;
+        }
+    }
+}
+
+
+// Finds lines starting with all the top-level table headers including the one on the first line,
+// which find_header_lines() doesn't report.
+inline void find_all_header_lines(const char *data, std::size_t size, std::vector<std::size_t> &result) {
+    std::size_t first = 0;
+    while (first < size && (data[first] == ' ' || data[first] == '\t')) {
+        ++first;
+    }
+
+    if (first < size && data[first] == '[') {
+        result.push_back(0);
+    }
+
+    find_header_lines(data, size, 0, result);
+}
+
+
+// Handler reading just the first table header of the input. The keys are kept between runs to reuse their memory.
+class header_reader_t {
+public:
+    header_reader_t() :
+        m_array_table(false)
+    { }
+
+    const std::vector<std::string> &path() const {
+        return m_path;
+    }
+
+    // The header is an [[array table]] header.
+    bool array_table() const {
+        return m_array_table;
+    }
+
+    void start_document() { }
+    void finish_document() { }
+    void comment(string_view_t) { }
+
+    action_t table(key_iterator_t begin, key_iterator_t end) {
+        m_path.assign(begin, end);
+        m_array_table = false;
+        return action_t::stop;
+    }
+
+    action_t array_table(key_iterator_t begin, key_iterator_t end) {
+        m_path.assign(begin, end);
+        m_array_table = true;
+        return action_t::stop;
+    }
+
+    // The input starts with a header, so the rest is never called.
+    action_t key(string_view_t) { return action_t::stop; }
+    void start_array() { }
+    void finish_array(std::size_t) { }
+    void start_inline_table() { }
+    void finish_inline_table(std::size_t) { }
+    void boolean(bool) { }
+    void string(string_view_t) { }
+    void datetime(string_view_t) { }
+    void integer(std::int64_t) { }
+    void floating_point(double) { }
+
+private:
+    std::vector<std::string> m_path;
+    bool m_array_table;
+};
+
+
+// Parses [begin, end) of the document reporting errors at offsets from the start of the document.
+template<class Handler>
+inline bool parse_range(const char *data,
+                        std::size_t begin,
+                        std::size_t end,
+                        Handler &handler,
+                        parser_buffers_t &buffers)
+{
+    input_buffer_t input(data + begin, end - begin);
+
+    try {
+        return parser_t<input_buffer_t, Handler>(input, handler, buffers).parse();
+    } catch (const parser_error_t &error) {
+        throw parser_error_t(error, begin + error.offset());
+    }
+}
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_HEADER_SCANNER_HPP
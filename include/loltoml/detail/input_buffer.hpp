@@ -0,0 +1,117 @@
+#ifndef LOLTOML_DETAIL_INPUT_BUFFER_HPP
+#define LOLTOML_DETAIL_INPUT_BUFFER_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/error.hpp"
+
+#include <cstddef>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Input source reading from a contiguous chunk of memory.
+// It mimics behavior of input_stream_t exactly, so the parser produces the same events and errors with both.
+// The end of the input is followed by a single '\n'. Reading past it doesn't throw: the first such read is remembered
+// as the error and peek() and get() return '\0' from then on, so the parser must check failed() in loops
+// which don't stop at control characters.
+class input_buffer_t {
+public:
+    // The parser may access the data directly through position(), end() and skip().
+    static const bool is_contiguous = true;
+
+    input_buffer_t(const char *data, std::size_t size) :
+        m_begin(data),
+        m_position(data),
+        m_end(data + size),
+        m_eof(false),
+        m_emit_eol(true),
+        m_failed(false),
+        m_error_offset(0)
+    { }
+
+    char peek() {
+        if (m_position != m_end) {
+            return *m_position;
+        } else {
+            m_eof = true;
+
+            if (m_emit_eol) {
+                return '\n';
+            } else {
+                return overrun();
+            }
+        }
+    }
+
+    char get() {
+        if (m_position != m_end) {
+            return *m_position++;
+        } else {
+            m_eof = true;
+
+            if (m_emit_eol) {
+                m_emit_eol = false;
+                return '\n';
+            } else {
+                return overrun();
+            }
+        }
+    }
+
+    bool eof() const {
+        return m_eof;
+    }
+
+    // Something has been read past the end of the input.
+    bool failed() const {
+        return m_failed;
+    }
+
+    parser_error_t error() const {
+        return parser_error_t(error_code_t::unexpected_eof, "Unexpected EOF", m_error_offset);
+    }
+
+    std::size_t processed() const {
+        return static_cast<std::size_t>(m_position - m_begin);
+    }
+
+    const char *position() const {
+        return m_position;
+    }
+
+    const char *end() const {
+        return m_end;
+    }
+
+    // Consumes n characters. They must be available, i.e. n <= end() - position().
+    void skip(std::size_t n) {
+        m_position += n;
+    }
+
+private:
+    char overrun() {
+        if (!m_failed) {
+            m_failed = true;
+            m_error_offset = processed();
+        }
+
+        return '\0';
+    }
+
+    const char *m_begin;
+    const char *m_position;
+    const char *m_end;
+    bool m_eof;
+    bool m_emit_eol;
+    bool m_failed;
+    std::size_t m_error_offset;
+};
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_INPUT_BUFFER_HPP
@@ -12,12 +12,18 @@ LOLTOML_OPEN_NAMESPACE
 namespace detail {
 
 
+// Input source reading from a stream. Like input_buffer_t, it doesn't throw on errors: the first read past the end
+// or failure of the stream is remembered as the error and then peek() and get() return '\0'.
 class input_stream_t {
 public:
+    static const bool is_contiguous = false;
+
     explicit input_stream_t(std::istream &input) :
         m_backend(input),
         m_processed(0),
-        m_emit_eol(true)
+        m_emit_eol(true),
+        m_error(error_code_t::none),
+        m_error_offset(0)
     { }
 
     char peek() {
@@ -26,12 +32,12 @@ public:
         if (ch != std::char_traits<char>::eof()) {
             return ch;
         } else if (m_backend.bad()) {
-            throw stream_error_t(processed());
+            return fail(error_code_t::stream_error);
         } else {
             if (m_emit_eol) {
                 return '\n';
             } else {
-                throw parser_error_t("Unexpected EOF", processed());
+                return fail(error_code_t::unexpected_eof);
             }
         }
     }
@@ -43,13 +49,13 @@ public:
             ++m_processed;
             return result;
         } else if (m_backend.bad()) {
-            throw stream_error_t(processed());
+            return fail(error_code_t::stream_error);
         } else {
             if (m_emit_eol) {
                 m_emit_eol = false;
                 return '\n';
             } else {
-                throw parser_error_t("Unexpected EOF", processed());
+                return fail(error_code_t::unexpected_eof);
             }
         }
     }
@@ -62,10 +68,33 @@ public:
         return m_processed;
     }
 
+    bool failed() const {
+        return m_error != error_code_t::none;
+    }
+
+    parser_error_t error() const {
+        if (m_error == error_code_t::stream_error) {
+            return stream_error_t(m_error_offset);
+        }
+
+        return parser_error_t(error_code_t::unexpected_eof, "Unexpected EOF", m_error_offset);
+    }
+
 private:
+    char fail(error_code_t error) {
+        if (m_error == error_code_t::none) {
+            m_error = error;
+            m_error_offset = processed();
+        }
+
+        return '\0';
+    }
+
     std::istream &m_backend;
     std::size_t m_processed;
     bool m_emit_eol;
+    error_code_t m_error;
+    std::size_t m_error_offset;
 };
 
 
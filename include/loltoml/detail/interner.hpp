@@ -0,0 +1,155 @@
+#ifndef LOLTOML_DETAIL_INTERNER_HPP
+#define LOLTOML_DETAIL_INTERNER_HPP
+
+#include "loltoml/detail/arena.hpp"
+#include "loltoml/detail/common.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <cstdint>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// FNV-1a.
+inline std::uint32_t hash_string(string_view_t string) {
+    std::uint32_t hash = 2166136261u;
+
+    for (auto it = string.begin(); it != string.end(); ++it) {
+        hash ^= static_cast<unsigned char>(*it);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+inline std::uint32_t hash_combine(std::uint32_t first, std::uint32_t second) {
+    std::uint64_t hash = (static_cast<std::uint64_t>(first) << 32) | second;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return static_cast<std::uint32_t>(hash);
+}
+
+
+// Maps strings to consecutive integer ids. Open addressing with linear probing.
+// Interned strings are stored in an arena, so views returned by get() stay valid until clear().
+class string_interner_t {
+public:
+    enum : std::uint32_t {
+        npos = 0xffffffffu
+    };
+
+    string_interner_t() :
+        m_slots(16)
+    { }
+
+    std::size_t size() const {
+        return m_strings.size();
+    }
+
+    // Returns id of the string or npos.
+    std::uint32_t find(string_view_t string) const {
+        return find(string, hash_string(string));
+    }
+
+    std::uint32_t find(string_view_t string, std::uint32_t hash) const {
+        const std::size_t mask = m_slots.size() - 1;
+
+        for (std::size_t i = hash & mask; ; i = (i + 1) & mask) {
+            const slot_t &slot = m_slots[i];
+
+            if (slot.id == npos) {
+                return npos;
+            } else if (slot.hash == hash && m_strings[slot.id] == string) {
+                return slot.id;
+            }
+        }
+    }
+
+    // Returns id of the string adding it if needed.
+    std::uint32_t intern(string_view_t string) {
+        return intern(string, hash_string(string));
+    }
+
+    std::uint32_t intern(string_view_t string, std::uint32_t hash) {
+        const std::size_t mask = m_slots.size() - 1;
+
+        for (std::size_t i = hash & mask; ; i = (i + 1) & mask) {
+            slot_t &slot = m_slots[i];
+
+            if (slot.id == npos) {
+                std::uint32_t id = static_cast<std::uint32_t>(m_strings.size());
+                m_strings.push_back(string_view_t(m_storage.copy_string(string.data(), string.size()), string.size()));
+                slot.id = id;
+                slot.hash = hash;
+
+                // Keep load factor under 1/2.
+                if (2 * m_strings.size() > m_slots.size()) {
+                    rehash(2 * m_slots.size());
+                }
+
+                return id;
+            } else if (slot.hash == hash && m_strings[slot.id] == string) {
+                return slot.id;
+            }
+        }
+    }
+
+    string_view_t get(std::uint32_t id) const {
+        return m_strings[id];
+    }
+
+    // Forgets all the strings but keeps the memory.
+    void clear() {
+        m_storage.clear();
+        m_strings.clear();
+
+        for (auto it = m_slots.begin(); it != m_slots.end(); ++it) {
+            it->id = npos;
+        }
+    }
+
+private:
+    struct slot_t {
+        std::uint32_t id;
+        std::uint32_t hash;
+
+        slot_t() :
+            id(npos),
+            hash(0)
+        { }
+    };
+
+    void rehash(std::size_t size) {
+        std::vector<slot_t> slots(size);
+        const std::size_t mask = size - 1;
+
+        for (auto it = m_slots.begin(); it != m_slots.end(); ++it) {
+            if (it->id != npos) {
+                std::size_t i = it->hash & mask;
+
+                while (slots[i].id != npos) {
+                    i = (i + 1) & mask;
+                }
+
+                slots[i] = *it;
+            }
+        }
+
+        m_slots.swap(slots);
+    }
+
+    std::vector<slot_t> m_slots;
+    std::vector<string_view_t> m_strings;
+    arena_t m_storage;
+};
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_INTERNER_HPP
@@ -0,0 +1,272 @@
+#ifndef LOLTOML_DETAIL_KEY_VALIDATOR_HPP
+#define LOLTOML_DETAIL_KEY_VALIDATOR_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/interner.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Tracks defined keys and tables to detect redefinitions.
+//
+// Every table, array of tables item and value with a key is a node identified by an integer.
+// A node is found by the pair (id of the parent node, id of the interned key) in an open addressing hash table,
+// so each key in the document costs O(1) on average regardless of the depth and the size of the tables.
+//
+// Methods return nullptr if the event is valid and an error message otherwise.
+class key_validator_t {
+public:
+    key_validator_t() :
+        m_edges(16),
+        m_edges_count(0),
+        m_pending(npos)
+    {
+        reset();
+    }
+
+    // Forgets everything but keeps the memory.
+    void reset() {
+        m_keys.clear();
+
+        for (auto it = m_edges.begin(); it != m_edges.end(); ++it) {
+            it->child = npos;
+        }
+
+        m_edges_count = 0;
+        m_nodes.assign(1, node_t(implicit_table));
+        m_scopes.assign(1, root);
+        m_pending = npos;
+    }
+
+    template<class Iterator>
+    const char *table(Iterator begin, Iterator end) {
+        assert(begin != end);
+
+        std::uint32_t parent = root;
+        const char *error = walk(begin, end - 1, parent);
+
+        if (error) {
+            return error;
+        }
+
+        std::uint32_t key = m_keys.intern(*(end - 1));
+        std::uint32_t node = find_child(parent, key);
+
+        if (node == npos) {
+            node = add_child(parent, key, defined_table);
+        } else if (m_nodes[node].kind == implicit_table) {
+            m_nodes[node].kind = defined_table;
+        } else {
+            return "Table is already defined";
+        }
+
+        m_scopes.assign(1, node);
+        return nullptr;
+    }
+
+    template<class Iterator>
+    const char *array_table(Iterator begin, Iterator end) {
+        assert(begin != end);
+
+        std::uint32_t parent = root;
+        const char *error = walk(begin, end - 1, parent);
+
+        if (error) {
+            return error;
+        }
+
+        std::uint32_t key = m_keys.intern(*(end - 1));
+        std::uint32_t node = find_child(parent, key);
+
+        if (node == npos) {
+            node = add_child(parent, key, array_of_tables);
+        } else if (m_nodes[node].kind != array_of_tables) {
+            return "Table is already defined";
+        }
+
+        // Each item of the array is a new anonymous table.
+        std::uint32_t item = add_node(defined_table);
+        m_nodes[node].last_item = item;
+
+        m_scopes.assign(1, item);
+        return nullptr;
+    }
+
+    const char *key(string_view_t key) {
+        assert(m_scopes.back() != array_scope);
+
+        std::uint32_t parent = m_scopes.back();
+        std::uint32_t key_id = m_keys.intern(key);
+
+        if (find_child(parent, key_id) != npos) {
+            return "Duplicate key";
+        }
+
+        m_pending = add_child(parent, key_id, value);
+        return nullptr;
+    }
+
+    void start_array() {
+        m_scopes.push_back(array_scope);
+    }
+
+    void finish_array() {
+        m_scopes.pop_back();
+    }
+
+    void start_inline_table() {
+        if (m_scopes.back() == array_scope) {
+            // Tables inside arrays don't have keys, so their keys cannot be redefined from outside.
+            m_scopes.push_back(add_node(value));
+        } else {
+            assert(m_pending != npos);
+            m_scopes.push_back(m_pending);
+        }
+    }
+
+    void finish_inline_table() {
+        m_scopes.pop_back();
+    }
+
+private:
+    enum : std::uint32_t {
+        npos = 0xffffffffu,
+        root = 0,
+        // Marks arrays in m_scopes.
+        array_scope = 0xfffffffeu
+    };
+
+    enum kind_t {
+        // Table created implicitly by a header of its child table.
+        implicit_table,
+        // Table defined by a [table] header or an item of an array of tables.
+        defined_table,
+        // Array created by [[array table]] headers.
+        array_of_tables,
+        // Value assigned by a key, including inline tables and static arrays. It cannot be extended by headers.
+        value
+    };
+
+    struct node_t {
+        unsigned char kind;
+        // Last item of an array of tables.
+        std::uint32_t last_item;
+
+        explicit node_t(unsigned char kind) :
+            kind(kind),
+            last_item(npos)
+        { }
+    };
+
+    struct edge_t {
+        std::uint32_t parent;
+        std::uint32_t key;
+        std::uint32_t child;
+    };
+
+    template<class Iterator>
+    const char *walk(Iterator begin, Iterator end, std::uint32_t &current) {
+        for (; begin != end; ++begin) {
+            std::uint32_t key = m_keys.intern(*begin);
+            std::uint32_t node = find_child(current, key);
+
+            if (node == npos) {
+                node = add_child(current, key, implicit_table);
+            } else if (m_nodes[node].kind == array_of_tables) {
+                node = m_nodes[node].last_item;
+            } else if (m_nodes[node].kind == value) {
+                return "Key is already defined as a value";
+            }
+
+            current = node;
+        }
+
+        return nullptr;
+    }
+
+    std::uint32_t add_node(unsigned char kind) {
+        m_nodes.push_back(node_t(kind));
+        return static_cast<std::uint32_t>(m_nodes.size() - 1);
+    }
+
+    std::uint32_t find_child(std::uint32_t parent, std::uint32_t key) const {
+        const std::size_t mask = m_edges.size() - 1;
+
+        for (std::size_t i = hash_combine(parent, key) & mask; ; i = (i + 1) & mask) {
+            const edge_t &edge = m_edges[i];
+
+            if (edge.child == npos) {
+                return npos;
+            } else if (edge.parent == parent && edge.key == key) {
+                return edge.child;
+            }
+        }
+    }
+
+    // The child must not exist.
+    std::uint32_t add_child(std::uint32_t parent, std::uint32_t key, unsigned char kind) {
+        std::uint32_t child = add_node(kind);
+        insert_edge(m_edges, parent, key, child);
+        ++m_edges_count;
+
+        // Keep load factor under 1/2.
+        if (2 * m_edges_count > m_edges.size()) {
+            std::vector<edge_t> edges(2 * m_edges.size());
+
+            for (auto it = edges.begin(); it != edges.end(); ++it) {
+                it->child = npos;
+            }
+
+            for (auto it = m_edges.begin(); it != m_edges.end(); ++it) {
+                if (it->child != npos) {
+                    insert_edge(edges, it->parent, it->key, it->child);
+                }
+            }
+
+            m_edges.swap(edges);
+        }
+
+        return child;
+    }
+
+    static void insert_edge(std::vector<edge_t> &edges,
+                            std::uint32_t parent,
+                            std::uint32_t key,
+                            std::uint32_t child)
+    {
+        const std::size_t mask = edges.size() - 1;
+        std::size_t i = hash_combine(parent, key) & mask;
+
+        while (edges[i].child != npos) {
+            i = (i + 1) & mask;
+        }
+
+        edges[i].parent = parent;
+        edges[i].key = key;
+        edges[i].child = child;
+    }
+
+    string_interner_t m_keys;
+    std::vector<edge_t> m_edges;
+    std::size_t m_edges_count;
+    std::vector<node_t> m_nodes;
+    // Current table followed by inline tables and arrays the parser is inside of.
+    std::vector<std::uint32_t> m_scopes;
+    // Node of the last key.
+    std::uint32_t m_pending;
+};
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_KEY_VALIDATOR_HPP
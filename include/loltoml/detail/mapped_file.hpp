@@ -0,0 +1,140 @@
+#ifndef LOLTOML_DETAIL_MAPPED_FILE_HPP
+#define LOLTOML_DETAIL_MAPPED_FILE_HPP
+
+#include "loltoml/detail/common.hpp"
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Read-only view of a whole file.
+// Regular files are mapped into memory. Files which cannot be mapped (pipes, procfs and such) are read into a buffer.
+class mapped_file_t {
+public:
+    explicit mapped_file_t(const char *path) :
+        m_descriptor(-1),
+        m_mapping(nullptr),
+        m_data(nullptr),
+        m_size(0)
+    {
+        do {
+            m_descriptor = ::open(path, O_RDONLY | O_CLOEXEC);
+        } while (m_descriptor == -1 && errno == EINTR);
+
+        if (m_descriptor == -1) {
+            throw_system_error(errno, "Unable to open ", path);
+        }
+
+        try {
+            struct stat info;
+            if (::fstat(m_descriptor, &info) == -1) {
+                throw_system_error(errno, "Unable to stat ", path);
+            }
+
+            // Files in procfs and the like report zero size, so they're read as well.
+            if (S_ISREG(info.st_mode) && info.st_size > 0) {
+                m_size = static_cast<std::size_t>(info.st_size);
+                void *mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_descriptor, 0);
+
+                if (mapping != MAP_FAILED) {
+                    ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+                    m_mapping = mapping;
+                    m_data = static_cast<const char *>(mapping);
+                    return;
+                }
+
+                m_size = 0;
+            }
+
+            read_all(path);
+        } catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    ~mapped_file_t() {
+        close();
+    }
+
+    const char *data() const {
+        return m_data;
+    }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+private:
+    mapped_file_t(const mapped_file_t &);
+    mapped_file_t &operator=(const mapped_file_t &);
+
+    // The error code is passed by value so that errno is read before the message is built.
+    static void throw_system_error(int error, const char *what, const char *path) {
+        throw std::system_error(error, std::system_category(), std::string(what) + path);
+    }
+
+    void read_all(const char *path) {
+        const std::size_t chunk_size = 64 * 1024;
+
+        while (true) {
+            m_buffer.resize(m_buffer.size() + chunk_size);
+            ssize_t result = ::read(m_descriptor, &m_buffer[m_buffer.size() - chunk_size], chunk_size);
+
+            if (result < 0) {
+                int error = errno;
+                m_buffer.resize(m_buffer.size() - chunk_size);
+
+                if (error == EINTR) {
+                    continue;
+                }
+
+                throw_system_error(error, "Unable to read ", path);
+            }
+
+            m_buffer.resize(m_buffer.size() - chunk_size + static_cast<std::size_t>(result));
+
+            if (result == 0) {
+                break;
+            }
+        }
+
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+    }
+
+    void close() {
+        if (m_mapping) {
+            ::munmap(m_mapping, m_size);
+            m_mapping = nullptr;
+        }
+
+        if (m_descriptor != -1) {
+            ::close(m_descriptor);
+            m_descriptor = -1;
+        }
+    }
+
+    int m_descriptor;
+    void *m_mapping;
+    std::string m_buffer;
+    const char *m_data;
+    std::size_t m_size;
+};
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_MAPPED_FILE_HPP
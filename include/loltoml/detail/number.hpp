@@ -0,0 +1,675 @@
+#ifndef LOLTOML_DETAIL_NUMBER_HPP
+#define LOLTOML_DETAIL_NUMBER_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/power_of_five.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Loads 8 chars so that the first one is in the lowest byte regardless of the byte order.
+// Compilers turn it into a single load on little-endian machines.
+inline std::uint64_t load_eight_chars(const char *data) {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+
+    return static_cast<std::uint64_t>(bytes[0]) |
+           (static_cast<std::uint64_t>(bytes[1]) << 8) |
+           (static_cast<std::uint64_t>(bytes[2]) << 16) |
+           (static_cast<std::uint64_t>(bytes[3]) << 24) |
+           (static_cast<std::uint64_t>(bytes[4]) << 32) |
+           (static_cast<std::uint64_t>(bytes[5]) << 40) |
+           (static_cast<std::uint64_t>(bytes[6]) << 48) |
+           (static_cast<std::uint64_t>(bytes[7]) << 56);
+}
+
+// SWAR check that all 8 chars loaded by load_eight_chars() are in '0'...'9'.
+// The high nibble of each byte must be 3, and adding 6 to the low nibble must not carry.
+inline bool is_eight_digits(std::uint64_t chars) {
+    return ((chars & 0xF0F0F0F0F0F0F0F0ull) |
+            (((chars + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+// Value of 8 digits loaded by load_eight_chars(). Pairs of digits are combined into 2-digit numbers,
+// then pairs of those into 4-digit numbers and finally into the result, each step with one multiplication.
+inline std::uint32_t parse_eight_digits(std::uint64_t chars) {
+    chars = (chars & 0x0F0F0F0F0F0F0F0Full) * 2561 >> 8;
+    chars = (chars & 0x00FF00FF00FF00FFull) * 6553601 >> 16;
+    return static_cast<std::uint32_t>((chars & 0x0000FFFF0000FFFFull) * 42949672960001ull >> 32);
+}
+
+
+// Decoding of floating point numbers.
+//
+// A number is split into a decimal mantissa of at most 19 significant digits and a decimal exponent.
+// Small exact mantissas multiplied by small powers of ten are computed directly (Clinger's fast path),
+// the rest go through the Eisel-Lemire algorithm, which multiplies the mantissa by a 128-bit approximation
+// of the power of five. In the rare cases when it can't decide how to round the result
+// (the mantissa was truncated or the approximation is too close to the half-way point),
+// the number is converted exactly with big decimal arithmetic.
+// Unlike strtod(), none of it depends on the current locale.
+
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+struct uint128_parts_t {
+    std::uint64_t low;
+    std::uint64_t high;
+};
+
+inline uint128_parts_t full_multiplication(std::uint64_t left, std::uint64_t right) {
+    uint128_parts_t result;
+
+#if defined(__SIZEOF_INT128__)
+    uint128_t product = static_cast<uint128_t>(left) * right;
+    result.low = static_cast<std::uint64_t>(product);
+    result.high = static_cast<std::uint64_t>(product >> 64);
+#else
+    std::uint64_t left_low = left & 0xFFFFFFFFu;
+    std::uint64_t left_high = left >> 32;
+    std::uint64_t right_low = right & 0xFFFFFFFFu;
+    std::uint64_t right_high = right >> 32;
+
+    std::uint64_t low_low = left_low * right_low;
+    std::uint64_t high_low = left_high * right_low;
+    std::uint64_t low_high = left_low * right_high;
+    std::uint64_t high_high = left_high * right_high;
+
+    std::uint64_t middle = (low_low >> 32) + (high_low & 0xFFFFFFFFu) + (low_high & 0xFFFFFFFFu);
+
+    result.low = (middle << 32) | (low_low & 0xFFFFFFFFu);
+    result.high = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+#endif
+
+    return result;
+}
+
+inline int leading_zeros(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(value);
+#else
+    int result = 0;
+
+    while (!(value & 0x8000000000000000ull)) {
+        value <<= 1;
+        ++result;
+    }
+
+    return result;
+#endif
+}
+
+inline double make_double(std::uint64_t mantissa, int biased_exponent, bool negative) {
+    std::uint64_t bits = mantissa | (static_cast<std::uint64_t>(biased_exponent) << 52);
+
+    if (negative) {
+        bits |= 0x8000000000000000ull;
+    }
+
+    double result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// Decimal number split into at most 19 significant digits and an exponent.
+struct decimal_split_t {
+    std::uint64_t mantissa;
+    std::int64_t exponent;
+    // Non-zero digits were dropped from the mantissa, so the number is a bit greater than mantissa * 10^exponent.
+    bool truncated;
+};
+
+enum : std::size_t {
+    max_mantissa_digits = 19
+};
+
+// The number must be well-formed: digits, optionally followed by '.' and digits,
+// optionally followed by 'e' or 'E', a sign and digits.
+inline decimal_split_t split_decimal(const char *begin, const char *end) {
+    // Exponents above this limit make any non-zero number overflow anyway.
+    const std::int64_t max_exponent = 100000000;
+
+    decimal_split_t result = {0, 0, false};
+    std::size_t mantissa_digits = 0;
+    bool fraction = false;
+
+    const char *position = begin;
+
+    while (position != end && *position != 'e' && *position != 'E') {
+        if (*position == '.') {
+            fraction = true;
+            ++position;
+            continue;
+        }
+
+        // Blocks of 8 digits are taken only after the leading zeros are skipped.
+        if (mantissa_digits > 0 &&
+            mantissa_digits + 8 <= max_mantissa_digits &&
+            end - position >= 8 &&
+            is_eight_digits(load_eight_chars(position)))
+        {
+            result.mantissa = 100000000 * result.mantissa + parse_eight_digits(load_eight_chars(position));
+            mantissa_digits += 8;
+            position += 8;
+
+            if (fraction) {
+                result.exponent -= 8;
+            }
+
+            continue;
+        }
+
+        unsigned int digit = static_cast<unsigned int>(*position - '0');
+        ++position;
+
+        if (mantissa_digits == 0 && digit == 0) {
+            if (fraction) {
+                --result.exponent;
+            }
+        } else if (mantissa_digits < max_mantissa_digits) {
+            result.mantissa = 10 * result.mantissa + digit;
+            ++mantissa_digits;
+
+            if (fraction) {
+                --result.exponent;
+            }
+        } else {
+            result.truncated = result.truncated || digit != 0;
+
+            if (!fraction) {
+                ++result.exponent;
+            }
+        }
+    }
+
+    if (position != end) {
+        ++position;
+
+        bool negative_exponent = false;
+        if (*position == '+' || *position == '-') {
+            negative_exponent = *position == '-';
+            ++position;
+        }
+
+        std::int64_t exponent = 0;
+        for (; position != end; ++position) {
+            if (exponent < max_exponent) {
+                exponent = 10 * exponent + (*position - '0');
+            }
+        }
+
+        result.exponent += negative_exponent ? -exponent : exponent;
+    }
+
+    return result;
+}
+
+// Exact conversion for the cases the fast algorithms can't decide.
+// The number is kept as a big decimal and is shifted by powers of two until it's in [0.5, 1),
+// and then its 53 most significant bits are extracted with proper rounding.
+// See "Simple Decimal Conversion" by Nigel Tao.
+class big_decimal_t {
+public:
+    enum : std::size_t {
+        max_digits = 800
+    };
+
+    enum : unsigned int {
+        max_shift = 60
+    };
+
+    big_decimal_t(const char *begin, const char *end) :
+        m_size(0),
+        m_decimal_point(0),
+        m_truncated(false)
+    {
+        const std::int64_t max_exponent = 100000;
+
+        bool seen_point = false;
+        const char *position = begin;
+
+        for (; position != end && *position != 'e' && *position != 'E'; ++position) {
+            if (*position == '.') {
+                seen_point = true;
+                m_decimal_point = static_cast<std::int64_t>(m_size);
+            } else if (*position == '0' && m_size == 0) {
+                --m_decimal_point;
+            } else if (m_size < max_digits) {
+                m_digits[m_size++] = static_cast<unsigned char>(*position - '0');
+            } else if (*position != '0') {
+                m_truncated = true;
+            }
+        }
+
+        if (!seen_point) {
+            m_decimal_point = static_cast<std::int64_t>(m_size);
+        }
+
+        if (position != end) {
+            ++position;
+
+            bool negative_exponent = false;
+            if (*position == '+' || *position == '-') {
+                negative_exponent = *position == '-';
+                ++position;
+            }
+
+            std::int64_t exponent = 0;
+            for (; position != end; ++position) {
+                if (exponent < max_exponent) {
+                    exponent = 10 * exponent + (*position - '0');
+                }
+            }
+
+            m_decimal_point += negative_exponent ? -exponent : exponent;
+        }
+
+        trim();
+    }
+
+    double to_double(bool negative) {
+        const int bias = -1023;
+        const int max_biased_exponent = 0x7FF;
+
+        if (m_size == 0 || m_decimal_point < -330) {
+            return make_double(0, 0, negative);
+        }
+
+        if (m_decimal_point > 310) {
+            return make_double(0, max_biased_exponent, negative);
+        }
+
+        // Number of bits to shift by to move the decimal point by the given number of digits without overshooting.
+        // Larger distances are covered in steps of 27 bits, which is less than 9 digits.
+        static const unsigned int shifts[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+        const std::int64_t shifts_count = sizeof(shifts) / sizeof(shifts[0]);
+        const unsigned int long_shift = 27;
+
+        int exponent = 0;
+
+        while (m_decimal_point > 0) {
+            unsigned int shift = m_decimal_point >= shifts_count ? long_shift : shifts[m_decimal_point];
+            shift_right(shift);
+            exponent += static_cast<int>(shift);
+        }
+
+        while (m_decimal_point < 0 || (m_decimal_point == 0 && m_digits[0] < 5)) {
+            unsigned int shift = -m_decimal_point >= shifts_count ? long_shift : shifts[-m_decimal_point];
+            shift_left(shift);
+            exponent -= static_cast<int>(shift);
+        }
+
+        // The number is in [0.5, 1) now, while the mantissa of a double is in [1, 2).
+        --exponent;
+
+        // Subnormal numbers.
+        if (exponent < bias + 1) {
+            shift_right(static_cast<unsigned int>(bias + 1 - exponent));
+            exponent = bias + 1;
+        }
+
+        if (exponent - bias >= max_biased_exponent) {
+            return make_double(0, max_biased_exponent, negative);
+        }
+
+        shift_left(53);
+        std::uint64_t mantissa = rounded_integer();
+
+        // Rounding may have added a bit.
+        if (mantissa == (2ull << 52)) {
+            mantissa >>= 1;
+            ++exponent;
+
+            if (exponent - bias >= max_biased_exponent) {
+                return make_double(0, max_biased_exponent, negative);
+            }
+        }
+
+        if (!(mantissa & (1ull << 52))) {
+            exponent = bias;
+        }
+
+        return make_double(mantissa & ((1ull << 52) - 1), exponent - bias, negative);
+    }
+
+private:
+    void trim() {
+        while (m_size > 0 && m_digits[m_size - 1] == 0) {
+            --m_size;
+        }
+
+        if (m_size == 0) {
+            m_decimal_point = 0;
+        }
+    }
+
+    void shift_left(unsigned int shift) {
+        while (shift > max_shift) {
+            shift_left_once(max_shift);
+            shift -= max_shift;
+        }
+
+        shift_left_once(shift);
+    }
+
+    void shift_right(unsigned int shift) {
+        while (shift > max_shift) {
+            shift_right_once(max_shift);
+            shift -= max_shift;
+        }
+
+        shift_right_once(shift);
+    }
+
+    void shift_left_once(unsigned int shift) {
+        if (m_size == 0) {
+            return;
+        }
+
+        // 2^shift has at most shift / 3 + 1 digits, so it's the upper bound on the number of new digits.
+        // Digits are written from the end and then moved to the beginning if there are fewer of them.
+        std::size_t added = shift / 3 + 1;
+        std::size_t write = m_size + added;
+        std::uint64_t accumulator = 0;
+
+        for (std::size_t read = m_size; read > 0; --read) {
+            accumulator += static_cast<std::uint64_t>(m_digits[read - 1]) << shift;
+            put_digit_before(write, accumulator);
+        }
+
+        while (accumulator > 0) {
+            put_digit_before(write, accumulator);
+        }
+
+        m_size = std::min<std::size_t>(m_size + added, max_digits);
+        m_decimal_point += static_cast<std::int64_t>(added);
+
+        if (write > 0) {
+            std::memmove(m_digits, m_digits + write, m_size - write);
+            m_size -= write;
+            m_decimal_point -= static_cast<std::int64_t>(write);
+        }
+
+        trim();
+    }
+
+    void put_digit_before(std::size_t &write, std::uint64_t &accumulator) {
+        std::uint64_t quotient = accumulator / 10;
+        std::uint64_t remainder = accumulator - 10 * quotient;
+
+        --write;
+
+        if (write < max_digits) {
+            m_digits[write] = static_cast<unsigned char>(remainder);
+        } else if (remainder != 0) {
+            m_truncated = true;
+        }
+
+        accumulator = quotient;
+    }
+
+    void shift_right_once(unsigned int shift) {
+        std::size_t read = 0;
+        std::size_t write = 0;
+        std::uint64_t accumulator = 0;
+
+        // Take enough leading digits to get a non-zero first digit of the result.
+        for (; (accumulator >> shift) == 0; ++read) {
+            if (read >= m_size) {
+                if (accumulator == 0) {
+                    m_size = 0;
+                    m_decimal_point = 0;
+                    return;
+                }
+
+                while ((accumulator >> shift) == 0) {
+                    accumulator *= 10;
+                    ++read;
+                }
+
+                break;
+            }
+
+            accumulator = 10 * accumulator + m_digits[read];
+        }
+
+        m_decimal_point -= static_cast<std::int64_t>(read) - 1;
+
+        std::uint64_t mask = (1ull << shift) - 1;
+
+        for (; read < m_size; ++read) {
+            m_digits[write++] = static_cast<unsigned char>(accumulator >> shift);
+            accumulator = 10 * (accumulator & mask) + m_digits[read];
+        }
+
+        while (accumulator > 0) {
+            unsigned char digit = static_cast<unsigned char>(accumulator >> shift);
+
+            if (write < max_digits) {
+                m_digits[write++] = digit;
+            } else if (digit > 0) {
+                m_truncated = true;
+            }
+
+            accumulator = 10 * (accumulator & mask);
+        }
+
+        m_size = write;
+        trim();
+    }
+
+    // Integer part of the number rounded half to even.
+    std::uint64_t rounded_integer() const {
+        std::uint64_t result = 0;
+        std::int64_t index = 0;
+
+        for (; index < m_decimal_point && index < static_cast<std::int64_t>(m_size); ++index) {
+            result = 10 * result + m_digits[index];
+        }
+
+        for (; index < m_decimal_point; ++index) {
+            result *= 10;
+        }
+
+        if (m_decimal_point >= 0 && m_decimal_point < static_cast<std::int64_t>(m_size)) {
+            std::size_t point = static_cast<std::size_t>(m_decimal_point);
+            bool round_up = false;
+
+            if (m_digits[point] == 5 && point + 1 == m_size) {
+                // Exactly half-way, unless some digits were lost.
+                round_up = m_truncated || (point > 0 && m_digits[point - 1] % 2 == 1);
+            } else {
+                round_up = m_digits[point] >= 5;
+            }
+
+            if (round_up) {
+                ++result;
+            }
+        }
+
+        return result;
+    }
+
+    unsigned char m_digits[max_digits];
+    std::size_t m_size;
+    std::int64_t m_decimal_point;
+    bool m_truncated;
+};
+
+// Exact result for mantissas up to 2^53 and powers of ten up to 10^22, since all of them are exact doubles.
+// It relies on each arithmetic operation being rounded to double, which isn't the case for the x87 FPU.
+inline bool clinger_fast_path(std::uint64_t mantissa, std::int64_t exponent, bool negative, double &result) {
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    static const double powers_of_ten[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    if (mantissa > (1ull << 53) || exponent < -22 || exponent > 22) {
+        return false;
+    }
+
+    result = static_cast<double>(mantissa);
+
+    if (exponent < 0) {
+        result /= powers_of_ten[-exponent];
+    } else {
+        result *= powers_of_ten[exponent];
+    }
+
+    if (negative) {
+        result = -result;
+    }
+
+    return true;
+#else
+    (void)mantissa;
+    (void)exponent;
+    (void)negative;
+    (void)result;
+    return false;
+#endif
+}
+
+// The Eisel-Lemire algorithm. See "Number Parsing at a Gigabyte per Second" by Daniel Lemire.
+// Computes the mantissa (with the implicit bit cleared) and the biased exponent of mantissa * 10^exponent.
+// Returns false if the result can't be decided with 128-bit precision.
+inline bool eisel_lemire(std::uint64_t mantissa,
+                         std::int64_t exponent,
+                         std::uint64_t &result_mantissa,
+                         int &result_exponent)
+{
+    const int mantissa_bits = 52;
+    const int min_exponent = -1023;
+    const int max_biased_exponent = 0x7FF;
+
+    if (mantissa == 0 || exponent < smallest_power_of_five) {
+        result_mantissa = 0;
+        result_exponent = 0;
+        return true;
+    }
+
+    if (exponent > largest_power_of_five) {
+        result_mantissa = 0;
+        result_exponent = max_biased_exponent;
+        return true;
+    }
+
+    int q = static_cast<int>(exponent);
+    int shifted_zeros = leading_zeros(mantissa);
+    mantissa <<= shifted_zeros;
+
+    // Only 55 high bits of the product matter. If the lower bits of its first word are all ones,
+    // the carry from the next word may change them.
+    const std::uint64_t *power = power_of_five_128() + 2 * (q - smallest_power_of_five);
+    const std::uint64_t precision_mask = 0xFFFFFFFFFFFFFFFFull >> (mantissa_bits + 3);
+
+    uint128_parts_t product = full_multiplication(mantissa, power[0]);
+
+    if ((product.high & precision_mask) == precision_mask) {
+        uint128_parts_t second_product = full_multiplication(mantissa, power[1]);
+        product.low += second_product.high;
+
+        if (second_product.high > product.low) {
+            ++product.high;
+        }
+    }
+
+    if (product.low == 0xFFFFFFFFFFFFFFFFull && (q < -27 || q > 55)) {
+        return false;
+    }
+
+    int upper_bit = static_cast<int>(product.high >> 63);
+    int shift = upper_bit + 64 - mantissa_bits - 3;
+
+    result_mantissa = product.high >> shift;
+    // (((152170 + 65536) * q) >> 16) is floor(log2(5^q)) + q.
+    result_exponent = (((152170 + 65536) * q) >> 16) + 63 + upper_bit - shifted_zeros - min_exponent;
+
+    if (result_exponent <= 0) {
+        // Subnormal number.
+        if (-result_exponent + 1 >= 64) {
+            result_mantissa = 0;
+            result_exponent = 0;
+            return true;
+        }
+
+        result_mantissa >>= -result_exponent + 1;
+        result_mantissa += result_mantissa & 1;
+        result_mantissa >>= 1;
+        result_exponent = result_mantissa < (1ull << mantissa_bits) ? 0 : 1;
+        result_mantissa &= ~(1ull << mantissa_bits);
+        return true;
+    }
+
+    // The product is exact and it's exactly half-way between two doubles: round to even.
+    // It may happen only for small powers of ten.
+    if (product.low <= 1 && q >= -4 && q <= 23 && (result_mantissa & 3) == 1 &&
+        (result_mantissa << shift) == product.high)
+    {
+        result_mantissa &= ~1ull;
+    }
+
+    result_mantissa += result_mantissa & 1;
+    result_mantissa >>= 1;
+
+    if (result_mantissa >= (2ull << mantissa_bits)) {
+        result_mantissa = 1ull << mantissa_bits;
+        ++result_exponent;
+    }
+
+    result_mantissa &= ~(1ull << mantissa_bits);
+
+    if (result_exponent >= max_biased_exponent) {
+        result_mantissa = 0;
+        result_exponent = max_biased_exponent;
+    }
+
+    return true;
+}
+
+// Converts a well-formed number without the sign (see split_decimal()) to the nearest double.
+// Out of range numbers become zero or infinity.
+inline double decimal_to_double(const char *begin, const char *end, bool negative) {
+    decimal_split_t split = split_decimal(begin, end);
+
+    double result = 0;
+    if (!split.truncated && clinger_fast_path(split.mantissa, split.exponent, negative, result)) {
+        return result;
+    }
+
+    std::uint64_t mantissa = 0;
+    int exponent = 0;
+
+    if (eisel_lemire(split.mantissa, split.exponent, mantissa, exponent)) {
+        if (!split.truncated) {
+            return make_double(mantissa, exponent, negative);
+        }
+
+        // The exact number is between mantissa * 10^exponent and (mantissa + 1) * 10^exponent.
+        std::uint64_t upper_mantissa = 0;
+        int upper_exponent = 0;
+
+        if (eisel_lemire(split.mantissa + 1, split.exponent, upper_mantissa, upper_exponent) &&
+            upper_mantissa == mantissa && upper_exponent == exponent)
+        {
+            return make_double(mantissa, exponent, negative);
+        }
+    }
+
+    return big_decimal_t(begin, end).to_double(negative);
+}
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_NUMBER_HPP
@@ -0,0 +1,283 @@
+#ifndef LOLTOML_DETAIL_PARALLEL_HPP
+#define LOLTOML_DETAIL_PARALLEL_HPP
+
+#include "loltoml/action.hpp"
+#include "loltoml/detail/arena.hpp"
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/header_scanner.hpp"
+#include "loltoml/detail/input_buffer.hpp"
+#include "loltoml/detail/parser.hpp"
+#include "loltoml/detail/recorder.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Part of the document between two header lines.
+struct chunk_t {
+    std::size_t begin;
+    std::size_t end;
+    bool failed;
+    std::vector<recorded_event_t> events;
+    // Strings which don't point into the document.
+    arena_t strings;
+
+    chunk_t(std::size_t begin, std::size_t end) :
+        begin(begin),
+        end(end),
+        failed(false)
+    { }
+};
+
+
+// Runs the recorded events through the key validator. Returns false if the document redefines something.
+inline bool validate_events(const std::vector<chunk_t> &chunks, key_validator_t &validator) {
+    std::vector<string_view_t> path;
+    validator.reset();
+
+    for (auto chunk = chunks.begin(); chunk != chunks.end(); ++chunk) {
+        for (auto it = chunk->events.begin(); it != chunk->events.end(); ++it) {
+            const char *error = nullptr;
+
+            switch (it->type) {
+                case recorded_event_t::table:
+                case recorded_event_t::array_table: {
+                    path.clear();
+
+                    for (std::size_t i = 0; i < it->size; ++i) {
+                        path.push_back(event_string(*(it + 1 + i)));
+                    }
+
+                    error = (it->type == recorded_event_t::table) ? validator.table(path.cbegin(), path.cend())
+                                                                  : validator.array_table(path.cbegin(), path.cend());
+                    it += it->size;
+                } break;
+                case recorded_event_t::key: {
+                    error = validator.key(event_string(*it));
+                } break;
+                case recorded_event_t::start_array: {
+                    validator.start_array();
+                } break;
+                case recorded_event_t::finish_array: {
+                    validator.finish_array();
+                } break;
+                case recorded_event_t::start_inline_table: {
+                    validator.start_inline_table();
+                } break;
+                case recorded_event_t::finish_inline_table: {
+                    validator.finish_inline_table();
+                } break;
+                default: break;
+            }
+
+            if (error) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+// Returns false if the handler has stopped the parser. Actions returned by the handler are applied
+// to the recorded events, e.g. the content of a skipped table is dropped.
+template<class Handler, class Allocator>
+bool replay_events(chunk_t &chunk,
+                   Handler &handler,
+                   event_emitter_t<Handler, Allocator> &emit,
+                   basic_parser_buffers_t<Allocator> &buffers)
+{
+    typedef typename basic_parser_buffers_t<Allocator>::key_iterator_t key_iterator_t;
+    typename basic_parser_buffers_t<Allocator>::path_t &path = buffers.path;
+
+    for (auto it = chunk.events.begin(); it != chunk.events.end(); ++it) {
+        if (buffers.skip_table && it->type != recorded_event_t::table && it->type != recorded_event_t::array_table) {
+            continue;
+        }
+
+        switch (it->type) {
+            case recorded_event_t::comment: {
+                emit.comment(event_string(*it));
+            } break;
+            case recorded_event_t::table:
+            case recorded_event_t::array_table: {
+                buffers.path_size = 0;
+
+                for (std::size_t i = 0; i < it->size; ++i) {
+                    buffers.push_path_key(event_string(*(it + 1 + i)));
+                }
+
+                key_iterator_t begin = path.cbegin();
+                key_iterator_t end = begin + static_cast<std::ptrdiff_t>(it->size);
+
+                action_t action = (it->type == recorded_event_t::table) ? emit.table(begin, end)
+                                                                       : emit.array_table(begin, end);
+
+                if (action == action_t::stop) {
+                    buffers.stopped = true;
+                    return false;
+                }
+
+                buffers.skip_table = (action == action_t::skip_value);
+                it += it->size;
+            } break;
+            case recorded_event_t::path_key: {
+                assert(false);
+            } break;
+            case recorded_event_t::key: {
+                action_t action = emit.key(event_string(*it));
+
+                if (action == action_t::stop) {
+                    buffers.stopped = true;
+                    return false;
+                } else if (action == action_t::skip_value) {
+                    // The value has been parsed anyway, but the handler mustn't see it.
+                    it = skip_recorded_value(it + 1) - 1;
+                }
+            } break;
+            case recorded_event_t::start_array: {
+                handler.start_array();
+            } break;
+            case recorded_event_t::finish_array: {
+                handler.finish_array(it->size);
+            } break;
+            case recorded_event_t::start_inline_table: {
+                handler.start_inline_table();
+            } break;
+            case recorded_event_t::finish_inline_table: {
+                handler.finish_inline_table(it->size);
+            } break;
+            case recorded_event_t::boolean: {
+                handler.boolean(it->value.boolean);
+            } break;
+            case recorded_event_t::string: {
+                emit.string(event_string(*it));
+            } break;
+            case recorded_event_t::datetime: {
+                emit.datetime(event_string(*it));
+            } break;
+            case recorded_event_t::integer: {
+                handler.integer(it->value.integer);
+            } break;
+            case recorded_event_t::floating_point: {
+                handler.floating_point(it->value.floating_point);
+            } break;
+        }
+    }
+
+    return true;
+}
+
+
+// Splits the document into chunks at header lines, parses them concurrently and replays the events in order.
+// If parsing of any chunk fails or the document redefines keys (when validation is enabled), the whole document
+// is parsed again sequentially, so the handler sees exactly the same events and errors as with parser_t::parse().
+// Worker threads use their own buffers with the default allocator, since custom allocators (e.g. arenas)
+// are usually not thread-safe. Only the events reaching the handler use the buffers of the caller.
+template<class Handler, class Allocator>
+bool parse_parallel(const char *data,
+                    std::size_t size,
+                    Handler &handler,
+                    basic_parser_buffers_t<Allocator> &buffers,
+                    std::size_t threads,
+                    std::size_t min_chunk_size)
+{
+    std::vector<std::size_t> boundaries;
+
+    if (threads > 1) {
+        find_header_lines(data, size, min_chunk_size, boundaries);
+    }
+
+    if (boundaries.empty()) {
+        input_buffer_t input(data, size);
+        return parser_t<input_buffer_t, Handler, Allocator>(input, handler, buffers).parse();
+    }
+
+    std::vector<chunk_t> chunks;
+    chunks.reserve(boundaries.size() + 1);
+    chunks.emplace_back(0, boundaries.front());
+
+    for (std::size_t i = 0; i + 1 < boundaries.size(); ++i) {
+        chunks.emplace_back(boundaries[i], boundaries[i + 1]);
+    }
+
+    chunks.emplace_back(boundaries.back(), size);
+
+    std::atomic<std::size_t> next_chunk(0);
+    std::atomic<bool> failed(false);
+
+    auto worker = [&]() {
+        parser_buffers_t worker_buffers;
+
+        for (std::size_t i = next_chunk++; i < chunks.size() && !failed; i = next_chunk++) {
+            chunk_t &chunk = chunks[i];
+            input_buffer_t input(data + chunk.begin, chunk.end - chunk.begin);
+            recorder_t recorder(chunk.events, chunk.strings, data, size,
+                                handler_traits_t<Handler>::structured_datetime_t::value);
+
+            try {
+                parser_t<input_buffer_t, recorder_t>(input, recorder, worker_buffers).parse();
+            } catch (...) {
+                chunk.failed = true;
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    std::size_t workers_count = std::min(threads, chunks.size()) - 1;
+
+    try {
+        for (std::size_t i = 0; i < workers_count; ++i) {
+            workers.emplace_back(worker);
+        }
+    } catch (...) {
+        // Not able to start more threads, the current one will do the rest.
+    }
+
+    worker();
+
+    for (auto it = workers.begin(); it != workers.end(); ++it) {
+        it->join();
+    }
+
+    if (failed || (buffers.validate_keys && !validate_events(chunks, buffers.keys))) {
+        chunks.clear();
+        input_buffer_t input(data, size);
+        return parser_t<input_buffer_t, Handler, Allocator>(input, handler, buffers).parse();
+    }
+
+    event_emitter_t<Handler, Allocator> emit(handler, buffers);
+    buffers.start_document();
+    handler.start_document();
+
+    for (auto it = chunks.begin(); it != chunks.end(); ++it) {
+        if (!replay_events(*it, handler, emit, buffers)) {
+            return false;
+        }
+
+        // Free memory as soon as possible.
+        std::vector<recorded_event_t>().swap(it->events);
+        it->strings = arena_t();
+    }
+
+    handler.finish_document();
+    return true;
+}
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_PARALLEL_HPP
@@ -1,16 +1,28 @@
 #ifndef LOLTOML_DETAIL_PARSER_HPP
 #define LOLTOML_DETAIL_PARSER_HPP
 
+#include "loltoml/action.hpp"
+#include "loltoml/datetime.hpp"
 #include "loltoml/detail/common.hpp"
+#include "loltoml/detail/handler_traits.hpp"
+#include "loltoml/detail/input_buffer.hpp"
 #include "loltoml/detail/input_stream.hpp"
+#include "loltoml/detail/key_validator.hpp"
+#include "loltoml/detail/number.hpp"
+#include "loltoml/detail/scan.hpp"
+#include "loltoml/detail/stats.hpp"
 #include "loltoml/error.hpp"
+#include "loltoml/string_view.hpp"
+#include "loltoml/symbol_table.hpp"
 
 #include <cassert>
 #include <cctype>
 #include <cmath>
-#include <cstdlib>
 #include <cstring>
+#include <limits>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 LOLTOML_OPEN_NAMESPACE
@@ -18,74 +30,399 @@ LOLTOML_OPEN_NAMESPACE
 namespace detail {
 
 
-inline std::string escape_char(char ch) {
-    if (ch == '\\') {
-        return "\\\\";
-    } else if (ch == '\'') {
-        return "\\\'";
-    } else if (ch == '\"') {
-        return "\\\"";
-    } else if (ch == '\b') {
-        return "\\b";
-    } else if (ch == '\t') {
-        return "\\t";
-    } else if (ch == '\r') {
-        return "\\r";
-    } else if (ch == '\n') {
-        return "\\n";
-    } else if (std::isprint(ch)) {
-        return std::string(1, ch);
-    } else {
-        const char *hex_digits = "0123456789abcdef";
-        char result[5] = "\\xYY";
-
-        result[2] = hex_digits[static_cast<unsigned char>(ch) / 16];
-        result[3] = hex_digits[static_cast<unsigned char>(ch) % 16];
+typedef std::vector<std::string>::const_iterator key_iterator_t;
 
-        return result;
+
+// Memory used by the parser. It may be kept between parser runs to avoid reallocations.
+// The path and the strings are allocated by the Allocator (rebound to the needed types),
+// and handlers not accepting string_view_t receive strings of type string_t.
+template<class Allocator>
+struct basic_parser_buffers_t {
+    typedef std::allocator_traits<Allocator> allocator_traits_t;
+    typedef typename allocator_traits_t::template rebind_alloc<char> char_allocator_t;
+    typedef std::basic_string<char, std::char_traits<char>, char_allocator_t> string_t;
+    typedef std::vector<string_t, typename allocator_traits_t::template rebind_alloc<string_t>> path_t;
+    typedef typename path_t::const_iterator key_iterator_t;
+
+    // Keys of the current table header. Only the first path_size elements are meaningful,
+    // the rest are kept to reuse their memory.
+    path_t path;
+    std::size_t path_size;
+
+    // Strings which cannot be referenced in the input directly are accumulated here.
+    string_t string;
+
+    // Opening brackets of deeply nested values being skipped.
+    string_t brackets;
+
+    // If validate_keys is true, the parser checks that keys and tables are not redefined.
+    bool validate_keys;
+    key_validator_t keys;
+
+    // Used only for handlers accepting loltoml::symbol_t.
+    symbol_cache_t symbols;
+    std::vector<symbol_t, typename allocator_traits_t::template rebind_alloc<symbol_t>> symbol_path;
+
+    // The handler has asked to skip the content of the current table.
+    bool skip_table;
+    // The handler has asked to stop parsing, or the parser has found an error.
+    bool stopped;
+    // The parser has found an error. It's kept here instead of being thrown, so rejecting a document
+    // doesn't unwind the stack. Only the first error is kept.
+    bool failed;
+    parser_error_t error;
+
+    // Counters of the parser, see loltoml::parse_stats_t.
+    stats_recorder_t stats;
+
+    explicit basic_parser_buffers_t(const Allocator &allocator = Allocator()) :
+        path(allocator),
+        path_size(0),
+        string(allocator),
+        brackets(allocator),
+        validate_keys(false),
+        symbol_path(allocator),
+        skip_table(false),
+        stopped(false),
+        failed(false),
+        error(error_code_t::none, "", 0)
+    { }
+
+    char_allocator_t allocator() const {
+        return string.get_allocator();
     }
-}
 
+    // Appends a key to the path. New strings get the allocator too, since containers don't pass it on.
+    void push_path_key(string_view_t key) {
+        if (path_size == path.size()) {
+            path.emplace_back(allocator());
+        }
 
-inline bool iscontrol(char ch) {
-    return static_cast<unsigned char>(ch) < 32;
-}
+        path[path_size].assign(key.data(), key.size());
+        ++path_size;
+    }
 
+    // Prepares the state for a new document.
+    void start_document() {
+        if (validate_keys) {
+            keys.reset();
+        }
 
-inline bool is_key_character(char ch) {
-    return (ch >= 'a' && ch <= 'z') ||
-           (ch >= 'A' && ch <= 'Z') ||
-           (ch >= '0' && ch <= '9') ||
-           ch == '-' ||
-           ch == '_';
-}
+        skip_table = false;
+        stopped = false;
+        failed = false;
+    }
 
+    // Forgets the content but keeps the memory.
+    void clear() {
+        for (auto it = path.begin(); it != path.end(); ++it) {
+            it->clear();
+        }
 
-typedef std::vector<std::string>::const_iterator key_iterator_t;
+        path_size = 0;
+        string.clear();
+        brackets.clear();
+        keys.reset();
+        symbol_path.clear();
+        skip_table = false;
+        stopped = false;
+        failed = false;
+    }
+
+    // Passes the memory held by the buffers to the stats.
+    void record_scratch() {
+        if (!stats.enabled()) {
+            return;
+        }
+
+        // Keys of the path are counted as one buffer.
+        std::size_t keys = 0;
+        for (auto it = path.begin(); it != path.end(); ++it) {
+            keys += it->capacity();
+        }
+
+        const std::size_t capacities[stats_recorder_t::buffers_count] = {
+            string.capacity(),
+            path.capacity() * sizeof(string_t),
+            keys,
+            symbol_path.capacity() * sizeof(symbol_t),
+            brackets.capacity()
+        };
+
+        stats.scratch(capacities);
+    }
+};
+
+
+typedef basic_parser_buffers_t<std::allocator<char>> parser_buffers_t;
+
+
+// Counts the bytes consumed by a production while the scope is alive.
+template<class Input, class Buffers>
+class production_scope_t {
+public:
+    production_scope_t(Buffers &buffers, const Input &input, grammar_production_t production) :
+        m_buffers(buffers),
+        m_input(input),
+        m_production(production),
+        m_start(buffers.stats.enabled() ? input.processed() : 0)
+    { }
+
+    ~production_scope_t() {
+        if (m_buffers.stats.enabled()) {
+            m_buffers.stats.production(m_production, m_input.processed() - m_start);
+            m_buffers.record_scratch();
+        }
+    }
+
+    // For productions recognized after the first characters.
+    void set(grammar_production_t production) {
+        m_production = production;
+    }
+
+private:
+    Buffers &m_buffers;
+    const Input &m_input;
+    grammar_production_t m_production;
+    std::size_t m_start;
+};
+
+
+// Passes events to the handler converting strings and keys to the types the handler accepts.
+template<class Handler, class Allocator = std::allocator<char>>
+class event_emitter_t {
+    typedef handler_traits_t<Handler> traits_t;
+    typedef basic_parser_buffers_t<Allocator> buffers_t;
+    typedef typename buffers_t::string_t string_t;
+    typedef typename buffers_t::key_iterator_t key_iterator_t;
+
+    Handler &handler;
+    buffers_t &buffers;
+
+public:
+    event_emitter_t(Handler &handler, buffers_t &buffers) :
+        handler(handler),
+        buffers(buffers)
+    { }
+
+    action_t key(string_view_t value) {
+        return emit_key(value, typename traits_t::view_key_t(), typename traits_t::symbol_key_t());
+    }
+
+    void string(string_view_t value) {
+        emit_string(value, typename traits_t::view_string_t());
+    }
+
+    void comment(string_view_t value) {
+        emit_comment(value, typename traits_t::view_comment_t());
+    }
+
+    // Handlers accepting loltoml::datetime_t receive the fields decoded from the value,
+    // which must have been checked by decode_datetime() before.
+    void datetime(string_view_t value) {
+        emit_datetime(value, typename traits_t::view_datetime_t(), typename traits_t::structured_datetime_t());
+    }
+
+    action_t table(key_iterator_t begin, key_iterator_t end) {
+        return emit_table(begin, end, typename traits_t::symbol_table_path_t());
+    }
+
+    action_t array_table(key_iterator_t begin, key_iterator_t end) {
+        return emit_array_table(begin, end, typename traits_t::symbol_array_table_path_t());
+    }
 
+private:
+    // Handlers not accepting string_view_t are given the string from buffers.string.
+    const string_t &to_string(string_view_t value) {
+        if (value.data() != buffers.string.data()) {
+            buffers.string.assign(value.data(), value.size());
+        }
+
+        return buffers.string;
+    }
+
+    action_t emit_key(string_view_t key, std::true_type, std::false_type) {
+        return invoke_for_action([&] { return handler.key(key); });
+    }
+
+    action_t emit_key(string_view_t key, std::false_type, std::false_type) {
+        const string_t &value = to_string(key);
+        return invoke_for_action([&] { return handler.key(value); });
+    }
+
+    template<class View>
+    action_t emit_key(string_view_t key, View, std::true_type) {
+        symbol_t symbol = buffers.symbols.get(key);
+        return invoke_for_action([&] { return handler.key(symbol); });
+    }
+
+    void emit_string(string_view_t value, std::true_type) {
+        handler.string(value);
+    }
+
+    void emit_string(string_view_t value, std::false_type) {
+        handler.string(to_string(value));
+    }
 
-template<class Handler>
+    void emit_comment(string_view_t comment, std::true_type) {
+        handler.comment(comment);
+    }
+
+    void emit_comment(string_view_t comment, std::false_type) {
+        handler.comment(to_string(comment));
+    }
+
+    void emit_datetime(string_view_t value, std::true_type, std::false_type) {
+        handler.datetime(value);
+    }
+
+    void emit_datetime(string_view_t value, std::false_type, std::false_type) {
+        handler.datetime(to_string(value));
+    }
+
+    template<class View>
+    void emit_datetime(string_view_t value, View, std::true_type) {
+        datetime_t fields;
+        std::size_t error_position = 0;
+        const char *error = decode_datetime(value, fields, error_position);
+
+        assert(!error);
+        (void)error;
+
+        handler.datetime(fields);
+    }
+
+    action_t emit_table(key_iterator_t begin, key_iterator_t end, std::false_type) {
+        return invoke_for_action([&] { return handler.table(begin, end); });
+    }
+
+    action_t emit_table(key_iterator_t begin, key_iterator_t end, std::true_type) {
+        symbol_iterator_t path = intern_path(begin, end);
+        return invoke_for_action([&] { return handler.table(path, path + buffers.symbol_path.size()); });
+    }
+
+    action_t emit_array_table(key_iterator_t begin, key_iterator_t end, std::false_type) {
+        return invoke_for_action([&] { return handler.array_table(begin, end); });
+    }
+
+    action_t emit_array_table(key_iterator_t begin, key_iterator_t end, std::true_type) {
+        symbol_iterator_t path = intern_path(begin, end);
+        return invoke_for_action([&] { return handler.array_table(path, path + buffers.symbol_path.size()); });
+    }
+
+    symbol_iterator_t intern_path(key_iterator_t begin, key_iterator_t end) {
+        buffers.symbol_path.clear();
+
+        for (; begin != end; ++begin) {
+            buffers.symbol_path.push_back(buffers.symbols.get(*begin));
+        }
+
+        return buffers.symbol_path.data();
+    }
+};
+
+
+// Input is either input_stream_t or input_buffer_t.
+template<class Input, class Handler, class Allocator = std::allocator<char>>
 class parser_t {
-    input_stream_t input;
+    typedef std::integral_constant<bool, Input::is_contiguous> contiguous_t;
+    typedef basic_parser_buffers_t<Allocator> buffers_t;
+    typedef typename buffers_t::string_t string_t;
+    typedef typename buffers_t::key_iterator_t key_iterator_t;
+    typedef production_scope_t<Input, buffers_t> scope_t;
+
+    Input &input;
     Handler &handler;
+    buffers_t &buffers;
+    string_t &string_buffer;
+    event_emitter_t<Handler, Allocator> emit;
+    // Action for the value of the current key-value pair.
+    action_t value_action;
 
 public:
-    parser_t(std::istream &input, Handler &handler) :
+    parser_t(Input &input, Handler &handler, buffers_t &buffers) :
         input(input),
-        handler(handler)
+        handler(handler),
+        buffers(buffers),
+        string_buffer(buffers.string),
+        emit(handler, buffers),
+        value_action(action_t::proceed)
     { }
 
-    void parse() {
-        handler.start_document();
+    // Returns false if the handler has stopped the parser. Throws the errors.
+    bool parse() {
+        bool result = try_parse();
+        throw_if_failed();
+        return result;
+    }
 
-        parse_expression();
+    // Returns false if the handler has stopped the parser or the document is invalid.
+    // Then buffers.failed tells whether it's an error, which is left in buffers.error.
+    bool try_parse() {
+        buffers.start_document();
+        buffers.record_scratch();
+        scope_t scope(buffers, input, grammar_production_t::document);
 
-        while (!input.eof()) {
-            parse_new_line();
-            parse_expression();
+        buffers.stats.event(parse_event_t::start_document);
+        handler.start_document();
+        parse_expressions();
+
+        if (buffers.stopped) {
+            return false;
         }
 
+        buffers.stats.event(parse_event_t::finish_document);
         handler.finish_document();
+        return true;
+    }
+
+    // Parses expressions until the end of the input without notifying the handler about the start and the end
+    // of the document. The document may be split into several parts parsed one after another
+    // if they're split right after new-lines ending expressions (see statement_scanner_t).
+    // It stops early if the handler returns action_t::stop, then buffers.stopped is set.
+    void parse_part() {
+        parse_expressions();
+        throw_if_failed();
+    }
+
+    // Results of the steps of parse_part().
+    enum class step_t {
+        // The input has ended.
+        input_ended,
+        // An expression (possibly empty) has been parsed.
+        expression,
+        // The key of a key-value pair has been emitted. The pair must be finished by finish_key_value().
+        value_pending
+    };
+
+    // parse_part() split into steps for parsing the document lazily.
+    step_t parse_first_step() {
+        step_t result = parse_expression_start();
+        throw_if_failed();
+        return result;
+    }
+
+    // Parses the new-line ending the previous expression and the next expression (which may be empty).
+    // Key-value pairs are parsed only up to the value.
+    step_t parse_next_step() {
+        if (buffers.stopped || input.eof()) {
+            return step_t::input_ended;
+        }
+
+        step_t result = step_t::expression;
+
+        if (parse_new_line()) {
+            result = parse_expression_start();
+        }
+
+        throw_if_failed();
+        return result;
+    }
+
+    // Parses or skips the value after step_t::value_pending and the rest of the line.
+    void finish_key_value(action_t action) {
+        parse_expression_end(action);
+        throw_if_failed();
     }
 
 private:
@@ -104,6 +441,63 @@ private:
         return (processed == 0) ? 0 : (processed - 1);
     }
 
+    // Remembers the first error and stops the parser. Every caller checks buffers.stopped before going on,
+    // so the handler receives no events after the error.
+    // If the input has been read past the end, the error is caused by the '\0' returned by the input,
+    // so the end of the input is reported instead.
+    void fail(const parser_error_t &error) {
+        if (!buffers.failed) {
+            buffers.failed = true;
+            buffers.stopped = true;
+            buffers.error = input.failed() ? input.error() : error;
+        }
+    }
+
+    void fail(error_code_t code, const char *message, std::size_t offset) {
+        fail(parser_error_t(code, message, offset));
+    }
+
+    // Stops the parser if the input has been read past the end. It's needed only in loops which would accept '\0'.
+    bool input_failed() {
+        if (input.failed()) {
+            fail(input.error());
+            return true;
+        }
+
+        return false;
+    }
+
+    // The throwing interface of the parser. The flags are reset, as if the error had been thrown where it was found.
+    void throw_if_failed() {
+        if (!buffers.failed) {
+            return;
+        }
+
+        buffers.failed = false;
+        buffers.stopped = false;
+
+        if (buffers.error.code() == error_code_t::stream_error) {
+            throw stream_error_t(buffers.error.offset());
+        }
+
+        throw buffers.error;
+    }
+
+    // Parses expressions until the end of the input or until the parser is stopped. See parse_part().
+    void parse_expressions() {
+        parse_expression();
+
+        while (!buffers.stopped && !input.eof()) {
+            if (!parse_new_line()) {
+                return;
+            }
+
+            parse_expression();
+        }
+
+        input_failed();
+    }
+
     template<std::size_t N>
     char parse_chars(const char (&expected)[N]) {
         static_assert(N > 0, "No expected characters specified");
@@ -116,13 +510,9 @@ private:
             }
         }
 
-        std::string list = "\'" + escape_char(expected[0]) + "\'";
-
-        for (std::size_t i = 1; i + 1 < N; ++i) {
-            list += ", \'" + escape_char(expected[i]) + "\'";
-        }
-
-        throw parser_error_t("Expected one of the following symbols: " + list, last_char_offset());
+        // The message is built only if it's requested.
+        fail(parser_error_t::unexpected_character(expected, last_char_offset()));
+        return '\0';
     }
 
     void skip_spaces() {
@@ -133,17 +523,190 @@ private:
 
     void parse_comment() {
         assert(input.peek() == '#');
+        scope_t scope(buffers, input, grammar_production_t::comment);
         input.get();
 
-        std::string comment;
-        while (input.peek() == '\t' || !iscontrol(input.peek())) {
-            comment.push_back(input.get());
+        string_view_t comment;
+        if (!scan_comment(comment, contiguous_t())) {
+            while (input.peek() == '\t' || !iscontrol(input.peek())) {
+                string_buffer.push_back(input.get());
+            }
+
+            if (input_failed()) {
+                return;
+            }
+
+            comment = string_buffer;
         }
 
-        handler.comment(comment);
+        // Comments of skipped tables are skipped too.
+        if (!buffers.skip_table) {
+            buffers.stats.event(parse_event_t::comment);
+            emit.comment(comment);
+        }
+    }
+
+    // Fast paths for contiguous inputs. They return true if the whole token is found in the input.
+    // Otherwise they copy the scanned prefix to string_buffer and leave the rest to the generic code.
+    bool scan_comment(string_view_t &result, std::true_type) {
+        const char *begin = input.position();
+        const char *it = detail::scan_comment(begin, input.end());
+
+        if (it != input.end()) {
+            result = string_view_t(begin, it - begin);
+            input.skip(it - begin);
+            return true;
+        }
+
+        string_buffer.assign(begin, it);
+        input.skip(it - begin);
+        return false;
+    }
+
+    bool scan_comment(string_view_t &, std::false_type) {
+        string_buffer.clear();
+        return false;
+    }
+
+    bool scan_key(string_view_t &result, std::true_type) {
+        const char *begin = input.position();
+        const char *it = detail::scan_key(begin, input.end());
+
+        if (it != begin && it != input.end()) {
+            result = string_view_t(begin, it - begin);
+            input.skip(it - begin);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool scan_key(string_view_t &, std::false_type) {
+        return false;
+    }
+
+    bool scan_basic_string(string_view_t &result, std::true_type) {
+        const char *begin = input.position();
+        const char *it = detail::scan_basic_string(begin, input.end());
+
+        if (it != input.end() && *it == '"') {
+            result = string_view_t(begin, it - begin);
+            input.skip(it - begin + 1);
+            return true;
+        }
+
+        string_buffer.assign(begin, it);
+        input.skip(it - begin);
+        return false;
+    }
+
+    bool scan_basic_string(string_view_t &, std::false_type) {
+        string_buffer.clear();
+        return false;
+    }
+
+    bool scan_multiline_string(string_view_t &result, std::true_type) {
+        const char *begin = input.position();
+        const char *end = input.end();
+        const char *it = begin;
+
+        while (true) {
+            it = detail::scan_multiline_string(it, end);
+
+            if (it == end || *it != '"') {
+                break;
+            } else if (end - it >= 3 && it[1] == '"' && it[2] == '"') {
+                result = string_view_t(begin, it - begin);
+                input.skip(it - begin + 3);
+                return true;
+            } else {
+                ++it;
+            }
+        }
+
+        string_buffer.assign(begin, it);
+        input.skip(it - begin);
+        return false;
     }
 
-    void parse_new_line() {
+    bool scan_multiline_string(string_view_t &, std::false_type) {
+        string_buffer.clear();
+        return false;
+    }
+
+    bool scan_literal_string(string_view_t &result, std::true_type) {
+        const char *begin = input.position();
+        const char *it = detail::scan_literal_string(begin, input.end());
+
+        if (it != input.end() && *it == '\'') {
+            result = string_view_t(begin, it - begin);
+            input.skip(it - begin + 1);
+            return true;
+        }
+
+        string_buffer.assign(begin, it);
+        input.skip(it - begin);
+        return false;
+    }
+
+    bool scan_literal_string(string_view_t &, std::false_type) {
+        string_buffer.clear();
+        return false;
+    }
+
+    bool scan_multiline_literal_string(string_view_t &result, std::true_type) {
+        const char *begin = input.position();
+        const char *end = input.end();
+        const char *it = begin;
+
+        while (true) {
+            it = detail::scan_multiline_literal_string(it, end);
+
+            if (it == end || *it != '\'') {
+                break;
+            } else if (end - it >= 3 && it[1] == '\'' && it[2] == '\'') {
+                result = string_view_t(begin, it - begin);
+                input.skip(it - begin + 3);
+                return true;
+            } else {
+                ++it;
+            }
+        }
+
+        string_buffer.assign(begin, it);
+        input.skip(it - begin);
+        return false;
+    }
+
+    bool scan_multiline_literal_string(string_view_t &, std::false_type) {
+        string_buffer.clear();
+        return false;
+    }
+
+    // Reads 8 digits at once from contiguous inputs. Returns false if the next 8 chars are not all digits.
+    bool scan_eight_digits(char *digits, std::uint32_t &value, std::true_type) {
+        if (input.end() - input.position() < 8) {
+            return false;
+        }
+
+        std::uint64_t chars = load_eight_chars(input.position());
+
+        if (!is_eight_digits(chars)) {
+            return false;
+        }
+
+        std::memcpy(digits, input.position(), 8);
+        input.skip(8);
+        value = parse_eight_digits(chars);
+        return true;
+    }
+
+    bool scan_eight_digits(char *, std::uint32_t &, std::false_type) {
+        return false;
+    }
+
+    // Returns false on errors.
+    bool parse_new_line() {
         char ch = input.get();
 
         if (ch == '\r') {
@@ -151,8 +714,11 @@ private:
         }
 
         if (ch != '\n') {
-            throw parser_error_t("Expected new-line", last_char_offset());
+            fail(error_code_t::expected_new_line, "Expected new-line", last_char_offset());
+            return false;
         }
+
+        return true;
     }
 
     void skip_spaces_and_empty_lines() {
@@ -161,9 +727,14 @@ private:
 
             if (input.peek() == '#') {
                 parse_comment();
-                parse_new_line();
+
+                if (!parse_new_line()) {
+                    return;
+                }
             } else if (input.peek() == '\r' || input.peek() == '\n') {
-                parse_new_line();
+                if (!parse_new_line()) {
+                    return;
+                }
             } else {
                 break;
             }
@@ -171,31 +742,78 @@ private:
     }
 
     void parse_expression() {
+        if (parse_expression_start() == step_t::value_pending) {
+            parse_expression_end(value_action);
+        }
+    }
+
+    // Parses an expression up to the value of a key-value pair.
+    // The action returned by the handler for the key is kept in value_action.
+    step_t parse_expression_start() {
         skip_spaces();
 
         if (input.eof()) {
-            return;
+            return step_t::expression;
         } else if (input.peek() == '\r' || input.peek() == '\n') {
-            return;
+            return step_t::expression;
         } else if (input.peek() == '#') {
             parse_comment();
+            return step_t::expression;
         } else if (input.peek() == '[') {
-            parse_table_header();
-            skip_spaces();
-            if (!input.eof() && input.peek() == '#') {
-                parse_comment();
+            action_t action = parse_table_header();
+
+            if (action == action_t::stop) {
+                buffers.stopped = true;
+                return step_t::expression;
             }
+
+            buffers.skip_table = (action == action_t::skip_value);
+            parse_line_end();
+            return step_t::expression;
         } else {
-            parse_kv_pair();
+            value_action = parse_key_and_emit();
+
+            if (value_action == action_t::stop) {
+                buffers.stopped = true;
+                return step_t::expression;
+            }
+
             skip_spaces();
-            if (!input.eof() && input.peek() == '#') {
-                parse_comment();
+            parse_chars("=");
+
+            if (buffers.stopped) {
+                return step_t::expression;
             }
+
+            skip_spaces();
+            return step_t::value_pending;
         }
     }
 
-    void parse_table_header() {
+    void parse_expression_end(action_t action) {
+        if (action == action_t::skip_value) {
+            skip_value();
+        } else {
+            parse_value();
+        }
+
+        if (!buffers.stopped) {
+            parse_line_end();
+        }
+    }
+
+    // Spaces and a comment after a table header or a key-value pair.
+    void parse_line_end() {
+        skip_spaces();
+        if (!input.eof() && input.peek() == '#') {
+            parse_comment();
+        }
+    }
+
+    action_t parse_table_header() {
         assert(input.peek() == '[');
+        std::size_t header_offset = input.processed();
+        scope_t scope(buffers, input, grammar_production_t::table_header);
         input.get();
 
         bool array_item = false;
@@ -205,66 +823,125 @@ private:
             array_item = true;
         }
 
-        std::vector<std::string> path;
+        buffers.path_size = 0;
+
         while (true) {
             skip_spaces();
+            string_view_t key = parse_key();
 
-            path.emplace_back(parse_key());
+            if (buffers.stopped) {
+                return action_t::stop;
+            }
 
+            buffers.push_path_key(key);
             skip_spaces();
 
             if (input.peek() == ']') {
                 input.get();
 
-                if (array_item) {
-                    parse_chars("]");
-                }
+                if (array_item) {
+                    parse_chars("]");
+                }
+
+                break;
+            } else {
+                parse_chars(".");
+            }
+
+            if (buffers.stopped) {
+                return action_t::stop;
+            }
+        }
+
+        if (buffers.stopped) {
+            return action_t::stop;
+        }
+
+        key_iterator_t path_begin = buffers.path.cbegin();
+        key_iterator_t path_end = path_begin + static_cast<std::ptrdiff_t>(buffers.path_size);
+
+        if (buffers.validate_keys) {
+            const char *error = array_item ? buffers.keys.array_table(path_begin, path_end)
+                                           : buffers.keys.table(path_begin, path_end);
 
-                break;
-            } else {
-                parse_chars(".");
+            if (error) {
+                fail(error_code_t::redefinition, error, header_offset);
+                return action_t::stop;
             }
         }
 
         if (array_item) {
-            handler.array_table(path.cbegin(), path.cend());
+            buffers.stats.event(parse_event_t::array_table);
+            return emit.array_table(path_begin, path_end);
         } else {
-            handler.table(path.cbegin(), path.cend());
+            buffers.stats.event(parse_event_t::table);
+            return emit.table(path_begin, path_end);
         }
     }
 
-    void parse_kv_pair() {
-        handler.key(parse_key());
-        skip_spaces();
-        parse_chars("=");
-        skip_spaces();
-        parse_value();
+    action_t parse_key_and_emit() {
+        std::size_t key_offset = input.processed();
+        string_view_t key = parse_key();
+
+        if (buffers.stopped) {
+            return action_t::stop;
+        }
+
+        if (buffers.validate_keys) {
+            const char *error = buffers.keys.key(key);
+
+            if (error) {
+                fail(error_code_t::redefinition, error, key_offset);
+                return action_t::stop;
+            }
+        }
+
+        if (buffers.skip_table) {
+            return action_t::skip_value;
+        }
+
+        buffers.stats.event(parse_event_t::key);
+        return emit.key(key);
     }
 
-    std::string parse_key() {
-        std::string key;
+    // The result is valid until the next call to any of parse_*() methods.
+    string_view_t parse_key() {
+        scope_t scope(buffers, input, grammar_production_t::key);
+
         if (input.peek() == '"') {
             input.get();
-            key = parse_basic_string();
+            string_view_t key = parse_basic_string();
 
-            if (key.empty()) {
-                throw parser_error_t("Expected a non-empty key", last_char_offset());
+            if (!buffers.stopped && key.empty()) {
+                fail(error_code_t::expected_key, "Expected a non-empty key", last_char_offset());
             }
+
+            return key;
         } else {
+            string_view_t key;
+            if (scan_key(key, contiguous_t())) {
+                return key;
+            }
+
             // It must be at least one char.
             char ch = input.get();
             if (!is_key_character(ch)) {
-                throw parser_error_t("Expected a non-empty key", last_char_offset());
+                fail(error_code_t::expected_key, "Expected a non-empty key", last_char_offset());
+                return string_view_t();
             }
 
-            key.push_back(ch);
+            string_buffer.assign(1, ch);
 
             while (is_key_character(input.peek())) {
-                key.push_back(input.get());
+                string_buffer.push_back(input.get());
+            }
+
+            if (input_failed()) {
+                return string_view_t();
             }
-        }
 
-        return key;
+            return string_buffer;
+        }
     }
 
     toml_type_t parse_value() {
@@ -299,27 +976,229 @@ private:
         }
     }
 
+    // Skips a value without decoding it or emitting any events. Only brackets and strings are tracked,
+    // so the value is checked just for matching brackets and terminated strings.
+    void skip_value() {
+        char first = input.peek();
+
+        // A missing value is reported as usual.
+        if (is_value_end(first) || first == ']' || first == '}') {
+            parse_value();
+            return;
+        }
+
+        scope_t scope(buffers, input, grammar_production_t::skipped_value);
+        std::size_t depth = 0;
+        // Bit i is set if the bracket opened at depth i is '{'. Deeper brackets are kept in buffers.brackets.
+        std::uint64_t braces = 0;
+        const std::size_t max_bits_depth = 64;
+
+        buffers.brackets.clear();
+
+        while (true) {
+            char ch = input.peek();
+
+            if (ch == '"') {
+                skip_string();
+            } else if (ch == '\'') {
+                skip_literal_string();
+            } else if (ch == '[' || ch == '{') {
+                input.get();
+
+                if (depth >= max_bits_depth) {
+                    buffers.brackets.push_back(ch);
+                } else if (ch == '{') {
+                    braces |= std::uint64_t(1) << depth;
+                } else {
+                    braces &= ~(std::uint64_t(1) << depth);
+                }
+
+                ++depth;
+            } else if (ch == ']' || ch == '}') {
+                if (depth == 0) {
+                    break;
+                }
+
+                input.get();
+                --depth;
+
+                bool brace = false;
+
+                if (depth >= max_bits_depth) {
+                    brace = buffers.brackets.back() == '{';
+                    buffers.brackets.pop_back();
+                } else {
+                    brace = (braces >> depth) & 1;
+                }
+
+                if (brace != (ch == '}')) {
+                    fail(parser_error_t::unexpected_character(brace ? "}" : "]", last_char_offset()));
+                    return;
+                }
+            } else if (depth == 0 && is_value_end(ch)) {
+                break;
+            } else if (ch == '#') {
+                while (input.peek() != '\n' && !input_failed()) {
+                    input.get();
+                }
+            } else if (ch == '\0' && input_failed()) {
+                return;
+            } else {
+                input.get();
+            }
+
+            if (buffers.stopped) {
+                return;
+            }
+        }
+    }
+
+    static bool is_value_end(char ch) {
+        return ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == ',' || ch == '#';
+    }
+
+    void skip_string() {
+        assert(input.peek() == '"');
+        input.get();
+
+        if (input.peek() != '"') {
+            string_view_t view;
+            if (scan_basic_string(view, contiguous_t())) {
+                return;
+            }
+
+            while (true) {
+                char ch = input.get();
+                if (iscontrol(ch)) {
+                    fail(error_code_t::control_character, "Control characters must be escaped", last_char_offset());
+                    return;
+                } else if (ch == '"') {
+                    return;
+                } else if (ch == '\\') {
+                    std::size_t escape_sequence_offset = last_char_offset();
+                    if (iscontrol(input.get())) {
+                        fail(error_code_t::invalid_escape_sequence, "Invalid escape-sequence", escape_sequence_offset);
+                        return;
+                    }
+                }
+            }
+        }
+
+        input.get();
+
+        if (input.peek() != '"') {
+            return;
+        }
+
+        input.get();
+
+        string_view_t view;
+        if (scan_multiline_string(view, contiguous_t())) {
+            return;
+        }
+
+        while (true) {
+            char ch = input.get();
+            if (ch == '\0' && input_failed()) {
+                return;
+            } else if (ch == '\\') {
+                input.get();
+            } else if (ch == '"' && input.peek() == '"') {
+                input.get();
+                if (input.peek() == '"') {
+                    input.get();
+                    return;
+                }
+            }
+        }
+    }
+
+    void skip_literal_string() {
+        assert(input.peek() == '\'');
+        input.get();
+
+        if (input.peek() != '\'') {
+            string_view_t view;
+            if (scan_literal_string(view, contiguous_t())) {
+                return;
+            }
+
+            while (true) {
+                char ch = input.get();
+                if (iscontrol(ch) && ch != '\t') {
+                    fail(error_code_t::control_character, "Control characters are not allowed", last_char_offset());
+                    return;
+                } else if (ch == '\'') {
+                    return;
+                }
+            }
+        }
+
+        input.get();
+
+        if (input.peek() != '\'') {
+            return;
+        }
+
+        input.get();
+
+        string_view_t view;
+        if (scan_multiline_literal_string(view, contiguous_t())) {
+            return;
+        }
+
+        while (true) {
+            char ch = input.get();
+            if (ch == '\0' && input_failed()) {
+                return;
+            } else if (ch == '\'' && input.peek() == '\'') {
+                input.get();
+                if (input.peek() == '\'') {
+                    input.get();
+                    return;
+                }
+            }
+        }
+    }
+
     void parse_array() {
         assert(input.peek() == '[');
+        scope_t scope(buffers, input, grammar_production_t::array);
         input.get();
+
+        if (buffers.validate_keys) {
+            buffers.keys.start_array();
+        }
+
+        buffers.stats.event(parse_event_t::start_array);
         handler.start_array();
         skip_spaces_and_empty_lines();
 
-        toml_type_t array_type;
+        if (buffers.stopped) {
+            return;
+        }
+
+        // Set by the first item. Initialized only to silence warnings of optimizing compilers.
+        toml_type_t array_type = toml_type_t::array;
         std::size_t size = 0;
 
         while (true) {
             if (input.peek() == ']') {
                 input.get();
-                handler.finish_array(size);
+                finish_array(size);
                 return;
             }
 
             std::size_t item_offset = input.processed();
             toml_type_t current_item_type = parse_value();
 
+            if (buffers.stopped) {
+                return;
+            }
+
             if (size > 0 && current_item_type != array_type) {
-                throw parser_error_t("All array elements must be of the same type", item_offset);
+                fail(error_code_t::mixed_array, "All array elements must be of the same type", item_offset);
+                return;
             }
 
             ++size;
@@ -328,21 +1207,37 @@ private:
             // FIXME: Formal grammar from https://github.com/toml-lang/toml/pull/236 disallows new-lines between values and commas.
             skip_spaces_and_empty_lines();
 
+            if (buffers.stopped) {
+                return;
+            }
+
             char ch = input.get();
             if (ch == ']') {
-                handler.finish_array(size);
+                finish_array(size);
                 return;
             } else if (ch == ',') {
                 skip_spaces_and_empty_lines();
+
+                if (buffers.stopped) {
+                    return;
+                }
             } else {
-                throw parser_error_t("Expected ',' or ']' after an array element", last_char_offset());
+                fail(error_code_t::expected_separator, "Expected ',' or ']' after an array element", last_char_offset());
+                return;
             }
         }
     }
 
     void parse_inline_table() {
         assert(input.peek() == '{');
+        scope_t scope(buffers, input, grammar_production_t::inline_table);
         input.get();
+
+        if (buffers.validate_keys) {
+            buffers.keys.start_inline_table();
+        }
+
+        buffers.stats.event(parse_event_t::start_inline_table);
         handler.start_inline_table();
         std::size_t size = 0;
 
@@ -350,48 +1245,100 @@ private:
 
         if (input.peek() == '}') {
             input.get();
-            handler.finish_inline_table(size);
+            finish_inline_table(size);
             return;
         }
 
         while (true) {
-            handler.key(parse_key());
+            action_t action = parse_key_and_emit();
+
+            if (action == action_t::stop) {
+                buffers.stopped = true;
+                return;
+            }
+
             skip_spaces();
             parse_chars("=");
+
+            if (buffers.stopped) {
+                return;
+            }
+
             skip_spaces();
-            parse_value();
+
+            if (action == action_t::skip_value) {
+                skip_value();
+            } else {
+                parse_value();
+            }
+
+            if (buffers.stopped) {
+                return;
+            }
+
             skip_spaces();
 
             ++size;
 
             char ch = input.get();
             if (ch == '}') {
-                handler.finish_inline_table(size);
+                finish_inline_table(size);
                 return;
             } else if (ch == ',') {
                 skip_spaces();
             } else {
-                throw parser_error_t("Expected ',' or '}' after an inline table element", last_char_offset());
+                fail(error_code_t::expected_separator, "Expected ',' or '}' after an inline table element", last_char_offset());
+                return;
             }
         }
     }
 
+    void finish_array(std::size_t size) {
+        if (buffers.validate_keys) {
+            buffers.keys.finish_array();
+        }
+
+        buffers.stats.event(parse_event_t::finish_array);
+        handler.finish_array(size);
+    }
+
+    void finish_inline_table(std::size_t size) {
+        if (buffers.validate_keys) {
+            buffers.keys.finish_inline_table();
+        }
+
+        buffers.stats.event(parse_event_t::finish_inline_table);
+        handler.finish_inline_table(size);
+    }
+
     void parse_true() {
+        scope_t scope(buffers, input, grammar_production_t::boolean);
         parse_chars("t");
         parse_chars("r");
         parse_chars("u");
         parse_chars("e");
 
+        if (buffers.stopped) {
+            return;
+        }
+
+        buffers.stats.event(parse_event_t::boolean);
         handler.boolean(true);
     }
 
     void parse_false() {
+        scope_t scope(buffers, input, grammar_production_t::boolean);
         parse_chars("f");
         parse_chars("a");
         parse_chars("l");
         parse_chars("s");
         parse_chars("e");
 
+        if (buffers.stopped) {
+            return;
+        }
+
+        buffers.stats.event(parse_event_t::boolean);
         handler.boolean(false);
     }
 
@@ -405,7 +1352,8 @@ private:
         } else if (ch >= 'a' && ch <= 'f') {
             return ch - 'a' + 10;
         } else {
-            throw parser_error_t("Expected hex-digit", last_char_offset());
+            fail(error_code_t::invalid_escape_sequence, "Expected hex-digit", last_char_offset());
+            return 0;
         }
     }
 
@@ -431,13 +1379,19 @@ private:
         return codepoint;
     }
 
-    void process_codepoint(uint32_t codepoint, std::size_t escape_sequence_offset, std::string &output) {
+    void process_codepoint(uint32_t codepoint, std::size_t escape_sequence_offset, string_t &output) {
+        if (buffers.stopped) {
+            return;
+        }
+
         if (codepoint >= 0xD800 && codepoint <= 0xDFFF) {
-            throw parser_error_t("Surrogate pairs are not allowed", escape_sequence_offset);
+            fail(error_code_t::invalid_escape_sequence, "Surrogate pairs are not allowed", escape_sequence_offset);
+            return;
         }
 
         if (codepoint > 0x10FFFF) {
-            throw parser_error_t("Codepoint must be less or equal than 0x10FFFF", escape_sequence_offset);
+            fail(error_code_t::invalid_escape_sequence, "Codepoint must be less or equal than 0x10FFFF", escape_sequence_offset);
+            return;
         }
 
         if (codepoint <= 0x7F) {
@@ -457,13 +1411,20 @@ private:
         }
     }
 
-    std::string parse_basic_string() {
-        std::string result;
+    // The result is valid until the next call to any of parse_*() methods.
+    string_view_t parse_basic_string() {
+        string_view_t view;
+        if (scan_basic_string(view, contiguous_t())) {
+            return view;
+        }
+
+        string_t &result = string_buffer;
 
         while (true) {
             char ch = input.get();
             if (iscontrol(ch)) {
-                throw parser_error_t("Control characters must be escaped", last_char_offset());
+                fail(error_code_t::control_character, "Control characters must be escaped", last_char_offset());
+                return string_view_t();
             } else if (ch == '"') {
                 break;
             } else if (ch == '\\') {
@@ -488,7 +1449,11 @@ private:
                 } else if (ch == 'U') {
                     process_codepoint(parse_8_digit_codepoint(), escape_sequence_offset, result);
                 } else {
-                    throw parser_error_t("Invalid escape-sequence", escape_sequence_offset);
+                    fail(error_code_t::invalid_escape_sequence, "Invalid escape-sequence", escape_sequence_offset);
+                }
+
+                if (buffers.stopped) {
+                    return string_view_t();
                 }
             } else {
                 result.push_back(ch);
@@ -498,24 +1463,34 @@ private:
         return result;
     }
 
-    std::string parse_multiline_string() {
-        std::string result;
-
+    // The result is valid until the next call to any of parse_*() methods.
+    string_view_t parse_multiline_string() {
         // Ignore first new-line after open quotes.
-        if (input.peek() == '\r' || input.peek() == '\n') {
-            parse_new_line();
+        if ((input.peek() == '\r' || input.peek() == '\n') && !parse_new_line()) {
+            return string_view_t();
         }
 
+        string_view_t view;
+        if (scan_multiline_string(view, contiguous_t())) {
+            return view;
+        }
+
+        string_t &result = string_buffer;
+
         while (true) {
             if (input.peek() == '\r' || input.peek() == '\n') {
-                parse_new_line();
+                if (!parse_new_line()) {
+                    return string_view_t();
+                }
+
                 result.push_back('\n');
                 continue;
             }
 
             char ch = input.get();
             if (iscontrol(ch)) {
-                throw parser_error_t("Control characters must be escaped", last_char_offset());
+                fail(error_code_t::control_character, "Control characters must be escaped", last_char_offset());
+                return string_view_t();
             } else if (ch == '"') {
                 if (input.peek() == '"') {
                     input.get();
@@ -528,7 +1503,10 @@ private:
                 result.push_back('"');
             } else if (ch == '\\') {
                 if (input.peek() == '\r' || input.peek() == '\n') {
-                    parse_new_line();
+                    if (!parse_new_line()) {
+                        return string_view_t();
+                    }
+
                     while (std::isspace(input.peek())) {
                         input.get();
                     }
@@ -556,7 +1534,11 @@ private:
                 } else if (ch == 'U') {
                     process_codepoint(parse_8_digit_codepoint(), escape_sequence_offset, result);
                 } else {
-                    throw parser_error_t("Invalid escape-sequence", escape_sequence_offset);
+                    fail(error_code_t::invalid_escape_sequence, "Invalid escape-sequence", escape_sequence_offset);
+                }
+
+                if (buffers.stopped) {
+                    return string_view_t();
                 }
             } else {
                 result.push_back(ch);
@@ -568,6 +1550,7 @@ private:
 
     void parse_string() {
         assert(input.peek() == '"');
+        scope_t scope(buffers, input, grammar_production_t::basic_string);
         input.get();
 
         if (input.peek() == '"') {
@@ -575,17 +1558,27 @@ private:
 
             if (input.peek() == '"') {
                 input.get();
-                handler.string(parse_multiline_string());
-            } else {
-                handler.string("");
+                scope.set(grammar_production_t::multiline_string);
+                string_view_t value = parse_multiline_string();
+
+                if (!buffers.stopped) {
+                    emit_string(value);
+                }
+            } else if (!input_failed()) {
+                emit_string(string_view_t());
             }
         } else {
-            handler.string(parse_basic_string());
+            string_view_t value = parse_basic_string();
+
+            if (!buffers.stopped) {
+                emit_string(value);
+            }
         }
     }
 
     void parse_literal_string() {
         assert(input.peek() == '\'');
+        scope_t scope(buffers, input, grammar_production_t::literal_string);
         input.get();
 
         if (input.peek() == '\'') {
@@ -593,16 +1586,26 @@ private:
 
             if (input.peek() == '\'') {
                 input.get();
+                scope.set(grammar_production_t::multiline_literal_string);
 
                 // Ignore first new-line after open quotes.
-                if (input.peek() == '\r' || input.peek() == '\n') {
-                    parse_new_line();
+                if ((input.peek() == '\r' || input.peek() == '\n') && !parse_new_line()) {
+                    return;
+                }
+
+                string_view_t view;
+                if (scan_multiline_literal_string(view, contiguous_t())) {
+                    emit_string(view);
+                    return;
                 }
 
-                std::string string;
+                string_t &string = string_buffer;
                 while (true) {
                     if (input.peek() == '\r' || input.peek() == '\n') {
-                        parse_new_line();
+                        if (!parse_new_line()) {
+                            return;
+                        }
+
                         string.push_back('\n');
                         continue;
                     }
@@ -613,28 +1616,36 @@ private:
                             input.get();
                             if (input.peek() == '\'') {
                                 input.get();
-                                handler.string(string);
+                                emit_string(string);
                                 return;
                             }
                             string.push_back('\'');
                         }
                         string.push_back('\'');
                     } else if (iscontrol(ch) && ch != '\t') {
-                        throw parser_error_t("Control characters are not allowed", last_char_offset());
+                        fail(error_code_t::control_character, "Control characters are not allowed", last_char_offset());
+                        return;
                     } else {
                         string.push_back(ch);
                     }
                 }
-            } else {
-                handler.string("");
+            } else if (!input_failed()) {
+                emit_string(string_view_t());
             }
         } else {
-            std::string string;
+            string_view_t view;
+            if (scan_literal_string(view, contiguous_t())) {
+                emit_string(view);
+                return;
+            }
+
+            string_t &string = string_buffer;
 
             while (true) {
                 char ch = input.get();
                 if (iscontrol(ch) && ch != '\t') {
-                    throw parser_error_t("Control characters are not allowed", last_char_offset());
+                    fail(error_code_t::control_character, "Control characters are not allowed", last_char_offset());
+                    return;
                 } else if (ch == '\'') {
                     break;
                 }
@@ -642,8 +1653,31 @@ private:
                 string.push_back(ch);
             }
 
-            handler.string(string);
+            emit_string(string);
+        }
+    }
+
+    void emit_string(string_view_t value) {
+        buffers.stats.event(parse_event_t::string);
+        emit.string(value);
+    }
+
+    void emit_datetime(string_view_t value, std::size_t, std::false_type) {
+        buffers.stats.event(parse_event_t::datetime);
+        emit.datetime(value);
+    }
+
+    void emit_datetime(string_view_t value, std::size_t value_offset, std::true_type) {
+        datetime_t fields;
+        std::size_t error_position = 0;
+
+        if (const char *error = decode_datetime(value, fields, error_position)) {
+            fail(error_code_t::invalid_datetime, error, value_offset + error_position);
+            return;
         }
+
+        buffers.stats.event(parse_event_t::datetime);
+        handler.datetime(fields);
     }
 
     char parse_datetime_digit() {
@@ -651,22 +1685,28 @@ private:
         if (std::isdigit(ch)) {
             return ch;
         } else {
-            throw parser_error_t("Bad datetime. Expected digit.", last_char_offset());
+            fail(error_code_t::invalid_datetime, "Bad datetime. Expected digit.", last_char_offset());
+            return '0';
         }
     }
 
     toml_type_t parse_date_or_number() {
-        const std::size_t max_int64_digits = 19;
-        const char *max_int64_string = "9223372036854775807";
-        const char *min_int64_string = "9223372036854775808";
+        // Absolute values of the integer part above these don't fit into a 64-bit integer
+        // or may overflow the accumulator on the next step.
+        const std::uint64_t max_int64_magnitude = 9223372036854775807ull;
+        const std::uint64_t min_int64_magnitude = 9223372036854775808ull;
+        const std::uint64_t max_magnitude_before_digit = 1000000000000000000ull;
+        const std::uint64_t max_magnitude_before_block = 100000000000ull;
 
         const std::size_t max_double_length = 800;
+        // Length of "+HH:MM".
+        const std::size_t max_timezone_length = 6;
 
         std::size_t value_offset = input.processed();
+        scope_t scope(buffers, input, grammar_production_t::integer);
 
-        char buffer[max_double_length + 1];
-        buffer[0] = '+';
-        char *digits = buffer + 1;
+        char digits[max_double_length];
+        bool negative = false;
 
         std::size_t next_index = 0;
 
@@ -701,8 +1741,16 @@ private:
                                 digits[next_index++] = input.get();
                                 digits[next_index++] = parse_datetime_digit();
 
+                                // The fraction may be of any precision. Digits which don't fit into the buffer
+                                // together with the timezone are dropped, nanoseconds need only nine of them.
+                                const std::size_t max_fraction_end = max_double_length - max_timezone_length;
+
                                 while (std::isdigit(input.peek())) {
-                                    digits[next_index++] = input.get();
+                                    char digit = input.get();
+
+                                    if (next_index < max_fraction_end) {
+                                        digits[next_index++] = digit;
+                                    }
                                 }
                             }
 
@@ -717,7 +1765,13 @@ private:
                                 digits[next_index++] = parse_datetime_digit();
                             }
 
-                            handler.datetime(std::string(digits, digits + next_index));
+                            if (buffers.stopped || input_failed()) {
+                                return toml_type_t::datetime;
+                            }
+
+                            scope.set(grammar_production_t::datetime);
+                            emit_datetime(string_view_t(digits, next_index), value_offset,
+                                          typename handler_traits_t<Handler>::structured_datetime_t());
                             return toml_type_t::datetime;
                         }
                     }
@@ -725,23 +1779,54 @@ private:
             }
         } else if (input.peek() == '-') {
             input.get();
-            buffer[0] = '-';
+            negative = true;
         } else if (input.peek() == '+') {
             input.get();
         } else {
             input.get();
-            throw parser_error_t("Unexpected character", last_char_offset());
+            fail(error_code_t::unexpected_character, "Unexpected character", last_char_offset());
+            return toml_type_t::integer;
+        }
+
+        // Absolute value of the integer part is accumulated while the digits are read.
+        // Once it's known not to fit into int64, only the overflow flag is kept.
+        std::uint64_t magnitude = 0;
+        bool overflow = false;
+
+        for (std::size_t i = 0; i < next_index; ++i) {
+            magnitude = 10 * magnitude + static_cast<std::uint64_t>(digits[i] - '0');
         }
 
         bool last_digit = next_index > 0;
         while (true) {
             if (next_index == max_double_length) {
-                throw parser_error_t("Number is too long", last_char_offset());
+                fail(error_code_t::invalid_number, "Number is too long", last_char_offset());
+                return toml_type_t::integer;
             }
 
-            if (std::isdigit(input.peek())) {
-                digits[next_index++] = input.get();
+            std::uint32_t block = 0;
+
+            // The length limit can't be reached inside the block, so the check above behaves as if digits were
+            // read one by one.
+            if (max_double_length - next_index > 8 && scan_eight_digits(digits + next_index, block, contiguous_t())) {
+                next_index += 8;
                 last_digit = true;
+
+                if (magnitude >= max_magnitude_before_block) {
+                    overflow = true;
+                } else {
+                    magnitude = 100000000 * magnitude + block;
+                }
+            } else if (std::isdigit(input.peek())) {
+                char digit = input.get();
+                digits[next_index++] = digit;
+                last_digit = true;
+
+                if (magnitude >= max_magnitude_before_digit) {
+                    overflow = true;
+                } else {
+                    magnitude = 10 * magnitude + static_cast<std::uint64_t>(digit - '0');
+                }
             } else if (last_digit && input.peek() == '_') {
                 input.get();
                 last_digit = false;
@@ -751,42 +1836,36 @@ private:
         }
 
         if (!last_digit) {
-            throw parser_error_t("Unexpected number end", last_char_offset());
+            fail(error_code_t::invalid_number, "Unexpected number end", last_char_offset());
+            return toml_type_t::integer;
         }
 
         if (digits[0] == '0' && next_index > 1) {
-            throw parser_error_t("Leading zeros are not allowed", input.processed() - next_index);
+            fail(error_code_t::invalid_number, "Leading zeros are not allowed", input.processed() - next_index);
+            return toml_type_t::integer;
         }
 
         if (input.peek() != '.' && input.peek() != 'e' && input.peek() != 'E') {
-            if (next_index == max_int64_digits)
-            {
-                if (buffer[0] == '-' && strncmp(digits, min_int64_string, max_int64_digits) > 0) {
-                    throw parser_error_t("The number cannot be represented as 64-bit signed integer",
-                                         value_offset);
-                }
+            if (input_failed()) {
+                return toml_type_t::integer;
+            }
 
-                if (buffer[0] != '-' && strncmp(digits, max_int64_string, max_int64_digits) > 0) {
-                    throw parser_error_t("The number cannot be represented as 64-bit signed integer",
-                                         value_offset);
-                }
-            } else if (next_index > max_int64_digits) {
-                throw parser_error_t("The number cannot be represented as 64-bit signed integer",
-                                     value_offset);
+            if (overflow || magnitude > (negative ? min_int64_magnitude : max_int64_magnitude)) {
+                fail(error_code_t::number_out_of_range, "The number cannot be represented as 64-bit signed integer", value_offset);
+                return toml_type_t::integer;
             }
 
             std::int64_t result = 0;
 
-            if (buffer[0] == '-') {
-                for (auto it = digits; it < digits + next_index; ++it) {
-                    result = 10 * result - (*it - '0');
-                }
+            if (!negative) {
+                result = static_cast<std::int64_t>(magnitude);
+            } else if (magnitude == min_int64_magnitude) {
+                result = std::numeric_limits<std::int64_t>::min();
             } else {
-                for (auto it = digits; it < digits + next_index; ++it) {
-                    result = 10 * result + (*it - '0');
-                }
+                result = -static_cast<std::int64_t>(magnitude);
             }
 
+            buffers.stats.event(parse_event_t::integer);
             handler.integer(result);
             return toml_type_t::integer;
         }
@@ -798,7 +1877,8 @@ private:
             last_digit = false;
             while (true) {
                 if (next_index == max_double_length) {
-                    throw parser_error_t("Number is too long", last_char_offset());
+                    fail(error_code_t::invalid_number, "Number is too long", last_char_offset());
+                    return toml_type_t::floating_point;
                 }
 
                 if (std::isdigit(input.peek())) {
@@ -813,7 +1893,8 @@ private:
             }
 
             if (!last_digit) {
-                throw parser_error_t("Unexpected number end", last_char_offset());
+                fail(error_code_t::invalid_number, "Unexpected number end", last_char_offset());
+                return toml_type_t::floating_point;
             }
         }
 
@@ -830,7 +1911,8 @@ private:
             last_digit = false;
             while (true) {
                 if (next_index == max_double_length) {
-                    throw parser_error_t("Number is too long", last_char_offset());
+                    fail(error_code_t::invalid_number, "Number is too long", last_char_offset());
+                    return toml_type_t::floating_point;
                 }
 
                 if (std::isdigit(input.peek())) {
@@ -846,27 +1928,29 @@ private:
             }
 
             if (!last_digit) {
-                throw parser_error_t("Unexpected number end", last_char_offset());
+                fail(error_code_t::invalid_number, "Unexpected number end", last_char_offset());
+                return toml_type_t::floating_point;
             }
 
             if (exponent_size > 1 && first_digit == '0') {
-                throw parser_error_t("Leading zeros are not allowed in exponent", exponent_start);
+                fail(error_code_t::invalid_number, "Leading zeros are not allowed in exponent", exponent_start);
+                return toml_type_t::floating_point;
             }
         }
 
-        digits[next_index] = '\0';
-        char *end = nullptr;
-        double result = std::strtod(buffer, &end);
-
-        if (end != digits + next_index) {
-            throw parser_error_t("Bad number", value_offset);
+        if (input_failed()) {
+            return toml_type_t::floating_point;
         }
 
-        if (std::isnan(result) || std::isinf(result)) {
-            throw parser_error_t("The number can not be represented as 64-bit floating point number",
-                                 value_offset);
+        double result = decimal_to_double(digits, digits + next_index, negative);
+
+        if (std::isinf(result)) {
+            fail(error_code_t::number_out_of_range, "The number can not be represented as 64-bit floating point number", value_offset);
+            return toml_type_t::floating_point;
         }
 
+        scope.set(grammar_production_t::floating_point);
+        buffers.stats.event(parse_event_t::floating_point);
         handler.floating_point(result);
         return toml_type_t::floating_point;
     }
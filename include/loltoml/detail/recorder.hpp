@@ -0,0 +1,198 @@
+#ifndef LOLTOML_DETAIL_RECORDER_HPP
+#define LOLTOML_DETAIL_RECORDER_HPP
+
+#include "loltoml/datetime.hpp"
+#include "loltoml/detail/arena.hpp"
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/parser.hpp"
+#include "loltoml/error.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <cstdint>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Event recorded by recorder_t.
+struct recorded_event_t {
+    enum type_t : unsigned char {
+        comment,
+        table,
+        array_table,
+        // Item of the path of the preceding table or array_table.
+        path_key,
+        key,
+        start_array,
+        finish_array,
+        start_inline_table,
+        finish_inline_table,
+        boolean,
+        string,
+        datetime,
+        integer,
+        floating_point
+    };
+
+    type_t type;
+    // Size of the string, size of the array or the table, or length of the path.
+    std::size_t size;
+
+    union {
+        const char *string;
+        std::int64_t integer;
+        double floating_point;
+        bool boolean;
+    } value;
+};
+
+
+// Handler storing events, e.g. of a chunk of the document parsed in another thread.
+// Strings pointing into the document are stored as is, the others are copied to the arena.
+class recorder_t {
+public:
+    recorder_t(std::vector<recorded_event_t> &events,
+               arena_t &strings,
+               const char *data,
+               std::size_t size,
+               bool check_datetimes) :
+        m_events(events),
+        m_strings(strings),
+        m_data(data),
+        m_size(size),
+        m_check_datetimes(check_datetimes)
+    { }
+
+    void start_document() { }
+
+    void finish_document() { }
+
+    void comment(string_view_t value) {
+        add_string(recorded_event_t::comment, value);
+    }
+
+    void table(key_iterator_t begin, key_iterator_t end) {
+        add_path(recorded_event_t::table, begin, end);
+    }
+
+    void array_table(key_iterator_t begin, key_iterator_t end) {
+        add_path(recorded_event_t::array_table, begin, end);
+    }
+
+    void key(string_view_t value) {
+        add_string(recorded_event_t::key, value);
+    }
+
+    void start_array() {
+        add(recorded_event_t::start_array, 0);
+    }
+
+    void finish_array(std::size_t size) {
+        add(recorded_event_t::finish_array, size);
+    }
+
+    void start_inline_table() {
+        add(recorded_event_t::start_inline_table, 0);
+    }
+
+    void finish_inline_table(std::size_t size) {
+        add(recorded_event_t::finish_inline_table, size);
+    }
+
+    void boolean(bool value) {
+        add(recorded_event_t::boolean, 0).value.boolean = value;
+    }
+
+    void string(string_view_t value) {
+        add_string(recorded_event_t::string, value);
+    }
+
+    void datetime(string_view_t value) {
+        // Fields are checked only for handlers receiving them, so the chunk fails like the sequential parser would.
+        if (m_check_datetimes) {
+            datetime_t fields;
+            std::size_t error_position = 0;
+
+            if (const char *error = decode_datetime(value, fields, error_position)) {
+                throw parser_error_t(error_code_t::invalid_datetime, error, error_position);
+            }
+        }
+
+        add_string(recorded_event_t::datetime, value);
+    }
+
+    void integer(std::int64_t value) {
+        add(recorded_event_t::integer, 0).value.integer = value;
+    }
+
+    void floating_point(double value) {
+        add(recorded_event_t::floating_point, 0).value.floating_point = value;
+    }
+
+private:
+    recorded_event_t &add(recorded_event_t::type_t type, std::size_t size) {
+        m_events.emplace_back();
+        recorded_event_t &event = m_events.back();
+        event.type = type;
+        event.size = size;
+        return event;
+    }
+
+    void add_string(recorded_event_t::type_t type, string_view_t value) {
+        const char *data = value.data();
+
+        // Views into the document stay valid, others point into the parser's buffers.
+        if (data < m_data || data > m_data + m_size) {
+            data = m_strings.copy_string(value.data(), value.size());
+        }
+
+        add(type, value.size()).value.string = data;
+    }
+
+    void add_path(recorded_event_t::type_t type, key_iterator_t begin, key_iterator_t end) {
+        add(type, static_cast<std::size_t>(end - begin));
+
+        for (; begin != end; ++begin) {
+            add_string(recorded_event_t::path_key, *begin);
+        }
+    }
+
+    std::vector<recorded_event_t> &m_events;
+    arena_t &m_strings;
+    const char *m_data;
+    std::size_t m_size;
+    bool m_check_datetimes;
+};
+
+
+inline string_view_t event_string(const recorded_event_t &event) {
+    return string_view_t(event.value.string, event.size);
+}
+
+
+// Returns the position right after the events of the value starting at the given event.
+template<class Iterator>
+Iterator skip_recorded_value(Iterator it) {
+    std::size_t depth = 0;
+
+    do {
+        if (it->type == recorded_event_t::start_array || it->type == recorded_event_t::start_inline_table) {
+            ++depth;
+        } else if (it->type == recorded_event_t::finish_array || it->type == recorded_event_t::finish_inline_table) {
+            --depth;
+        }
+
+        ++it;
+    } while (depth > 0);
+
+    return it;
+}
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_RECORDER_HPP
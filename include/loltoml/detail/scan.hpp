@@ -0,0 +1,189 @@
+#ifndef LOLTOML_DETAIL_SCAN_HPP
+#define LOLTOML_DETAIL_SCAN_HPP
+
+#include "loltoml/detail/common.hpp"
+
+// Scanning of strings and comments is vectorized on x86 with SSE2 and, if the CPU supports it, AVX2.
+// Define LOLTOML_DISABLE_SIMD to use the portable implementation only.
+#if !defined(LOLTOML_DISABLE_SIMD) && \
+    (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define LOLTOML_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define LOLTOML_X86_SIMD 0
+#endif
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+inline bool iscontrol(char ch) {
+    return static_cast<unsigned char>(ch) < 32;
+}
+
+
+inline bool is_key_character(char ch) {
+    return (ch >= 'a' && ch <= 'z') ||
+           (ch >= 'A' && ch <= 'Z') ||
+           (ch >= '0' && ch <= '9') ||
+           ch == '-' ||
+           ch == '_';
+}
+
+
+// A character is special if it's equal to Stop1 or Stop2 or if it's a control character
+// except '\t' and '\n' when they're allowed.
+template<char Stop1, char Stop2, bool AllowTab, bool AllowNewLine>
+inline bool is_special(char ch) {
+    return ch == Stop1 ||
+           ch == Stop2 ||
+           (iscontrol(ch) && !(AllowTab && ch == '\t') && !(AllowNewLine && ch == '\n'));
+}
+
+
+#if LOLTOML_X86_SIMD
+
+inline bool has_avx2() {
+    static const bool result = (__builtin_cpu_init(), __builtin_cpu_supports("avx2") != 0);
+    return result;
+}
+
+// Returns pointer to the first special character or to the first of the last (end - begin) % 16 characters.
+template<char Stop1, char Stop2, bool AllowTab, bool AllowNewLine>
+inline const char *find_special_sse2(const char *begin, const char *end) {
+    const __m128i stop1 = _mm_set1_epi8(Stop1);
+    const __m128i stop2 = _mm_set1_epi8(Stop2);
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i new_line = _mm_set1_epi8('\n');
+    const __m128i max_control = _mm_set1_epi8(31);
+
+    for (; end - begin >= 16; begin += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+
+        // Unsigned comparison chunk <= 31.
+        __m128i special = _mm_cmpeq_epi8(_mm_max_epu8(chunk, max_control), max_control);
+
+        if (AllowTab) {
+            special = _mm_andnot_si128(_mm_cmpeq_epi8(chunk, tab), special);
+        }
+
+        if (AllowNewLine) {
+            special = _mm_andnot_si128(_mm_cmpeq_epi8(chunk, new_line), special);
+        }
+
+        special = _mm_or_si128(special, _mm_cmpeq_epi8(chunk, stop1));
+        special = _mm_or_si128(special, _mm_cmpeq_epi8(chunk, stop2));
+
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(special));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return begin;
+}
+
+// Same as find_special_sse2() but processes 32 bytes at a time. Must be called only if has_avx2() is true.
+template<char Stop1, char Stop2, bool AllowTab, bool AllowNewLine>
+__attribute__((target("avx2")))
+inline const char *find_special_avx2(const char *begin, const char *end) {
+    const __m256i stop1 = _mm256_set1_epi8(Stop1);
+    const __m256i stop2 = _mm256_set1_epi8(Stop2);
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i new_line = _mm256_set1_epi8('\n');
+    const __m256i max_control = _mm256_set1_epi8(31);
+
+    for (; end - begin >= 32; begin += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+
+        __m256i special = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, max_control), max_control);
+
+        if (AllowTab) {
+            special = _mm256_andnot_si256(_mm256_cmpeq_epi8(chunk, tab), special);
+        }
+
+        if (AllowNewLine) {
+            special = _mm256_andnot_si256(_mm256_cmpeq_epi8(chunk, new_line), special);
+        }
+
+        special = _mm256_or_si256(special, _mm256_cmpeq_epi8(chunk, stop1));
+        special = _mm256_or_si256(special, _mm256_cmpeq_epi8(chunk, stop2));
+
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(special));
+        if (mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+    }
+
+    return begin;
+}
+
+#endif // LOLTOML_X86_SIMD
+
+
+// Returns pointer to the first special character in [begin, end) or end.
+template<char Stop1, char Stop2, bool AllowTab, bool AllowNewLine>
+inline const char *find_special(const char *begin, const char *end) {
+#if LOLTOML_X86_SIMD
+    if (end - begin >= 32 && has_avx2()) {
+        begin = find_special_avx2<Stop1, Stop2, AllowTab, AllowNewLine>(begin, end);
+    }
+
+    if (end - begin >= 16) {
+        begin = find_special_sse2<Stop1, Stop2, AllowTab, AllowNewLine>(begin, end);
+    }
+#endif
+
+    while (begin != end && !is_special<Stop1, Stop2, AllowTab, AllowNewLine>(*begin)) {
+        ++begin;
+    }
+
+    return begin;
+}
+
+
+// The following functions are used by the parser on contiguous inputs to skip ordinary characters in bulk.
+// Each of them returns pointer to the first character in [begin, end) which needs special handling or end.
+
+inline const char *scan_key(const char *begin, const char *end) {
+    while (begin != end && is_key_character(*begin)) {
+        ++begin;
+    }
+
+    return begin;
+}
+
+// Stops at quotes, backslashes and control characters.
+inline const char *scan_basic_string(const char *begin, const char *end) {
+    return find_special<'"', '\\', false, false>(begin, end);
+}
+
+// Stops at quotes, backslashes and control characters except '\n'.
+inline const char *scan_multiline_string(const char *begin, const char *end) {
+    return find_special<'"', '\\', false, true>(begin, end);
+}
+
+// Stops at apostrophes and control characters except '\t'.
+inline const char *scan_literal_string(const char *begin, const char *end) {
+    return find_special<'\'', '\'', true, false>(begin, end);
+}
+
+// Stops at apostrophes and control characters except '\t' and '\n'.
+inline const char *scan_multiline_literal_string(const char *begin, const char *end) {
+    return find_special<'\'', '\'', true, true>(begin, end);
+}
+
+// Stops at control characters except '\t'.
+inline const char *scan_comment(const char *begin, const char *end) {
+    // '\0' is a control character anyway.
+    return find_special<'\0', '\0', true, false>(begin, end);
+}
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_SCAN_HPP
@@ -0,0 +1,194 @@
+#ifndef LOLTOML_DETAIL_STATEMENT_SCANNER_HPP
+#define LOLTOML_DETAIL_STATEMENT_SCANNER_HPP
+
+#include "loltoml/detail/common.hpp"
+
+#include <cstddef>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Finds new-lines ending top-level expressions in a document coming in arbitrary pieces.
+//
+// A new-line ends an expression if it's not inside a string, a comment or brackets.
+// The parser never reads past such new-line before it finishes the expression, so the document may be parsed
+// in parts split at them. For invalid documents the scanner may miss some of the boundaries (e.g. after
+// an unbalanced '['), which only makes the parts longer, but it never reports a boundary
+// the parser would go past.
+class statement_scanner_t {
+public:
+    enum : std::size_t {
+        npos = static_cast<std::size_t>(-1)
+    };
+
+    statement_scanner_t() {
+        reset();
+    }
+
+    void reset() {
+        m_state = normal;
+        m_depth = 0;
+    }
+
+    // Continues scanning from where the previous call stopped.
+    // Returns the position right after the last boundary new-line in the data or npos if there is none.
+    std::size_t scan(const char *data, std::size_t size) {
+        std::size_t result = npos;
+
+        for (std::size_t i = 0; i < size; ++i) {
+            char ch = data[i];
+
+            switch (m_state) {
+                case normal: {
+                    if (ch == '\n') {
+                        if (m_depth == 0) {
+                            result = i + 1;
+                        }
+                    } else if (ch == '#') {
+                        m_state = comment;
+                    } else if (ch == '"') {
+                        m_state = basic_quote1;
+                    } else if (ch == '\'') {
+                        m_state = literal_quote1;
+                    } else if (ch == '[') {
+                        ++m_depth;
+                    } else if (ch == ']' && m_depth > 0) {
+                        --m_depth;
+                    }
+                } break;
+                case comment: {
+                    if (ch == '\n') {
+                        m_state = normal;
+                        --i;
+                    }
+                } break;
+                case basic_quote1: {
+                    if (ch == '"') {
+                        m_state = basic_quote2;
+                    } else {
+                        m_state = basic;
+                        --i;
+                    }
+                } break;
+                case basic_quote2: {
+                    // Either """ or an empty string.
+                    if (ch == '"') {
+                        m_state = multiline_basic;
+                    } else {
+                        m_state = normal;
+                        --i;
+                    }
+                } break;
+                case basic: {
+                    if (ch == '\\') {
+                        m_state = basic_escape;
+                    } else if (ch == '"') {
+                        m_state = normal;
+                    } else if (ch == '\n') {
+                        // The parser fails on it.
+                        m_state = normal;
+                        --i;
+                    }
+                } break;
+                case basic_escape: {
+                    m_state = basic;
+                } break;
+                case multiline_basic: {
+                    if (ch == '\\') {
+                        m_state = multiline_basic_escape;
+                    } else if (ch == '"') {
+                        m_state = multiline_basic_quote1;
+                    }
+                } break;
+                case multiline_basic_escape: {
+                    m_state = multiline_basic;
+                } break;
+                case multiline_basic_quote1: {
+                    if (ch == '"') {
+                        m_state = multiline_basic_quote2;
+                    } else {
+                        m_state = multiline_basic;
+                        --i;
+                    }
+                } break;
+                case multiline_basic_quote2: {
+                    if (ch == '"') {
+                        m_state = normal;
+                    } else {
+                        m_state = multiline_basic;
+                        --i;
+                    }
+                } break;
+                case literal_quote1: {
+                    if (ch == '\'') {
+                        m_state = literal_quote2;
+                    } else {
+                        m_state = literal;
+                        --i;
+                    }
+                } break;
+                case literal_quote2: {
+                    if (ch == '\'') {
+                        m_state = multiline_literal;
+                    } else {
+                        m_state = normal;
+                        --i;
+                    }
+                } break;
+                case literal: {
+                    if (ch == '\'') {
+                        m_state = normal;
+                    } else if (ch == '\n') {
+                        m_state = normal;
+                        --i;
+                    }
+                } break;
+                case multiline_literal: {
+                    if (ch == '\'') {
+                        m_state = multiline_literal_quote1;
+                    }
+                } break;
+                case multiline_literal_quote1: {
+                    m_state = (ch == '\'') ? multiline_literal_quote2 : multiline_literal;
+                } break;
+                case multiline_literal_quote2: {
+                    m_state = (ch == '\'') ? normal : multiline_literal;
+                } break;
+            }
+        }
+
+        return result;
+    }
+
+private:
+    enum state_t {
+        normal,
+        comment,
+        basic_quote1,
+        basic_quote2,
+        basic,
+        basic_escape,
+        multiline_basic,
+        multiline_basic_escape,
+        multiline_basic_quote1,
+        multiline_basic_quote2,
+        literal_quote1,
+        literal_quote2,
+        literal,
+        multiline_literal,
+        multiline_literal_quote1,
+        multiline_literal_quote2
+    };
+
+    state_t m_state;
+    std::size_t m_depth;
+};
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_STATEMENT_SCANNER_HPP
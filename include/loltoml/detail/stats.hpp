@@ -0,0 +1,96 @@
+#ifndef LOLTOML_DETAIL_STATS_HPP
+#define LOLTOML_DETAIL_STATS_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/stats.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Passes the parser's counters to parse_stats_t. All the methods do nothing unless LOLTOML_ENABLE_STATS is defined,
+// and enabled() is then constant false, so the code computing the arguments is thrown away too.
+// The members don't depend on the macro to keep the layout of parser_buffers_t the same.
+class stats_recorder_t {
+public:
+    // Scratch buffers whose growth is counted.
+    enum : std::size_t {
+        buffers_count = 5
+    };
+
+    stats_recorder_t() :
+        m_stats(nullptr),
+        m_baseline(true)
+    {
+        std::fill(m_capacities, m_capacities + buffers_count, std::size_t(0));
+    }
+
+    // The stats may be nullptr to stop recording.
+    void attach(parse_stats_t *stats) {
+        m_stats = stats;
+        m_baseline = true;
+    }
+
+    parse_stats_t *stats() const {
+        return m_stats;
+    }
+
+    bool enabled() const {
+#if LOLTOML_STATS_ENABLED
+        return m_stats != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    void event(parse_event_t event) {
+        if (enabled()) {
+            ++m_stats->events[static_cast<std::size_t>(event)];
+        }
+    }
+
+    void production(grammar_production_t production, std::size_t bytes) {
+        if (enabled()) {
+            m_stats->bytes[static_cast<std::size_t>(production)] += bytes;
+        }
+    }
+
+    // Takes the current capacities of the buffers in bytes. Every grown buffer counts as one allocation
+    // of its new capacity. The first call after attach() only remembers the memory kept from the previous runs.
+    void scratch(const std::size_t (&capacities)[buffers_count]) {
+        if (!enabled()) {
+            return;
+        }
+
+        std::size_t total = 0;
+
+        for (std::size_t i = 0; i < buffers_count; ++i) {
+            if (!m_baseline && capacities[i] > m_capacities[i]) {
+                ++m_stats->allocations;
+                m_stats->allocated_bytes += capacities[i];
+            }
+
+            m_capacities[i] = capacities[i];
+            total += capacities[i];
+        }
+
+        m_baseline = false;
+        m_stats->peak_scratch_size = std::max(m_stats->peak_scratch_size, total);
+    }
+
+private:
+    parse_stats_t *m_stats;
+    bool m_baseline;
+    std::size_t m_capacities[buffers_count];
+};
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DETAIL_STATS_HPP
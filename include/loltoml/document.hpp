@@ -0,0 +1,672 @@
+#ifndef LOLTOML_DOCUMENT_HPP
+#define LOLTOML_DOCUMENT_HPP
+
+#include "loltoml/detail/arena.hpp"
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/interner.hpp"
+#include "loltoml/detail/parser.hpp"
+#include "loltoml/error.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+
+enum class value_type_t {
+    string,
+    integer,
+    floating_point,
+    boolean,
+    datetime,
+    array,
+    table
+};
+
+
+class value_t;
+struct table_member_t;
+
+namespace detail {
+    class document_builder_t;
+
+    // Slot of the hash index of a large table. The index is stored right after the members of the table
+    // and has twice as many slots as the table has capacity for members.
+    struct member_slot_t {
+        enum : std::uint32_t {
+            empty = 0xffffffffu
+        };
+
+        std::uint32_t hash;
+        std::uint32_t member;
+    };
+
+    // Tables with less capacity are searched linearly.
+    enum : std::size_t {
+        min_indexed_capacity = 16
+    };
+}
+
+
+//! Elements of an array value. It's a lightweight view into the document.
+class array_t {
+public:
+    typedef const value_t *const_iterator;
+    typedef const_iterator iterator;
+
+    array_t(const value_t *items, std::size_t size) :
+        m_items(items),
+        m_size(size)
+    { }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    const_iterator begin() const {
+        return m_items;
+    }
+
+    inline const_iterator end() const;
+
+    inline const value_t &operator[](std::size_t index) const;
+
+private:
+    const value_t *m_items;
+    std::size_t m_size;
+};
+
+
+//! Members of a table value in order of their definition. It's a lightweight view into the document.
+//! find() in large tables goes through a hash index instead of scanning the members.
+class table_t {
+public:
+    typedef const table_member_t *const_iterator;
+    typedef const_iterator iterator;
+
+    table_t(const table_member_t *members, std::size_t size) :
+        m_members(members),
+        m_size(size),
+        m_index(nullptr),
+        m_index_size(0)
+    { }
+
+    //! View of a table having a hash index of its members. index_size must be a power of two.
+    table_t(const table_member_t *members,
+            std::size_t size,
+            const detail::member_slot_t *index,
+            std::size_t index_size) :
+        m_members(members),
+        m_size(size),
+        m_index(index),
+        m_index_size(index_size)
+    { }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    const_iterator begin() const {
+        return m_members;
+    }
+
+    inline const_iterator end() const;
+
+    //! \returns Value of the key or nullptr if there is no such key in the table.
+    inline const value_t *find(string_view_t key) const;
+
+private:
+    const table_member_t *m_members;
+    std::size_t m_size;
+    const detail::member_slot_t *m_index;
+    std::size_t m_index_size;
+};
+
+
+/*! A node of the document.
+ *
+ * Strings (including keys and datetimes) and child nodes are stored in the memory of the document,
+ * so values are valid until the document is destroyed, cleared or parses another input.
+ * Accessors of a wrong type are not allowed.
+ */
+class value_t {
+public:
+    value_type_t type() const {
+        return m_type;
+    }
+
+    bool is_string() const {
+        return m_type == value_type_t::string;
+    }
+
+    bool is_integer() const {
+        return m_type == value_type_t::integer;
+    }
+
+    bool is_floating_point() const {
+        return m_type == value_type_t::floating_point;
+    }
+
+    bool is_boolean() const {
+        return m_type == value_type_t::boolean;
+    }
+
+    bool is_datetime() const {
+        return m_type == value_type_t::datetime;
+    }
+
+    bool is_array() const {
+        return m_type == value_type_t::array;
+    }
+
+    bool is_table() const {
+        return m_type == value_type_t::table;
+    }
+
+    string_view_t as_string() const {
+        assert(is_string());
+        return string_view_t(m_data.string, m_size);
+    }
+
+    std::int64_t as_integer() const {
+        assert(is_integer());
+        return m_data.integer;
+    }
+
+    double as_floating_point() const {
+        assert(is_floating_point());
+        return m_data.floating_point;
+    }
+
+    bool as_boolean() const {
+        assert(is_boolean());
+        return m_data.boolean;
+    }
+
+    //! \returns Datetime as it's written in the document.
+    string_view_t as_datetime() const {
+        assert(is_datetime());
+        return string_view_t(m_data.string, m_size);
+    }
+
+    array_t as_array() const {
+        assert(is_array());
+        return array_t(m_data.items, m_size);
+    }
+
+    inline table_t as_table() const;
+
+private:
+    friend class detail::document_builder_t;
+
+    enum flags_t {
+        // Table was defined by a [table] header.
+        defined_table = 1,
+        // Table was defined as an inline table. It cannot be extended.
+        inline_table = 2,
+        // Array was created by [[array table]] headers. Others cannot be extended.
+        array_of_tables = 4
+    };
+
+    value_type_t m_type;
+    unsigned char m_flags;
+    std::size_t m_size;
+    std::size_t m_capacity;
+
+    union {
+        const char *string;
+        std::int64_t integer;
+        double floating_point;
+        bool boolean;
+        value_t *items;
+        table_member_t *members;
+    } m_data;
+};
+
+
+struct table_member_t {
+    string_view_t key;
+    value_t value;
+};
+
+
+inline array_t::const_iterator array_t::end() const {
+    return m_items + m_size;
+}
+
+inline const value_t &array_t::operator[](std::size_t index) const {
+    assert(index < m_size);
+    return m_items[index];
+}
+
+inline table_t::const_iterator table_t::end() const {
+    return m_members + m_size;
+}
+
+inline const value_t *table_t::find(string_view_t key) const {
+    if (m_index) {
+        const std::uint32_t hash = detail::hash_string(key);
+        const std::size_t mask = m_index_size - 1;
+
+        for (std::size_t i = hash & mask; ; i = (i + 1) & mask) {
+            const detail::member_slot_t &slot = m_index[i];
+
+            if (slot.member == detail::member_slot_t::empty) {
+                return nullptr;
+            } else if (slot.hash == hash && m_members[slot.member].key == key) {
+                return &m_members[slot.member].value;
+            }
+        }
+    }
+
+    for (const table_member_t *it = m_members; it != m_members + m_size; ++it) {
+        if (it->key == key) {
+            return &it->value;
+        }
+    }
+
+    return nullptr;
+}
+
+inline table_t value_t::as_table() const {
+    assert(is_table());
+
+    if (m_capacity >= detail::min_indexed_capacity) {
+        const detail::member_slot_t *index = reinterpret_cast<const detail::member_slot_t *>(m_data.members + m_capacity);
+        return table_t(m_data.members, m_size, index, 2 * m_capacity);
+    }
+
+    return table_t(m_data.members, m_size);
+}
+
+
+namespace detail {
+
+
+// SAX handler building the document.
+// Redefinitions of keys and tables must be rejected by the parser (see parser_buffers_t::validate_keys).
+class document_builder_t {
+public:
+    document_builder_t(arena_t &arena, value_t &root, std::vector<value_t *> &stack) :
+        m_arena(arena),
+        m_root(root),
+        m_stack(stack),
+        m_pending(nullptr)
+    { }
+
+    void start_document() {
+        init_table(m_root, 0);
+        m_stack.assign(1, &m_root);
+    }
+
+    void finish_document() { }
+
+    void comment(string_view_t) { }
+
+    void array_table(key_iterator_t begin, key_iterator_t end) {
+        assert(begin != end);
+
+        value_t *table = walk_path(begin, end - 1);
+        value_t *array = find(*table, *(end - 1));
+
+        if (!array) {
+            array = &append_member(*table, *(end - 1));
+            init_array(*array, value_t::array_of_tables);
+        }
+
+        assert(array->is_array() && (array->m_flags & value_t::array_of_tables));
+
+        value_t &item = append_item(*array);
+        init_table(item, value_t::defined_table);
+        m_stack.assign(1, &item);
+    }
+
+    void table(key_iterator_t begin, key_iterator_t end) {
+        assert(begin != end);
+
+        value_t *parent = walk_path(begin, end - 1);
+        value_t *table = find(*parent, *(end - 1));
+
+        if (!table) {
+            table = &append_member(*parent, *(end - 1));
+            init_table(*table, value_t::defined_table);
+        } else {
+            assert(table->is_table() && !(table->m_flags & (value_t::defined_table | value_t::inline_table)));
+            table->m_flags |= value_t::defined_table;
+        }
+
+        m_stack.assign(1, table);
+    }
+
+    void key(string_view_t key) {
+        m_pending = &append_member(*m_stack.back(), key);
+    }
+
+    void start_array() {
+        init_array(next_value(), 0);
+        m_stack.push_back(m_pending);
+    }
+
+    void finish_array(std::size_t) {
+        m_stack.pop_back();
+    }
+
+    void start_inline_table() {
+        init_table(next_value(), value_t::inline_table);
+        m_stack.push_back(m_pending);
+    }
+
+    void finish_inline_table(std::size_t) {
+        m_stack.pop_back();
+    }
+
+    void boolean(bool value) {
+        value_t &result = next_value();
+        result.m_type = value_type_t::boolean;
+        result.m_data.boolean = value;
+    }
+
+    void string(string_view_t value) {
+        init_string(next_value(), value_type_t::string, value);
+    }
+
+    void datetime(string_view_t value) {
+        init_string(next_value(), value_type_t::datetime, value);
+    }
+
+    void integer(std::int64_t value) {
+        value_t &result = next_value();
+        result.m_type = value_type_t::integer;
+        result.m_data.integer = value;
+    }
+
+    void floating_point(double value) {
+        value_t &result = next_value();
+        result.m_type = value_type_t::floating_point;
+        result.m_data.floating_point = value;
+    }
+
+private:
+    static void init_table(value_t &value, unsigned char flags) {
+        value.m_type = value_type_t::table;
+        value.m_flags = flags;
+        value.m_size = 0;
+        value.m_capacity = 0;
+        value.m_data.members = nullptr;
+    }
+
+    static void init_array(value_t &value, unsigned char flags) {
+        value.m_type = value_type_t::array;
+        value.m_flags = flags;
+        value.m_size = 0;
+        value.m_capacity = 0;
+        value.m_data.items = nullptr;
+    }
+
+    void init_string(value_t &value, value_type_t type, string_view_t string) {
+        value.m_type = type;
+        value.m_flags = 0;
+        value.m_size = string.size();
+        value.m_data.string = m_arena.copy_string(string.data(), string.size());
+    }
+
+    static value_t *find(value_t &table, string_view_t key) {
+        return const_cast<value_t *>(table.as_table().find(key));
+    }
+
+    static member_slot_t *index_of(value_t &table) {
+        return reinterpret_cast<member_slot_t *>(table.m_data.members + table.m_capacity);
+    }
+
+    static void insert_slot(member_slot_t *index, std::size_t index_size, std::uint32_t hash, std::uint32_t member) {
+        const std::size_t mask = index_size - 1;
+        std::size_t i = hash & mask;
+
+        while (index[i].member != member_slot_t::empty) {
+            i = (i + 1) & mask;
+        }
+
+        index[i].hash = hash;
+        index[i].member = member;
+    }
+
+    // Storage of containers grows geometrically inside the arena. The old storage is just abandoned.
+    template<class T>
+    T *grow(T *items, std::size_t size, std::size_t &capacity) {
+        if (size < capacity) {
+            return items;
+        }
+
+        capacity = (capacity == 0) ? 4 : capacity * 2;
+        T *result = m_arena.allocate_array<T>(capacity);
+
+        if (size > 0) {
+            std::memcpy(static_cast<void *>(result), items, sizeof(T) * size);
+        }
+
+        return result;
+    }
+
+    // Large tables keep a hash index of their members after the members, so the index is reallocated with them.
+    void grow_members(value_t &table) {
+        if (table.m_size < table.m_capacity) {
+            return;
+        }
+
+        const std::size_t capacity = (table.m_capacity == 0) ? 4 : table.m_capacity * 2;
+
+        if (capacity < min_indexed_capacity) {
+            table.m_data.members = grow(table.m_data.members, table.m_size, table.m_capacity);
+            return;
+        }
+
+        const std::size_t index_size = 2 * capacity;
+        void *memory = m_arena.allocate(sizeof(table_member_t) * capacity + sizeof(member_slot_t) * index_size,
+                                        alignof(table_member_t));
+        table_member_t *members = static_cast<table_member_t *>(memory);
+        member_slot_t *index = reinterpret_cast<member_slot_t *>(members + capacity);
+
+        for (std::size_t i = 0; i < index_size; ++i) {
+            index[i].member = member_slot_t::empty;
+        }
+
+        if (table.m_size > 0) {
+            std::memcpy(static_cast<void *>(members), table.m_data.members, sizeof(table_member_t) * table.m_size);
+        }
+
+        if (table.m_capacity >= min_indexed_capacity) {
+            const member_slot_t *old_index = index_of(table);
+
+            for (std::size_t i = 0; i < 2 * table.m_capacity; ++i) {
+                if (old_index[i].member != member_slot_t::empty) {
+                    insert_slot(index, index_size, old_index[i].hash, old_index[i].member);
+                }
+            }
+        } else {
+            for (std::size_t i = 0; i < table.m_size; ++i) {
+                insert_slot(index, index_size, hash_string(members[i].key), static_cast<std::uint32_t>(i));
+            }
+        }
+
+        table.m_data.members = members;
+        table.m_capacity = capacity;
+    }
+
+    value_t &append_member(value_t &table, string_view_t key) {
+        grow_members(table);
+
+        if (table.m_capacity >= min_indexed_capacity) {
+            insert_slot(index_of(table), 2 * table.m_capacity, hash_string(key), static_cast<std::uint32_t>(table.m_size));
+        }
+
+        table_member_t *member = new (&table.m_data.members[table.m_size++]) table_member_t;
+        member->key = string_view_t(m_arena.copy_string(key.data(), key.size()), key.size());
+        return member->value;
+    }
+
+    value_t &append_item(value_t &array) {
+        array.m_data.items = grow(array.m_data.items, array.m_size, array.m_capacity);
+        return *new (&array.m_data.items[array.m_size++]) value_t;
+    }
+
+    // Returns slot for the next value: either value of the last key or a new array item.
+    value_t &next_value() {
+        value_t &parent = *m_stack.back();
+
+        if (parent.is_array()) {
+            m_pending = &append_item(parent);
+        }
+
+        assert(m_pending);
+        return *m_pending;
+    }
+
+    // Finds or creates the table which [begin, end) keys point to.
+    value_t *walk_path(key_iterator_t begin, key_iterator_t end) {
+        value_t *current = &m_root;
+
+        for (; begin != end; ++begin) {
+            value_t *next = find(*current, *begin);
+
+            if (!next) {
+                next = &append_member(*current, *begin);
+                init_table(*next, 0);
+            } else if (next->is_array()) {
+                assert((next->m_flags & value_t::array_of_tables) && next->m_size > 0);
+                next = &next->m_data.items[next->m_size - 1];
+            }
+
+            assert(next->is_table() && !(next->m_flags & value_t::inline_table));
+
+            current = next;
+        }
+
+        return current;
+    }
+
+    arena_t &m_arena;
+    value_t &m_root;
+    std::vector<value_t *> &m_stack;
+    value_t *m_pending;
+};
+
+
+} // namespace detail
+
+
+/*! DOM representation of a TOML document.
+ *
+ * All the nodes and strings are allocated from an arena owned by the document,
+ * so building of the document takes few allocations and destroying it is cheap.
+ * Unlike loltoml::parse(), it always checks that keys and tables are not redefined.
+ */
+class document_t {
+public:
+    document_t() {
+        m_buffers.validate_keys = true;
+        clear();
+    }
+
+    document_t(document_t &&other) :
+        m_arena(std::move(other.m_arena)),
+        m_root(other.m_root),
+        m_stack(std::move(other.m_stack)),
+        m_buffers(std::move(other.m_buffers))
+    {
+        other.clear();
+    }
+
+    document_t &operator=(document_t &&other) {
+        if (this != &other) {
+            m_arena = std::move(other.m_arena);
+            m_root = other.m_root;
+            m_stack = std::move(other.m_stack);
+            m_buffers = std::move(other.m_buffers);
+            other.clear();
+        }
+
+        return *this;
+    }
+
+    //! \returns The root table.
+    const value_t &root() const {
+        return m_root;
+    }
+
+    //! Removes all the values. Memory of the document is kept for reuse.
+    void clear() {
+        m_arena.clear();
+
+        detail::document_builder_t builder(m_arena, m_root, m_stack);
+        builder.start_document();
+    }
+
+    /*! Replace content of the document with the document from the stream.
+     *
+     * \throws loltoml::parser_error_t if the input contains an invalid TOML document or just cannot be read.
+     * \throws loltoml::stream_error_t if input.bad() becomes true.
+     */
+    void parse(std::istream &input) {
+        detail::input_stream_t stream(input);
+        parse_input(stream);
+    }
+
+    /*! Replace content of the document with the document from the buffer.
+     *
+     * \throws loltoml::parser_error_t if the buffer contains an invalid TOML document.
+     */
+    void parse(const char *data, std::size_t size) {
+        m_arena.clear();
+        // Strings and nodes take about as much memory as the input.
+        m_arena.reserve(size);
+
+        detail::input_buffer_t buffer(data, size);
+        parse_input(buffer);
+    }
+
+    //! Same as parse(input.data(), input.size()).
+    void parse(string_view_t input) {
+        parse(input.data(), input.size());
+    }
+
+private:
+    document_t(const document_t &);
+    document_t &operator=(const document_t &);
+
+    template<class Input>
+    void parse_input(Input &input) {
+        clear();
+
+        try {
+            detail::document_builder_t builder(m_arena, m_root, m_stack);
+            detail::parser_t<Input, detail::document_builder_t> parser(input, builder, m_buffers);
+            parser.parse();
+        } catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    detail::arena_t m_arena;
+    value_t m_root;
+    std::vector<value_t *> m_stack;
+    detail::parser_buffers_t m_buffers;
+};
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_DOCUMENT_HPP
@@ -3,12 +3,83 @@
 
 #include "loltoml/detail/common.hpp"
 
+#include <cctype>
 #include <exception>
 #include <string>
 
 LOLTOML_OPEN_NAMESPACE
 
 
+//! Kinds of errors in TOML documents. The message of an error gives the details.
+enum class error_code_t {
+    //! No error.
+    none,
+    //! Errors coming from outside the parser, e.g. values not matching the struct in loltoml::parse_into().
+    other,
+    //! The input has ended in the middle of a token.
+    unexpected_eof,
+    //! The input stream has failed. Such errors are reported by loltoml::stream_error_t.
+    stream_error,
+    //! A character not allowed at the position, e.g. a missing '=' after a key.
+    unexpected_character,
+    //! Something after the end of a table header or a key-value pair.
+    expected_new_line,
+    //! An empty key.
+    expected_key,
+    //! A missing ',' or closing bracket after an item of an array or an inline table.
+    expected_separator,
+    //! A control character not allowed in a string or a comment.
+    control_character,
+    //! An unknown escape-sequence or an invalid unicode codepoint.
+    invalid_escape_sequence,
+    //! A malformed integer or float.
+    invalid_number,
+    //! An integer not fitting into int64 or a float not fitting into double.
+    number_out_of_range,
+    //! A malformed datetime or a datetime with fields out of range.
+    invalid_datetime,
+    //! Items of an array have different types.
+    mixed_array,
+    //! A key or a table is defined twice (only if key validation is enabled).
+    redefinition
+};
+
+
+namespace detail {
+
+
+inline std::string escape_char(char ch) {
+    if (ch == '\\') {
+        return "\\\\";
+    } else if (ch == '\'') {
+        return "\\\'";
+    } else if (ch == '\"') {
+        return "\\\"";
+    } else if (ch == '\b') {
+        return "\\b";
+    } else if (ch == '\t') {
+        return "\\t";
+    } else if (ch == '\r') {
+        return "\\r";
+    } else if (ch == '\n') {
+        return "\\n";
+    } else if (std::isprint(ch)) {
+        return std::string(1, ch);
+    } else {
+        const char *hex_digits = "0123456789abcdef";
+        char result[5] = "\\xYY";
+
+        result[2] = hex_digits[static_cast<unsigned char>(ch) / 16];
+        result[3] = hex_digits[static_cast<unsigned char>(ch) % 16];
+
+        return result;
+    }
+}
+
+
+} // namespace detail
+
+
 //! Parser throws it if the input stream contains invalid TOML document.
 class parser_error_t :
     public std::exception
@@ -20,18 +91,71 @@ public:
      * \throws std::bad_alloc
      */
     parser_error_t(std::string message, std::size_t offset) :
+        m_code(error_code_t::other),
+        m_static_message(nullptr),
+        m_expected(nullptr),
         m_message(std::move(message)),
         m_offset(offset)
     { }
 
+    /*! Error with a message which doesn't need to be copied. The parser throws such errors without allocating memory.
+     *
+     * \param[in] message Message describing the error. It must be a string with static storage duration.
+     * \param[in] offset Position of the error in the input stream.
+     */
+    parser_error_t(error_code_t code, const char *message, std::size_t offset) :
+        m_code(code),
+        m_static_message(message),
+        m_expected(nullptr),
+        m_offset(offset)
+    { }
+
+    //! The same error found at another offset, e.g. in a part of a larger document.
+    parser_error_t(const parser_error_t &error, std::size_t offset) :
+        parser_error_t(error)
+    {
+        m_offset = offset;
+    }
+
+    /*! Error of an unexpected character.
+     *
+     * The message listing the expected characters is built only when it's requested.
+     *
+     * \param[in] expected The expected characters. It must be a string with static storage duration.
+     */
+    static parser_error_t unexpected_character(const char *expected, std::size_t offset) {
+        parser_error_t result(error_code_t::unexpected_character, nullptr, offset);
+        result.m_expected = expected;
+        return result;
+    }
+
     virtual ~parser_error_t() throw() { }
 
     virtual const char *what() const throw() {
         return "loltoml parser error";
     }
 
-    //! \returns Message describing the error.
+    error_code_t code() const {
+        return m_code;
+    }
+
+    /*! \returns Message describing the error.
+     *  \throws std::bad_alloc if the message has to be built.
+     */
     const char *message() const {
+        if (m_static_message) {
+            return m_static_message;
+        }
+
+        if (m_expected && m_message.empty()) {
+            m_message = "Expected one of the following symbols: ";
+
+            for (const char *it = m_expected; *it != '\0'; ++it) {
+                m_message += (it == m_expected) ? "\'" : ", \'";
+                m_message += detail::escape_char(*it) + "\'";
+            }
+        }
+
         return m_message.c_str();
     }
 
@@ -41,7 +165,11 @@ public:
     }
 
 private:
-    std::string m_message;
+    error_code_t m_code;
+    const char *m_static_message;
+    const char *m_expected;
+    // Built lazily for errors of unexpected characters.
+    mutable std::string m_message;
     std::size_t m_offset;
 };
 
@@ -52,10 +180,9 @@ class stream_error_t :
 public:
     /*!
      * \param[in] processed Number of bytes processed before the error occured.
-     * \throws std::bad_alloc
      */
     stream_error_t(std::size_t processed) :
-        parser_error_t("Unable to read data from the stream", processed)
+        parser_error_t(error_code_t::stream_error, "Unable to read data from the stream", processed)
     { }
 
     virtual ~stream_error_t() throw() { }
@@ -66,6 +193,75 @@ public:
 };
 
 
+/*! Description of an error reported by the non-throwing overloads of loltoml::parse().
+ *
+ * code is error_code_t::none if the document has been parsed successfully.
+ */
+class error_info_t {
+public:
+    error_code_t code;
+    //! Position of the error in the input in bytes.
+    std::size_t offset;
+    //! Line of the error starting from 1, or 0 if the input was a stream.
+    std::size_t line;
+    //! Column of the error in bytes starting from 1, or 0 if the input was a stream.
+    std::size_t column;
+
+    error_info_t() :
+        code(error_code_t::none),
+        offset(0),
+        line(0),
+        column(0),
+        m_error(error_code_t::none, "", 0)
+    { }
+
+    explicit operator bool() const {
+        return code != error_code_t::none;
+    }
+
+    /*! \returns Message describing the error, the same as loltoml::parser_error_t::message() would return.
+     *  \throws std::bad_alloc if the message has to be built.
+     */
+    const char *message() const {
+        return m_error.message();
+    }
+
+    //! Stores the error. Line and column are left zero.
+    void assign(const parser_error_t &error) {
+        m_error = error;
+        code = error.code();
+        offset = error.offset();
+        line = 0;
+        column = 0;
+    }
+
+    //! Stores the error found in the document and computes its line and column.
+    void assign(const parser_error_t &error, const char *document, std::size_t size) {
+        assign(error);
+
+        std::size_t end = (offset < size) ? offset : size;
+        std::size_t line_start = 0;
+        line = 1;
+
+        for (std::size_t i = 0; i < end; ++i) {
+            if (document[i] == '\n') {
+                ++line;
+                line_start = i + 1;
+            }
+        }
+
+        column = offset - line_start + 1;
+    }
+
+    void clear() {
+        *this = error_info_t();
+    }
+
+private:
+    parser_error_t m_error;
+};
+
+
 LOLTOML_CLOSE_NAMESPACE
 
 #endif // LOLTOML_ERROR_HPP
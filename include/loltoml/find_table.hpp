@@ -0,0 +1,129 @@
+#ifndef LOLTOML_FIND_TABLE_HPP
+#define LOLTOML_FIND_TABLE_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/header_scanner.hpp"
+#include "loltoml/detail/parser.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <initializer_list>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Handler reading just the first table header of the input and comparing its path with the wanted one.
+template<class PathIterator>
+class header_matcher_t :
+    public header_reader_t
+{
+public:
+    header_matcher_t(PathIterator path_begin, PathIterator path_end) :
+        m_path_begin(path_begin),
+        m_path_end(path_end)
+    { }
+
+    // The header is a [table] header with the wanted path.
+    bool matched() const {
+        if (array_table()) {
+            return false;
+        }
+
+        PathIterator expected = m_path_begin;
+        auto it = path().begin();
+
+        for (; it != path().end() && expected != m_path_end; ++it, ++expected) {
+            if (string_view_t(*it) != string_view_t(*expected)) {
+                return false;
+            }
+        }
+
+        return it == path().end() && expected == m_path_end;
+    }
+
+private:
+    PathIterator m_path_begin;
+    PathIterator m_path_end;
+};
+
+
+} // namespace detail
+
+
+/*! Parse a single table of a TOML document stored in memory.
+ *
+ * It finds the [table] header with the given path and feeds the handler with start_document(), table(),
+ * the content of the table and finish_document(), as loltoml::parse() would do for a document consisting of
+ * just this table. Header lines are found by a fast scan which only tracks strings, comments and brackets
+ * (as loltoml::section_index_t does), and only the headers preceding the table are parsed. The rest of
+ * the document isn't parsed at all (and isn't checked for errors).
+ *
+ * Only [table] headers are matched, not [[array tables]] or tables defined by headers of their subtables
+ * (e.g. [a.b.c] defines [a.b] implicitly). Subtables of the table have their own headers and aren't included.
+ * If the table isn't found, the handler receives just start_document() and finish_document().
+ *
+ * The handler may also stop the parser or skip values as with loltoml::parse().
+ *
+ * \code
+ * const char *path[] = {"service", name};
+ * loltoml::find_table(document.data(), document.size(), path, path + 2, handler);
+ * \endcode
+ *
+ * \tparam PathIterator Iterator over the keys of the path. They must be convertible to loltoml::string_view_t.
+ * \tparam Handler Type of the handler. See loltoml::parse() for the requirements.
+ * \param[in] data Pointer to the document. It must be utf-8 encoded.
+ * \param[in] size Size of the document in bytes.
+ * \param[in] path_begin, path_end Keys of the table header.
+ * \param[out] handler Parser will feed SAX-events of the table to this object.
+ * \returns true if the table has been found.
+ * \throws loltoml::parser_error_t if a header before the table or the table itself is invalid.
+ */
+template<class PathIterator, class Handler>
+inline bool find_table(const char *data,
+                       std::size_t size,
+                       PathIterator path_begin,
+                       PathIterator path_end,
+                       Handler &handler)
+{
+    std::vector<std::size_t> headers;
+    detail::find_all_header_lines(data, size, headers);
+
+    detail::parser_buffers_t buffers;
+    detail::header_matcher_t<PathIterator> matcher(path_begin, path_end);
+
+    for (std::size_t i = 0; i < headers.size(); ++i) {
+        std::size_t end = (i + 1 < headers.size()) ? headers[i + 1] : size;
+
+        detail::parse_range(data, headers[i], end, matcher, buffers);
+
+        if (matcher.matched()) {
+            detail::parse_range(data, headers[i], end, handler, buffers);
+            return true;
+        }
+    }
+
+    handler.start_document();
+    handler.finish_document();
+    return false;
+}
+
+
+/*! Parse a single table of a TOML document stored in memory.
+ *
+ * Same as find_table(document.data(), document.size(), path.begin(), path.end(), handler).
+ *
+ * \code
+ * loltoml::find_table(document, {"service", name}, handler);
+ * \endcode
+ */
+template<class Handler>
+inline bool find_table(string_view_t document, std::initializer_list<string_view_t> path, Handler &handler) {
+    return find_table(document.data(), document.size(), path.begin(), path.end(), handler);
+}
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_FIND_TABLE_HPP
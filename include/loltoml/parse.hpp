@@ -1,8 +1,14 @@
 #ifndef LOLTOML_PARSE_HPP
 #define LOLTOML_PARSE_HPP
 
+#include "loltoml/action.hpp"
+#include "loltoml/datetime.hpp"
 #include "loltoml/detail/common.hpp"
 #include "loltoml/detail/parser.hpp"
+#include "loltoml/error.hpp"
+#include "loltoml/stats.hpp"
+#include "loltoml/string_view.hpp"
+#include "loltoml/symbol_table.hpp"
 
 LOLTOML_OPEN_NAMESPACE
 
@@ -14,6 +20,19 @@ LOLTOML_OPEN_NAMESPACE
 typedef detail::key_iterator_t key_iterator_t;
 
 
+/*! Type of strings passed to handlers by parsers using the Allocator, see parse(const char *, std::size_t, Handler &, const Allocator &).
+ *
+ * It's std::string for std::allocator.
+ */
+template<class Allocator>
+using basic_parser_string_t = typename detail::basic_parser_buffers_t<Allocator>::string_t;
+
+
+//! Type of iterators passed to table() and array_table() by parsers using the Allocator. It "points" to a basic_parser_string_t.
+template<class Allocator>
+using basic_key_iterator_t = typename detail::basic_parser_buffers_t<Allocator>::key_iterator_t;
+
+
 /*! Parse a TOML document.
  *
  * This function reads a TOML document from the input stream and
@@ -22,7 +41,7 @@ typedef detail::key_iterator_t key_iterator_t;
  * as specified in https://github.com/toml-lang/toml/tree/v0.4.0
  * The only exceptions are:
  * - Though the spec states that a valid TOML document is utf-8 encoded, the parser doesn't validate encoding at the time.
- * - Since it's a SAX-style parser, it cannot track uniqueness of keys in tables.
+ * - It doesn't track uniqueness of keys in tables. Use loltoml::parser_t::set_key_validation() to enable the check.
  *
  * The handler must have the following methods:
  * - void start_document() - called at the start of parsing
@@ -47,16 +66,220 @@ typedef detail::key_iterator_t key_iterator_t;
  * - void integer(std::int64_t value) - handles an integer value.
  * - void floating_point(double value) - handles a float value.
  *
+ * Methods key(), string(), comment() and datetime() may accept loltoml::string_view_t instead of std::string.
+ * It's detected at compile time separately for each method.
+ * When parsing from a buffer, such methods receive views pointing directly into the input
+ * unless the token contains escape-sequences, line-continuations or "\r\n" new-lines.
+ * Otherwise the view points into an internal buffer. In any case the view is valid only until the method returns.
+ *
+ * Method datetime() may also accept decoded fields: datetime(const loltoml::datetime_t &).
+ * For such handlers the parser also checks ranges of the fields (e.g. month must be 1-12)
+ * and throws loltoml::parser_error_t if they're invalid. See loltoml::to_time_point() to convert the value.
+ *
+ * Methods key(), table() and array_table() may return loltoml::action_t instead of void:
+ * - action_t::skip_value returned from key() makes the parser skip the value of the key without emitting any events
+ *     for it. Skipped values are only scanned for brackets and quotes, so strings aren't unescaped, numbers aren't
+ *     converted, and the value is checked just for balanced brackets and terminated strings.
+ *     It works for keys inside inline tables as well.
+ * - action_t::skip_value returned from table() or array_table() skips the whole content of the table
+ *     (key-value pairs and comments) up to the next table header the same way.
+ * - action_t::stop stops the parser right away without reading the rest of the input and calling finish_document().
+ *     Unlike throwing an exception from the handler, it's cheap.
+ *
+ * Methods key(), table() and array_table() may also accept interned keys: key(const loltoml::symbol_t &)
+ * and table(loltoml::symbol_iterator_t, loltoml::symbol_iterator_t) (same for array_table()).
+ * Symbols are taken from the table set by loltoml::parser_t::set_symbol_table(),
+ * otherwise from a private table living as long as the parser.
+ *
  * \tparam Handler Type of the handler.
  * \param[in, out] input Stream containing a TOML document. It must be utf-8 encoded.
  * \param[out] handler Parser will feed SAX-events to this object.
+ * \returns false if the handler has stopped the parser, true otherwise.
  * \throws loltoml::parser_error_t if the input contains an invalid TOML document or just cannot be read.
  * \throws loltoml::stream_error_t if input.bad() becomes true.
  */
 template<class Handler>
-inline void parse(std::istream &input, Handler &handler) {
-    detail::parser_t<Handler> parser(input, handler);
-    parser.parse();
+inline bool parse(std::istream &input, Handler &handler) {
+    detail::input_stream_t stream(input);
+    detail::parser_buffers_t buffers;
+    detail::parser_t<detail::input_stream_t, Handler> parser(stream, handler, buffers);
+    return parser.parse();
+}
+
+
+/*! Parse a TOML document stored in memory.
+ *
+ * Works exactly like parse(std::istream &, Handler &), but reads characters directly from the buffer,
+ * which is much faster than going through std::istream.
+ * Offsets in the errors are offsets from the start of the buffer.
+ *
+ * \tparam Handler Type of the handler.
+ * \param[in] data Pointer to the document. It must be utf-8 encoded.
+ * \param[in] size Size of the document in bytes.
+ * \param[out] handler Parser will feed SAX-events to this object.
+ * \returns false if the handler has stopped the parser, true otherwise.
+ * \throws loltoml::parser_error_t if the buffer contains an invalid TOML document.
+ */
+template<class Handler>
+inline bool parse(const char *data, std::size_t size, Handler &handler) {
+    detail::input_buffer_t buffer(data, size);
+    detail::parser_buffers_t buffers;
+    detail::parser_t<detail::input_buffer_t, Handler> parser(buffer, handler, buffers);
+    return parser.parse();
+}
+
+
+/*! Parse a TOML document stored in memory.
+ *
+ * Same as parse(input.data(), input.size(), handler).
+ */
+template<class Handler>
+inline bool parse(string_view_t input, Handler &handler) {
+    return parse(input.data(), input.size(), handler);
+}
+
+
+/*! Parse a TOML document from the stream reporting errors through the error info instead of exceptions.
+ *
+ * Works exactly like parse(std::istream &, Handler &), but if the document is invalid or the stream fails,
+ * the error is stored to the error info and the function returns false. Line and column of the error are not known.
+ * Errors found by the parser are recorded without throwing exceptions, so rejecting a document is cheap.
+ * Exceptions thrown by the handler other than loltoml::parser_error_t are passed to the caller.
+ *
+ * \param[out] error Cleared at the start. Its code is error_code_t::none unless there was an error.
+ * \returns true if the whole document has been parsed, false on errors and if the handler has stopped the parser.
+ */
+template<class Handler>
+inline bool parse(std::istream &input, Handler &handler, error_info_t &error) {
+    error.clear();
+
+    detail::input_stream_t stream(input);
+    detail::parser_buffers_t buffers;
+    detail::parser_t<detail::input_stream_t, Handler> parser(stream, handler, buffers);
+
+    try {
+        if (parser.try_parse()) {
+            return true;
+        }
+    } catch (const parser_error_t &e) {
+        // Only the handler throws here.
+        error.assign(e);
+        return false;
+    }
+
+    if (buffers.failed) {
+        error.assign(buffers.error);
+    }
+
+    return false;
+}
+
+
+/*! Parse a TOML document stored in memory reporting errors through the error info instead of exceptions.
+ *
+ * Works like parse(std::istream &, Handler &, error_info_t &), and also sets line and column of the error.
+ * The parser doesn't format error messages while failing. The message is built only when
+ * error_info_t::message() is called, which keeps rejecting invalid documents cheap.
+ */
+template<class Handler>
+inline bool parse(const char *data, std::size_t size, Handler &handler, error_info_t &error) {
+    error.clear();
+
+    detail::input_buffer_t buffer(data, size);
+    detail::parser_buffers_t buffers;
+    detail::parser_t<detail::input_buffer_t, Handler> parser(buffer, handler, buffers);
+
+    try {
+        if (parser.try_parse()) {
+            return true;
+        }
+    } catch (const parser_error_t &e) {
+        // Only the handler throws here.
+        error.assign(e, data, size);
+        return false;
+    }
+
+    if (buffers.failed) {
+        error.assign(buffers.error, data, size);
+    }
+
+    return false;
+}
+
+
+//! Same as parse(input.data(), input.size(), handler, error).
+template<class Handler>
+inline bool parse(string_view_t input, Handler &handler, error_info_t &error) {
+    return parse(input.data(), input.size(), handler, error);
+}
+
+
+/*! Parse a TOML document from the stream using the allocator for the memory of the parser.
+ *
+ * Works exactly like parse(std::istream &, Handler &), but keys of table headers and strings which can't be passed
+ * to the handler as views are stored in memory taken from the allocator (rebound to the needed types).
+ * Handler methods not accepting loltoml::string_view_t receive loltoml::basic_parser_string_t<Allocator>
+ * instead of std::string, and table() and array_table() receive loltoml::basic_key_iterator_t<Allocator>.
+ * Key validation and symbol tables still use the default allocator.
+ *
+ * \tparam Allocator An allocator satisfying the standard Allocator requirements.
+ */
+template<class Handler, class Allocator>
+inline bool parse(std::istream &input, Handler &handler, const Allocator &allocator) {
+    detail::input_stream_t stream(input);
+    detail::basic_parser_buffers_t<Allocator> buffers(allocator);
+    detail::parser_t<detail::input_stream_t, Handler, Allocator> parser(stream, handler, buffers);
+    return parser.parse();
+}
+
+
+/*! Parse a TOML document stored in memory using the allocator for the memory of the parser.
+ *
+ * Works like parse(std::istream &, Handler &, const Allocator &), but reads the buffer directly.
+ */
+template<class Handler, class Allocator>
+inline bool parse(const char *data, std::size_t size, Handler &handler, const Allocator &allocator) {
+    detail::input_buffer_t buffer(data, size);
+    detail::basic_parser_buffers_t<Allocator> buffers(allocator);
+    detail::parser_t<detail::input_buffer_t, Handler, Allocator> parser(buffer, handler, buffers);
+    return parser.parse();
+}
+
+
+/*! Parse a TOML document from the stream and collect the stats of the parser.
+ *
+ * Works exactly like parse(std::istream &, Handler &) and adds the counters of this run to the stats
+ * (also when it throws). The stats are filled only if LOLTOML_ENABLE_STATS is defined, see loltoml::parse_stats_t.
+ */
+template<class Handler>
+inline bool parse(std::istream &input, Handler &handler, parse_stats_t &stats) {
+    detail::input_stream_t stream(input);
+    detail::parser_buffers_t buffers;
+    buffers.stats.attach(&stats);
+    detail::parser_t<detail::input_stream_t, Handler> parser(stream, handler, buffers);
+    return parser.parse();
+}
+
+
+/*! Parse a TOML document stored in memory and collect the stats of the parser.
+ *
+ * Works exactly like parse(const char *, std::size_t, Handler &) and adds the counters of this run to the stats
+ * (also when it throws). The stats are filled only if LOLTOML_ENABLE_STATS is defined, see loltoml::parse_stats_t.
+ */
+template<class Handler>
+inline bool parse(const char *data, std::size_t size, Handler &handler, parse_stats_t &stats) {
+    detail::input_buffer_t buffer(data, size);
+    detail::parser_buffers_t buffers;
+    buffers.stats.attach(&stats);
+    detail::parser_t<detail::input_buffer_t, Handler> parser(buffer, handler, buffers);
+    return parser.parse();
+}
+
+
+//! Same as parse(input.data(), input.size(), handler, stats).
+template<class Handler>
+inline bool parse(string_view_t input, Handler &handler, parse_stats_t &stats) {
+    return parse(input.data(), input.size(), handler, stats);
 }
 
 
@@ -0,0 +1,43 @@
+#ifndef LOLTOML_PARSE_FILE_HPP
+#define LOLTOML_PARSE_FILE_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/mapped_file.hpp"
+#include "loltoml/parse.hpp"
+
+#include <string>
+
+LOLTOML_OPEN_NAMESPACE
+
+
+/*! Parse a TOML document from a file.
+ *
+ * Regular files are mapped into memory and parsed in place without any copying.
+ * Other files (pipes, character devices, files in procfs) are read into memory first.
+ * Offsets in the errors are offsets from the start of the file.
+ * It's available on POSIX systems only.
+ *
+ * \tparam Handler Type of the handler. See loltoml::parse() for the requirements.
+ * \param[in] path Path to the file. The file must be utf-8 encoded.
+ * \param[out] handler Parser will feed SAX-events to this object.
+ * \returns false if the handler has stopped the parser, true otherwise.
+ * \throws std::system_error if the file cannot be opened or read. Its code() is the errno of the failed call.
+ * \throws loltoml::parser_error_t if the file contains an invalid TOML document.
+ */
+template<class Handler>
+inline bool parse_file(const char *path, Handler &handler) {
+    detail::mapped_file_t file(path);
+    return parse(file.data(), file.size(), handler);
+}
+
+
+//! Same as parse_file(path.c_str(), handler).
+template<class Handler>
+inline bool parse_file(const std::string &path, Handler &handler) {
+    return parse_file(path.c_str(), handler);
+}
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_PARSE_FILE_HPP
@@ -0,0 +1,215 @@
+#ifndef LOLTOML_PARSER_HPP
+#define LOLTOML_PARSER_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/parallel.hpp"
+#include "loltoml/detail/parser.hpp"
+#include "loltoml/error.hpp"
+#include "loltoml/parse.hpp"
+#include "loltoml/stats.hpp"
+#include "loltoml/string_view.hpp"
+#include "loltoml/symbol_table.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+LOLTOML_OPEN_NAMESPACE
+
+
+/*! Reusable TOML parser.
+ *
+ * It's equivalent to loltoml::parse(), but keeps its internal buffers (keys of table headers, strings)
+ * between runs, so parsing of many similar documents doesn't reallocate them every time.
+ * See loltoml::parse() for the requirements to the handler.
+ *
+ * \tparam Handler Type of the handler.
+ * \tparam Allocator Allocator of the buffers. Handlers of parsers with a custom allocator receive
+ *     loltoml::basic_parser_string_t<Allocator> instead of std::string,
+ *     see parse(const char *, std::size_t, Handler &, const Allocator &).
+ */
+template<class Handler, class Allocator = std::allocator<char>>
+class parser_t {
+public:
+    /*! \param[out] handler Parser will feed SAX-events to this object. It must outlive the parser.
+     *  \param[in] allocator The buffers are allocated by copies of it.
+     */
+    explicit parser_t(Handler &handler, const Allocator &allocator = Allocator()) :
+        m_handler(handler),
+        m_buffers(allocator)
+    { }
+
+    Handler &handler() const {
+        return m_handler;
+    }
+
+    /*! Parse a TOML document from the stream.
+     *
+     * \returns false if the handler has stopped the parser.
+     * \throws loltoml::parser_error_t if the input contains an invalid TOML document or just cannot be read.
+     * \throws loltoml::stream_error_t if input.bad() becomes true.
+     */
+    bool parse(std::istream &input) {
+        detail::input_stream_t stream(input);
+        detail::parser_t<detail::input_stream_t, Handler, Allocator> parser(stream, m_handler, m_buffers);
+        return parser.parse();
+    }
+
+    /*! Parse a TOML document stored in memory.
+     *
+     * \returns false if the handler has stopped the parser.
+     * \throws loltoml::parser_error_t if the buffer contains an invalid TOML document.
+     */
+    bool parse(const char *data, std::size_t size) {
+        detail::input_buffer_t buffer(data, size);
+        detail::parser_t<detail::input_buffer_t, Handler, Allocator> parser(buffer, m_handler, m_buffers);
+        return parser.parse();
+    }
+
+    //! Same as parse(input.data(), input.size()).
+    bool parse(string_view_t input) {
+        return parse(input.data(), input.size());
+    }
+
+    /*! Parse a TOML document from the stream reporting errors through the error info instead of exceptions.
+     *
+     * See loltoml::parse(std::istream &, Handler &, error_info_t &).
+     */
+    bool parse(std::istream &input, error_info_t &error) {
+        error.clear();
+
+        detail::input_stream_t stream(input);
+        detail::parser_t<detail::input_stream_t, Handler, Allocator> parser(stream, m_handler, m_buffers);
+
+        try {
+            if (parser.try_parse()) {
+                return true;
+            }
+        } catch (const parser_error_t &e) {
+            // Only the handler throws here.
+            error.assign(e);
+            return false;
+        }
+
+        if (m_buffers.failed) {
+            error.assign(m_buffers.error);
+        }
+
+        return false;
+    }
+
+    /*! Parse a TOML document stored in memory reporting errors through the error info instead of exceptions.
+     *
+     * See loltoml::parse(const char *, std::size_t, Handler &, error_info_t &).
+     */
+    bool parse(const char *data, std::size_t size, error_info_t &error) {
+        error.clear();
+
+        detail::input_buffer_t buffer(data, size);
+        detail::parser_t<detail::input_buffer_t, Handler, Allocator> parser(buffer, m_handler, m_buffers);
+
+        try {
+            if (parser.try_parse()) {
+                return true;
+            }
+        } catch (const parser_error_t &e) {
+            // Only the handler throws here.
+            error.assign(e, data, size);
+            return false;
+        }
+
+        if (m_buffers.failed) {
+            error.assign(m_buffers.error, data, size);
+        }
+
+        return false;
+    }
+
+    //! Same as parse(input.data(), input.size(), error).
+    bool parse(string_view_t input, error_info_t &error) {
+        return parse(input.data(), input.size(), error);
+    }
+
+    /*! Parse a large TOML document stored in memory using several threads.
+     *
+     * The document is split at lines starting with top-level [table] or [[array table]] headers,
+     * the parts are parsed concurrently and then the events are passed to the handler in order of the document.
+     * So the handler is called from the current thread only and sees the same events as with parse(data, size).
+     * If the document is invalid, it's parsed again sequentially to report the error
+     * (and feed the events preceding it to the handler) exactly as parse() does.
+     * Small documents and documents without headers are parsed sequentially.
+     * Programs using this method must be linked with the threads library (e.g. with -pthread).
+     *
+     * Actions returned by the handler are applied to the events, but the skipped parts of the document
+     * are still parsed by the other threads. The threads use the default allocator for their own buffers.
+     *
+     * \param[in] threads Maximum number of threads including the current one. 0 means the number of CPUs.
+     * \returns false if the handler has stopped the parser.
+     * \throws loltoml::parser_error_t if the buffer contains an invalid TOML document.
+     */
+    bool parse_parallel(const char *data, std::size_t size, std::size_t threads = 0) {
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+
+        // A few parts per thread to balance the load, but not too small to keep the overhead low.
+        std::size_t min_chunk_size = std::max<std::size_t>(size / (threads * 4 + 1), 64 * 1024);
+        return detail::parse_parallel(data, size, m_handler, m_buffers, threads, min_chunk_size);
+    }
+
+    //! Same as parse_parallel(input.data(), input.size(), threads).
+    bool parse_parallel(string_view_t input, std::size_t threads = 0) {
+        return parse_parallel(input.data(), input.size(), threads);
+    }
+
+    /*! Enable or disable checking of keys uniqueness. It's disabled by default.
+     *
+     * If enabled, the parser throws loltoml::parser_error_t when a key is assigned twice in the same table
+     * or a table is redefined (e.g. [a] appears twice, or [a] follows "a = 1").
+     * The check takes constant time on average per key, but it makes the parser remember all the keys of the document.
+     */
+    void set_key_validation(bool enabled) {
+        m_buffers.validate_keys = enabled;
+    }
+
+    bool key_validation() const {
+        return m_buffers.validate_keys;
+    }
+
+    /*! Use the symbols table for handlers accepting loltoml::symbol_t.
+     *
+     * The table may be shared by many parsers running in different threads.
+     * Keys are cached by the parser, so the shared table is locked only when the parser meets a key for the first time.
+     *
+     * \param[in] symbols The table. It must outlive the parser.
+     */
+    void set_symbol_table(symbol_table_t &symbols) {
+        m_buffers.symbols.set_table(&symbols);
+    }
+
+    /*! Collect the stats of the following runs of parse().
+     *
+     * The counters of every run are added to the stats. They are filled only if LOLTOML_ENABLE_STATS is defined,
+     * see loltoml::parse_stats_t. parse_parallel() fills them only when it parses the document sequentially.
+     *
+     * \param[out] stats The stats. It must outlive the parser or be detached by set_stats(nullptr).
+     */
+    void set_stats(parse_stats_t *stats) {
+        m_buffers.stats.attach(stats);
+    }
+
+    //! Forgets everything left from the previous runs but keeps the allocated memory.
+    void reset() {
+        m_buffers.clear();
+    }
+
+private:
+    Handler &m_handler;
+    detail::basic_parser_buffers_t<Allocator> m_buffers;
+};
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_PARSER_HPP
@@ -0,0 +1,289 @@
+#ifndef LOLTOML_READER_HPP
+#define LOLTOML_READER_HPP
+
+#include "loltoml/action.hpp"
+#include "loltoml/detail/arena.hpp"
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/input_buffer.hpp"
+#include "loltoml/detail/parser.hpp"
+#include "loltoml/detail/recorder.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+
+//! Events returned by loltoml::reader_t::next(). They correspond to the methods of handlers of loltoml::parse().
+enum class event_type_t {
+    start_document,
+    finish_document,
+    comment,
+    table,
+    array_table,
+    key,
+    start_array,
+    finish_array,
+    start_inline_table,
+    finish_inline_table,
+    boolean,
+    string,
+    datetime,
+    integer,
+    floating_point,
+    //! Returned after finish_document.
+    end
+};
+
+
+/*! Pull parser of a TOML document stored in memory.
+ *
+ * Instead of calling a handler, it returns the events one by one from next().
+ * The document is parsed lazily: next() parses the next top-level expression (a key-value pair, a table header
+ * or a comment) only when the events of the previous one are exhausted. So the reader may be abandoned
+ * at any point without parsing the rest of the document.
+ * Values of top-level key-value pairs are parsed only when the event after the key is requested,
+ * so skip_value() can fast-forward over them without decoding.
+ * The events and the errors are the same as with loltoml::parse(document, handler).
+ *
+ * \code
+ * loltoml::reader_t reader(document);
+ *
+ * while (reader.next() != loltoml::event_type_t::end) {
+ *     if (reader.event() == loltoml::event_type_t::key && reader.string() == "name") {
+ *         reader.next();
+ *         ...
+ *     }
+ * }
+ * \endcode
+ */
+class reader_t {
+public:
+    /*!
+     * \param[in] data Pointer to the document. It must be utf-8 encoded and outlive the reader.
+     * \param[in] size Size of the document in bytes.
+     */
+    reader_t(const char *data, std::size_t size) :
+        m_input(data, size),
+        m_recorder(m_events, m_strings, data, size, false),
+        m_parser(m_input, m_recorder, m_buffers),
+        m_state(state_t::initial),
+        m_value_pending(false),
+        m_event(event_type_t::start_document),
+        m_current(0),
+        m_next(0)
+    { }
+
+    //! Same as reader_t(document.data(), document.size()).
+    explicit reader_t(string_view_t document) :
+        reader_t(document.data(), document.size())
+    { }
+
+    /*! Enable or disable checking of keys uniqueness. See loltoml::parser_t::set_key_validation().
+     *
+     * It must be called before the first call to next().
+     */
+    void set_key_validation(bool enabled) {
+        assert(m_state == state_t::initial);
+        m_buffers.validate_keys = enabled;
+    }
+
+    /*! Move to the next event.
+     *
+     * The first event is always start_document. After finish_document it returns event_type_t::end.
+     * After an error the reader can't be used anymore.
+     *
+     * \returns Type of the new current event.
+     * \throws loltoml::parser_error_t if the document is invalid.
+     */
+    event_type_t next() {
+        if (m_state == state_t::initial) {
+            m_buffers.start_document();
+            m_state = state_t::first_expression;
+            m_event = event_type_t::start_document;
+            return m_event;
+        }
+
+        while (m_next == m_events.size()) {
+            if (m_state == state_t::input_ended) {
+                m_state = state_t::finished;
+                m_event = event_type_t::finish_document;
+                return m_event;
+            } else if (m_state == state_t::finished) {
+                m_event = event_type_t::end;
+                return m_event;
+            }
+
+            m_events.clear();
+            m_strings.clear();
+            m_next = 0;
+
+            if (m_value_pending) {
+                m_value_pending = false;
+                m_parser.finish_key_value(action_t::proceed);
+                continue;
+            }
+
+            parser_t::step_t step = parser_t::step_t::expression;
+
+            if (m_state == state_t::first_expression) {
+                step = m_parser.parse_first_step();
+                m_state = state_t::parsing;
+            } else {
+                step = m_parser.parse_next_step();
+            }
+
+            if (step == parser_t::step_t::input_ended) {
+                m_state = state_t::input_ended;
+            } else if (step == parser_t::step_t::value_pending) {
+                m_value_pending = true;
+            }
+        }
+
+        m_current = m_next;
+
+        const detail::recorded_event_t &event = m_events[m_current];
+        m_next += 1;
+
+        if (event.type == detail::recorded_event_t::table || event.type == detail::recorded_event_t::array_table) {
+            m_next += event.size;
+        }
+
+        m_event = event_type(event.type);
+        return m_event;
+    }
+
+    /*! Skip the value of the current key event, so the next call to next() returns the event after the value.
+     *
+     * Values of top-level keys are not parsed at all, they're skipped like with loltoml::action_t::skip_value.
+     * Values inside inline tables have been parsed along with the enclosing value, their events are just dropped.
+     * It must be called only when the current event is a key.
+     *
+     * \throws loltoml::parser_error_t if the document is invalid.
+     */
+    void skip_value() {
+        assert(m_event == event_type_t::key);
+
+        if (m_next == m_events.size() && m_value_pending) {
+            // The events recorded so far (the key) are kept until the next call to next().
+            m_value_pending = false;
+            m_parser.finish_key_value(action_t::skip_value);
+        } else {
+            m_next = static_cast<std::size_t>(detail::skip_recorded_value(m_events.begin() + m_next) - m_events.begin());
+        }
+    }
+
+    //! \returns Type of the current event, i.e. the last one returned by next().
+    event_type_t event() const {
+        return m_event;
+    }
+
+    /*! \returns Value of a comment, key, string or datetime event.
+     *
+     * The view is valid until the next call to next(), or as long as the document if it points into it.
+     */
+    string_view_t string() const {
+        assert(m_event == event_type_t::comment ||
+               m_event == event_type_t::key ||
+               m_event == event_type_t::string ||
+               m_event == event_type_t::datetime);
+
+        return detail::event_string(current());
+    }
+
+    bool boolean() const {
+        assert(m_event == event_type_t::boolean);
+        return current().value.boolean;
+    }
+
+    std::int64_t integer() const {
+        assert(m_event == event_type_t::integer);
+        return current().value.integer;
+    }
+
+    double floating_point() const {
+        assert(m_event == event_type_t::floating_point);
+        return current().value.floating_point;
+    }
+
+    /*! \returns Size of the array or the inline table for finish_array and finish_inline_table events,
+     * or the number of keys in the path for table and array_table events.
+     */
+    std::size_t size() const {
+        assert(m_event == event_type_t::finish_array ||
+               m_event == event_type_t::finish_inline_table ||
+               m_event == event_type_t::table ||
+               m_event == event_type_t::array_table);
+
+        return current().size;
+    }
+
+    //! \returns Key number index (less than size()) of the path of a table or array_table event.
+    string_view_t path(std::size_t index) const {
+        assert(m_event == event_type_t::table || m_event == event_type_t::array_table);
+        assert(index < size());
+
+        return detail::event_string(m_events[m_current + 1 + index]);
+    }
+
+private:
+    reader_t(const reader_t &);
+    reader_t &operator=(const reader_t &);
+
+    typedef detail::parser_t<detail::input_buffer_t, detail::recorder_t> parser_t;
+
+    enum class state_t {
+        initial,
+        first_expression,
+        parsing,
+        input_ended,
+        finished
+    };
+
+    static event_type_t event_type(detail::recorded_event_t::type_t type) {
+        switch (type) {
+            case detail::recorded_event_t::comment: return event_type_t::comment;
+            case detail::recorded_event_t::table: return event_type_t::table;
+            case detail::recorded_event_t::array_table: return event_type_t::array_table;
+            case detail::recorded_event_t::key: return event_type_t::key;
+            case detail::recorded_event_t::start_array: return event_type_t::start_array;
+            case detail::recorded_event_t::finish_array: return event_type_t::finish_array;
+            case detail::recorded_event_t::start_inline_table: return event_type_t::start_inline_table;
+            case detail::recorded_event_t::finish_inline_table: return event_type_t::finish_inline_table;
+            case detail::recorded_event_t::boolean: return event_type_t::boolean;
+            case detail::recorded_event_t::string: return event_type_t::string;
+            case detail::recorded_event_t::datetime: return event_type_t::datetime;
+            case detail::recorded_event_t::integer: return event_type_t::integer;
+            case detail::recorded_event_t::floating_point: return event_type_t::floating_point;
+            case detail::recorded_event_t::path_key: break;
+        }
+
+        assert(false);
+        return event_type_t::end;
+    }
+
+    const detail::recorded_event_t &current() const {
+        return m_events[m_current];
+    }
+
+    detail::input_buffer_t m_input;
+    detail::parser_buffers_t m_buffers;
+    // Events of the current top-level expression.
+    std::vector<detail::recorded_event_t> m_events;
+    detail::arena_t m_strings;
+    detail::recorder_t m_recorder;
+    parser_t m_parser;
+    state_t m_state;
+    // The parser has stopped before the value of a top-level key-value pair.
+    bool m_value_pending;
+    event_type_t m_event;
+    std::size_t m_current;
+    std::size_t m_next;
+};
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_READER_HPP
@@ -0,0 +1,373 @@
+#ifndef LOLTOML_SECTION_INDEX_HPP
+#define LOLTOML_SECTION_INDEX_HPP
+
+#include "loltoml/detail/binary.hpp"
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/header_scanner.hpp"
+#include "loltoml/detail/parser.hpp"
+#include "loltoml/error.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+/*! Index of the sections of a TOML document stored in memory.
+ *
+ * A section is a part of the document starting with a [table] or [[array table]] header and ending before
+ * the next header. The part before the first header is the root section, it's always the first one.
+ * The index maps paths of the headers to byte ranges of the sections, so a process may parse only the sections
+ * it needs, e.g. from a memory-mapped file, instead of the whole document.
+ *
+ * The index is built by a fast scan looking for header lines. Only the headers are parsed, the rest of
+ * the document isn't validated. The ranges are exact for valid documents; for invalid ones some errors
+ * are found only when the sections are parsed.
+ *
+ * The index may be saved to a small sidecar file with save() and loaded back with load().
+ * The index doesn't contain a checksum of the document, so the caller must ensure the document hasn't changed
+ * (e.g. by keeping its modification time or a hash along with the sidecar). Only the size is checked by parse().
+ *
+ * \code
+ * loltoml::section_index_t index;
+ * index.build(data, size);
+ *
+ * if (const loltoml::section_index_t::section_t *section = index.find({"service", name})) {
+ *     index.parse(data, size, *section, handler);
+ * }
+ * \endcode
+ */
+class section_index_t {
+public:
+    enum class section_type_t {
+        root,
+        table,
+        array_table
+    };
+
+    struct section_t {
+        section_type_t type;
+        //! Keys of the header. Empty for the root section.
+        std::vector<std::string> path;
+        //! Offset of the first byte of the section (of the line with the header) in the document.
+        std::size_t begin;
+        //! Offset of the byte following the section.
+        std::size_t end;
+    };
+
+    section_index_t() :
+        m_document_size(0)
+    { }
+
+    /*! Replace the index with the index of the document.
+     *
+     * \param[in] data Pointer to the document. It must be utf-8 encoded.
+     * \param[in] size Size of the document in bytes.
+     * \throws loltoml::parser_error_t if some table header is invalid.
+     */
+    void build(const char *data, std::size_t size) {
+        clear();
+        m_document_size = size;
+
+        std::vector<std::size_t> headers;
+        detail::find_all_header_lines(data, size, headers);
+
+        m_sections.emplace_back();
+        section_t &root = m_sections.back();
+        root.type = section_type_t::root;
+        root.begin = 0;
+        root.end = headers.empty() ? size : headers.front();
+
+        // Each header is parsed by a new parser, but the memory is reused.
+        detail::parser_buffers_t buffers;
+        detail::header_reader_t reader;
+
+        for (std::size_t i = 0; i < headers.size(); ++i) {
+            std::size_t end = (i + 1 < headers.size()) ? headers[i + 1] : size;
+
+            // The index is left empty if some header is invalid.
+            try {
+                detail::parse_range(data, headers[i], end, reader, buffers);
+            } catch (...) {
+                clear();
+                throw;
+            }
+
+            m_sections.emplace_back();
+            section_t &section = m_sections.back();
+            section.type = reader.array_table() ? section_type_t::array_table : section_type_t::table;
+            section.path = reader.path();
+            section.begin = headers[i];
+            section.end = end;
+        }
+
+        build_lookup();
+    }
+
+    //! Removes all the sections.
+    void clear() {
+        m_document_size = 0;
+        m_sections.clear();
+        m_lookup.clear();
+    }
+
+    //! \returns Size of the indexed document.
+    std::size_t document_size() const {
+        return m_document_size;
+    }
+
+    //! \returns All the sections in order of the document. The first one is the root section.
+    const std::vector<section_t> &sections() const {
+        return m_sections;
+    }
+
+    /*! Find the [table] section with the path.
+     *
+     * \tparam PathIterator Iterator over the keys of the path. They must be convertible to loltoml::string_view_t.
+     * \returns Pointer to the section or nullptr if there is no such table.
+     */
+    template<class PathIterator>
+    const section_t *find(PathIterator begin, PathIterator end) const {
+        auto range = m_lookup.equal_range(encode_path(begin, end));
+
+        for (auto it = range.first; it != range.second; ++it) {
+            if (m_sections[it->second].type == section_type_t::table) {
+                return &m_sections[it->second];
+            }
+        }
+
+        return nullptr;
+    }
+
+    //! Same as find(path.begin(), path.end()).
+    const section_t *find(std::initializer_list<string_view_t> path) const {
+        return find(path.begin(), path.end());
+    }
+
+    /*! Find all the [[array table]] items with the path.
+     *
+     * \param[out] result Pointers to the sections in order of the document.
+     */
+    template<class PathIterator>
+    void find_array_tables(PathIterator begin, PathIterator end, std::vector<const section_t *> &result) const {
+        result.clear();
+        auto range = m_lookup.equal_range(encode_path(begin, end));
+
+        for (auto it = range.first; it != range.second; ++it) {
+            if (m_sections[it->second].type == section_type_t::array_table) {
+                result.push_back(&m_sections[it->second]);
+            }
+        }
+
+        std::sort(result.begin(), result.end(), [](const section_t *left, const section_t *right) {
+            return left->begin < right->begin;
+        });
+    }
+
+    //! Same as find_array_tables(path.begin(), path.end(), result).
+    void find_array_tables(std::initializer_list<string_view_t> path, std::vector<const section_t *> &result) const {
+        find_array_tables(path.begin(), path.end(), result);
+    }
+
+    /*! Parse one section of the indexed document.
+     *
+     * The handler receives the events as if the section were the whole document: start_document(), table()
+     * or array_table() (except for the root section), the content of the section and finish_document().
+     * See loltoml::parse() for the requirements to the handler.
+     * Keys are checked for uniqueness only if validate_keys is true, and only within the section.
+     *
+     * \param[in] data Pointer to the document. It must be the indexed document.
+     * \param[in] size Size of the document in bytes.
+     * \param[in] section The section from this index.
+     * \returns false if the handler has stopped the parser.
+     * \throws std::invalid_argument if the size of the document differs from the indexed one.
+     * \throws loltoml::parser_error_t if the section is invalid. Offsets are offsets from the start of the document.
+     */
+    template<class Handler>
+    bool parse(const char *data,
+               std::size_t size,
+               const section_t &section,
+               Handler &handler,
+               bool validate_keys = false) const
+    {
+        if (size != m_document_size) {
+            throw std::invalid_argument("The index doesn't match the document");
+        }
+
+        detail::parser_buffers_t buffers;
+        buffers.validate_keys = validate_keys;
+        return detail::parse_range(data, section.begin, section.end, handler, buffers);
+    }
+
+    /*! Serialize the index.
+     *
+     * The format is portable between platforms. It takes about 20 bytes per section plus the keys.
+     *
+     * \param[out] output The data is appended to it.
+     */
+    void save(std::string &output) const {
+        output.append(magic(), magic_size);
+        detail::write_uint(output, m_document_size, 8);
+        detail::write_uint(output, m_sections.size(), 8);
+
+        for (auto it = m_sections.begin(); it != m_sections.end(); ++it) {
+            detail::write_uint(output, static_cast<std::uint64_t>(it->type), 1);
+            detail::write_uint(output, it->begin, 8);
+            detail::write_uint(output, it->end - it->begin, 8);
+            detail::write_uint(output, it->path.size(), 4);
+
+            for (auto key = it->path.begin(); key != it->path.end(); ++key) {
+                detail::write_uint(output, key->size(), 4);
+                output.append(*key);
+            }
+        }
+    }
+
+    /*! Replace the index with the one serialized by save().
+     *
+     * \returns false if the data is not a valid index. Then the index is left empty.
+     */
+    bool load(const char *data, std::size_t size) {
+        clear();
+
+        if (!load_sections(data, size)) {
+            clear();
+            return false;
+        }
+
+        build_lookup();
+        return true;
+    }
+
+    //! Same as load(data.data(), data.size()).
+    bool load(string_view_t data) {
+        return load(data.data(), data.size());
+    }
+
+private:
+    // Format name and version.
+    static const char *magic() {
+        return "LOLTOML-INDEX-1\n";
+    }
+
+    enum : std::size_t {
+        magic_size = 16
+    };
+
+    bool load_sections(const char *data, std::size_t size) {
+        const char *it = data;
+        const char *end = data + size;
+
+        if (size < magic_size || !std::equal(data, data + magic_size, magic())) {
+            return false;
+        }
+
+        it += magic_size;
+
+        std::uint64_t document_size = 0;
+        std::uint64_t count = 0;
+
+        if (!detail::read_uint(it, end, 8, document_size) || !detail::read_uint(it, end, 8, count) || count == 0) {
+            return false;
+        }
+
+        m_document_size = static_cast<std::size_t>(document_size);
+
+        // Each section takes at least 21 bytes, so a corrupted count can't make it allocate too much.
+        if (count > static_cast<std::uint64_t>(end - it) / 21) {
+            return false;
+        }
+
+        m_sections.resize(static_cast<std::size_t>(count));
+        std::uint64_t previous_end = 0;
+
+        for (auto section = m_sections.begin(); section != m_sections.end(); ++section) {
+            std::uint64_t type = 0;
+            std::uint64_t begin = 0;
+            std::uint64_t length = 0;
+            std::uint64_t path_size = 0;
+
+            if (!detail::read_uint(it, end, 1, type) ||
+                !detail::read_uint(it, end, 8, begin) ||
+                !detail::read_uint(it, end, 8, length) ||
+                !detail::read_uint(it, end, 4, path_size))
+            {
+                return false;
+            }
+
+            // Sections must go one after another and cover the document. Only the root section has no path.
+            bool root = (section == m_sections.begin());
+
+            if (type != static_cast<std::uint64_t>(root ? section_type_t::root : section_type_t::table) &&
+                (root || type != static_cast<std::uint64_t>(section_type_t::array_table)))
+            {
+                return false;
+            }
+
+            if (begin != previous_end || length > document_size - begin || (root ? path_size != 0 : path_size == 0)) {
+                return false;
+            }
+
+            section->type = static_cast<section_type_t>(type);
+            section->begin = static_cast<std::size_t>(begin);
+            section->end = static_cast<std::size_t>(begin + length);
+            previous_end = begin + length;
+
+            if (path_size > static_cast<std::uint64_t>(end - it) / 4) {
+                return false;
+            }
+
+            section->path.resize(static_cast<std::size_t>(path_size));
+
+            for (auto key = section->path.begin(); key != section->path.end(); ++key) {
+                std::uint64_t key_size = 0;
+
+                if (!detail::read_uint(it, end, 4, key_size) || key_size > static_cast<std::uint64_t>(end - it)) {
+                    return false;
+                }
+
+                key->assign(it, static_cast<std::size_t>(key_size));
+                it += key_size;
+            }
+        }
+
+        return it == end && previous_end == document_size;
+    }
+
+    // Keys are prefixed with their lengths, so different paths never give the same string.
+    template<class PathIterator>
+    static std::string encode_path(PathIterator begin, PathIterator end) {
+        std::string result;
+
+        for (; begin != end; ++begin) {
+            string_view_t key(*begin);
+            detail::write_uint(result, key.size(), 4);
+            result.append(key.data(), key.size());
+        }
+
+        return result;
+    }
+
+    void build_lookup() {
+        m_lookup.reserve(m_sections.size());
+
+        for (std::size_t i = 1; i < m_sections.size(); ++i) {
+            m_lookup.emplace(encode_path(m_sections[i].path.begin(), m_sections[i].path.end()), i);
+        }
+    }
+
+    std::size_t m_document_size;
+    std::vector<section_t> m_sections;
+    // Encoded paths of the sections to their indices.
+    std::unordered_multimap<std::string, std::size_t> m_lookup;
+};
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_SECTION_INDEX_HPP
@@ -0,0 +1,649 @@
+#ifndef LOLTOML_SNAPSHOT_HPP
+#define LOLTOML_SNAPSHOT_HPP
+
+#include "loltoml/detail/binary.hpp"
+#include "loltoml/detail/common.hpp"
+#include "loltoml/document.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Layout of a snapshot. All integers are little-endian, offsets of nodes are counted from the start of
+// the snapshot and offsets of strings from the start of the string region.
+//
+// header: magic[8], u64 size of the snapshot, u64 offset of the string region, root node
+// node: u32 type, u32 size, u64 payload
+//     string, datetime: size is the length, payload is the offset of the bytes
+//     integer, floating_point, boolean: size is 0, payload is the bits of the value
+//     array, table: size is the number of items, payload is the offset of the block of items
+// table member: u64 key offset, u32 key length, u32 order, node
+//
+// Members of a table are sorted by key (bytewise), so a key is found by binary search. The order field of
+// the i-th member is the position in the block of the member defined i-th, so the definition order is kept too.
+//
+// Blocks of items follow the root node in breadth-first order without gaps, so the loader checks every node
+// exactly once and a corrupted snapshot can't make it loop or recurse.
+struct snapshot_layout_t {
+    enum : std::size_t {
+        magic_size = 8,
+        header_size = 24,
+        node_size = 16,
+        member_size = 32,
+        max_size = 0xFFFFFFFF
+    };
+
+    static const char *magic() {
+        return "LOLTSNP2";
+    }
+
+    // Order of the keys in the blocks of members.
+    static bool key_less(string_view_t left, string_view_t right) {
+        int result = std::memcmp(left.data(), right.data(), std::min(left.size(), right.size()));
+        return result < 0 || (result == 0 && left.size() < right.size());
+    }
+};
+
+
+class snapshot_writer_t {
+public:
+    explicit snapshot_writer_t(std::string &output) :
+        m_output(output),
+        m_base(output.size()),
+        m_next_block(0)
+    { }
+
+    void write(const value_t &root) {
+        typedef snapshot_layout_t layout_t;
+
+        m_output.append(layout_t::magic(), layout_t::magic_size);
+        m_output.append(2 * 8, '\0'); // Sizes are known only at the end.
+
+        m_next_block = layout_t::header_size + layout_t::node_size;
+        write_node(root);
+
+        for (std::size_t i = 0; i < m_queue.size(); ++i) {
+            const value_t &container = *m_queue[i];
+
+            if (container.is_array()) {
+                array_t array = container.as_array();
+
+                for (auto it = array.begin(); it != array.end(); ++it) {
+                    write_node(*it);
+                }
+            } else {
+                write_members(container.as_table());
+            }
+        }
+
+        assert(m_output.size() - m_base == m_next_block);
+
+        std::size_t strings_offset = m_output.size() - m_base;
+        m_output.append(m_strings);
+
+        store_uint(&m_output[m_base + layout_t::magic_size], m_output.size() - m_base, 8);
+        store_uint(&m_output[m_base + layout_t::magic_size + 8], strings_offset, 8);
+    }
+
+private:
+    void write_members(table_t table) {
+        const table_member_t *members = table.begin();
+
+        m_sorted.resize(table.size());
+        for (std::size_t i = 0; i < m_sorted.size(); ++i) {
+            m_sorted[i] = i;
+        }
+
+        std::sort(m_sorted.begin(), m_sorted.end(), [members](std::size_t left, std::size_t right) {
+            return snapshot_layout_t::key_less(members[left].key, members[right].key);
+        });
+
+        // Position of each member in the sorted block.
+        m_positions.resize(table.size());
+        for (std::size_t i = 0; i < m_sorted.size(); ++i) {
+            m_positions[m_sorted[i]] = i;
+        }
+
+        for (std::size_t i = 0; i < m_sorted.size(); ++i) {
+            const table_member_t &member = members[m_sorted[i]];
+
+            write_uint(m_output, key_offset(member.key), 8);
+            write_uint(m_output, checked_size(member.key.size()), 4);
+            write_uint(m_output, m_positions[i], 4);
+            write_node(member.value);
+        }
+    }
+
+    void write_node(const value_t &value) {
+        typedef snapshot_layout_t layout_t;
+
+        std::uint64_t size = 0;
+        std::uint64_t payload = 0;
+
+        switch (value.type()) {
+            case value_type_t::string: {
+                size = value.as_string().size();
+                payload = add_string(value.as_string());
+            } break;
+            case value_type_t::datetime: {
+                size = value.as_datetime().size();
+                payload = add_string(value.as_datetime());
+            } break;
+            case value_type_t::integer: {
+                std::int64_t integer = value.as_integer();
+                std::memcpy(&payload, &integer, sizeof(payload));
+            } break;
+            case value_type_t::floating_point: {
+                double floating_point = value.as_floating_point();
+                std::memcpy(&payload, &floating_point, sizeof(payload));
+            } break;
+            case value_type_t::boolean: {
+                payload = value.as_boolean() ? 1 : 0;
+            } break;
+            case value_type_t::array: {
+                size = value.as_array().size();
+                payload = add_block(value, size, layout_t::node_size);
+            } break;
+            case value_type_t::table: {
+                size = value.as_table().size();
+                payload = add_block(value, size, layout_t::member_size);
+            } break;
+        }
+
+        write_uint(m_output, static_cast<std::uint64_t>(value.type()), 4);
+        write_uint(m_output, checked_size(size), 4);
+        write_uint(m_output, payload, 8);
+    }
+
+    std::uint64_t add_block(const value_t &container, std::uint64_t size, std::uint64_t item_size) {
+        std::uint64_t result = m_next_block;
+        m_next_block += size * item_size;
+        m_queue.push_back(&container);
+        return result;
+    }
+
+    std::uint64_t add_string(string_view_t string) {
+        std::uint64_t result = m_strings.size();
+        m_strings.append(string.data(), string.size());
+        return result;
+    }
+
+    // The same keys are usually repeated in every item of an array of tables, so they are stored once.
+    std::uint64_t key_offset(string_view_t key) {
+        auto inserted = m_keys.emplace(key.to_string(), m_strings.size());
+
+        if (inserted.second) {
+            add_string(key);
+        }
+
+        return inserted.first->second;
+    }
+
+    static std::uint64_t checked_size(std::uint64_t size) {
+        if (size > snapshot_layout_t::max_size) {
+            throw std::length_error("loltoml: the value is too large for a snapshot");
+        }
+
+        return size;
+    }
+
+    std::string &m_output;
+    std::size_t m_base;
+    std::uint64_t m_next_block;
+    std::vector<const value_t *> m_queue;
+    // Scratch space of write_members().
+    std::vector<std::size_t> m_sorted;
+    std::vector<std::size_t> m_positions;
+    std::string m_strings;
+    std::unordered_map<std::string, std::uint64_t> m_keys;
+};
+
+
+} // namespace detail
+
+
+class snapshot_array_t;
+class snapshot_table_t;
+
+
+//! A node of a snapshot. It's a lightweight view into the snapshot. Accessors of a wrong type are not allowed.
+class snapshot_value_t {
+public:
+    //! Creates an invalid value, which may only be assigned to.
+    snapshot_value_t() :
+        m_data(nullptr),
+        m_strings(nullptr),
+        m_node(nullptr)
+    { }
+
+    snapshot_value_t(const char *data, const char *strings, const char *node) :
+        m_data(data),
+        m_strings(strings),
+        m_node(node)
+    { }
+
+    value_type_t type() const {
+        return static_cast<value_type_t>(static_cast<unsigned char>(m_node[0]));
+    }
+
+    bool is_string() const {
+        return type() == value_type_t::string;
+    }
+
+    bool is_integer() const {
+        return type() == value_type_t::integer;
+    }
+
+    bool is_floating_point() const {
+        return type() == value_type_t::floating_point;
+    }
+
+    bool is_boolean() const {
+        return type() == value_type_t::boolean;
+    }
+
+    bool is_datetime() const {
+        return type() == value_type_t::datetime;
+    }
+
+    bool is_array() const {
+        return type() == value_type_t::array;
+    }
+
+    bool is_table() const {
+        return type() == value_type_t::table;
+    }
+
+    string_view_t as_string() const {
+        assert(is_string());
+        return string_view_t(m_strings + payload(), size());
+    }
+
+    std::int64_t as_integer() const {
+        assert(is_integer());
+        std::uint64_t bits = payload();
+        std::int64_t result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    double as_floating_point() const {
+        assert(is_floating_point());
+        std::uint64_t bits = payload();
+        double result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    bool as_boolean() const {
+        assert(is_boolean());
+        return payload() != 0;
+    }
+
+    //! \returns Datetime as it's written in the document.
+    string_view_t as_datetime() const {
+        assert(is_datetime());
+        return string_view_t(m_strings + payload(), size());
+    }
+
+    inline snapshot_array_t as_array() const;
+
+    inline snapshot_table_t as_table() const;
+
+private:
+    std::size_t size() const {
+        return static_cast<std::size_t>(detail::load_uint(m_node + 4, 4));
+    }
+
+    std::size_t payload() const {
+        return static_cast<std::size_t>(detail::load_uint(m_node + 8, 8));
+    }
+
+    const char *m_data;
+    const char *m_strings;
+    const char *m_node;
+};
+
+
+struct snapshot_member_t {
+    string_view_t key;
+    snapshot_value_t value;
+};
+
+
+//! Elements of an array value of a snapshot.
+class snapshot_array_t {
+public:
+    snapshot_array_t(const char *data, const char *strings, const char *items, std::size_t size) :
+        m_data(data),
+        m_strings(strings),
+        m_items(items),
+        m_size(size)
+    { }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    snapshot_value_t operator[](std::size_t index) const {
+        assert(index < m_size);
+        return snapshot_value_t(m_data, m_strings, m_items + index * detail::snapshot_layout_t::node_size);
+    }
+
+private:
+    const char *m_data;
+    const char *m_strings;
+    const char *m_items;
+    std::size_t m_size;
+};
+
+
+//! Members of a table value of a snapshot in order of their definition. Keys are found by binary search.
+class snapshot_table_t {
+public:
+    snapshot_table_t(const char *data, const char *strings, const char *members, std::size_t size) :
+        m_data(data),
+        m_strings(strings),
+        m_members(members),
+        m_size(size)
+    { }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    snapshot_member_t operator[](std::size_t index) const {
+        assert(index < m_size);
+
+        std::size_t position = static_cast<std::size_t>(detail::load_uint(member(index) + 12, 4));
+        const char *found = member(position);
+        return snapshot_member_t{key(found), snapshot_value_t(m_data, m_strings, found + 16)};
+    }
+
+    //! \returns true and sets result to the value of the key, or false if there is no such key in the table.
+    bool find(string_view_t key, snapshot_value_t &result) const {
+        std::size_t begin = 0;
+        std::size_t end = m_size;
+
+        while (begin < end) {
+            std::size_t middle = begin + (end - begin) / 2;
+
+            if (detail::snapshot_layout_t::key_less(this->key(member(middle)), key)) {
+                begin = middle + 1;
+            } else {
+                end = middle;
+            }
+        }
+
+        if (begin < m_size && this->key(member(begin)) == key) {
+            result = snapshot_value_t(m_data, m_strings, member(begin) + 16);
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    const char *member(std::size_t position) const {
+        return m_members + position * detail::snapshot_layout_t::member_size;
+    }
+
+    string_view_t key(const char *member) const {
+        return string_view_t(m_strings + detail::load_uint(member, 8),
+                             static_cast<std::size_t>(detail::load_uint(member + 8, 4)));
+    }
+
+    const char *m_data;
+    const char *m_strings;
+    const char *m_members;
+    std::size_t m_size;
+};
+
+
+inline snapshot_array_t snapshot_value_t::as_array() const {
+    assert(is_array());
+    return snapshot_array_t(m_data, m_strings, m_data + payload(), size());
+}
+
+inline snapshot_table_t snapshot_value_t::as_table() const {
+    assert(is_table());
+    return snapshot_table_t(m_data, m_strings, m_data + payload(), size());
+}
+
+
+/*! Write the document into a compact binary snapshot.
+ *
+ * A snapshot holds the same tree as the document, but all the links are offsets, so it may be saved to a file
+ * and later queried in place with loltoml::snapshot_t (e.g. right from a memory-mapped file) without parsing
+ * or deserialization. The format is portable between platforms. The source of the snapshot isn't recorded
+ * in it, so the caller should keep snapshots keyed by the hash of the source document.
+ *
+ * \param[out] output The snapshot is appended to it.
+ * \throws std::length_error if a string or a container has more than 2^32 - 1 elements.
+ */
+inline void write_snapshot(const document_t &document, std::string &output) {
+    detail::snapshot_writer_t(output).write(document.root());
+}
+
+
+/*! Read-only view of a snapshot written by loltoml::write_snapshot().
+ *
+ * The snapshot is validated by load() once, so the values may then be accessed without any checks.
+ * The view doesn't copy the data, so it must outlive the view and the values.
+ *
+ * \code
+ * loltoml::snapshot_t snapshot;
+ *
+ * if (!snapshot.load(mapped_data, mapped_size)) {
+ *     // Rebuild the snapshot from the TOML document.
+ * }
+ *
+ * loltoml::snapshot_value_t port;
+ * if (snapshot.root().as_table().find("port", port) && port.is_integer()) {
+ *     ...
+ * }
+ * \endcode
+ */
+class snapshot_t {
+public:
+    snapshot_t() :
+        m_data(nullptr),
+        m_size(0)
+    { }
+
+    /*! Use the snapshot in the buffer.
+     *
+     * Every node, string and offset of the snapshot is checked. The buffer doesn't need any alignment.
+     *
+     * \returns false if the data is not a valid snapshot. Then the view is left empty.
+     */
+    bool load(const char *data, std::size_t size) {
+        m_data = nullptr;
+        m_size = 0;
+
+        if (!validate(data, size)) {
+            return false;
+        }
+
+        m_data = data;
+        m_size = size;
+        return true;
+    }
+
+    //! Same as load(data.data(), data.size()).
+    bool load(string_view_t data) {
+        return load(data.data(), data.size());
+    }
+
+    //! \returns true if no snapshot is loaded.
+    bool empty() const {
+        return m_data == nullptr;
+    }
+
+    //! \returns Size of the snapshot in bytes.
+    std::size_t size() const {
+        return m_size;
+    }
+
+    //! \returns The root table. The snapshot must be loaded.
+    snapshot_value_t root() const {
+        assert(!empty());
+
+        const char *strings = m_data + detail::load_uint(m_data + detail::snapshot_layout_t::magic_size + 8, 8);
+        return snapshot_value_t(m_data, strings, m_data + detail::snapshot_layout_t::header_size);
+    }
+
+private:
+    struct block_t {
+        std::uint64_t offset;
+        std::uint64_t size;
+        bool table;
+    };
+
+    static bool validate(const char *data, std::size_t size) {
+        typedef detail::snapshot_layout_t layout_t;
+
+        if (size < layout_t::header_size + layout_t::node_size ||
+            !std::equal(data, data + layout_t::magic_size, layout_t::magic()))
+        {
+            return false;
+        }
+
+        std::uint64_t strings_offset = detail::load_uint(data + layout_t::magic_size + 8, 8);
+
+        if (detail::load_uint(data + layout_t::magic_size, 8) != size ||
+            strings_offset < layout_t::header_size + layout_t::node_size ||
+            strings_offset > size)
+        {
+            return false;
+        }
+
+        std::uint64_t strings_size = size - strings_offset;
+        std::uint64_t cursor = layout_t::header_size + layout_t::node_size;
+        std::vector<block_t> blocks;
+        // Positions of a table block already referenced by the order fields.
+        std::vector<bool> referenced;
+
+        const char *root = data + layout_t::header_size;
+
+        if (detail::load_uint(root, 4) != static_cast<std::uint64_t>(value_type_t::table) ||
+            !validate_node(root, strings_size, strings_offset, cursor, blocks))
+        {
+            return false;
+        }
+
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            const block_t block = blocks[i];
+
+            if (block.table) {
+                referenced.assign(static_cast<std::size_t>(block.size), false);
+            }
+
+            for (std::uint64_t j = 0; j < block.size; ++j) {
+                if (block.table) {
+                    const char *member = data + block.offset + j * layout_t::member_size;
+                    std::uint64_t key_offset = detail::load_uint(member, 8);
+                    std::uint64_t key_size = detail::load_uint(member + 8, 4);
+                    std::uint64_t order = detail::load_uint(member + 12, 4);
+
+                    if (key_offset > strings_size || key_size > strings_size - key_offset ||
+                        order >= block.size || referenced[static_cast<std::size_t>(order)] ||
+                        !validate_node(member + 16, strings_size, strings_offset, cursor, blocks))
+                    {
+                        return false;
+                    }
+
+                    referenced[static_cast<std::size_t>(order)] = true;
+
+                    // Keys must be unique and sorted for the binary search.
+                    const char *strings = data + strings_offset;
+                    string_view_t key(strings + key_offset, static_cast<std::size_t>(key_size));
+
+                    if (j > 0) {
+                        const char *previous = member - layout_t::member_size;
+                        string_view_t previous_key(strings + detail::load_uint(previous, 8),
+                                                   static_cast<std::size_t>(detail::load_uint(previous + 8, 4)));
+
+                        if (!layout_t::key_less(previous_key, key)) {
+                            return false;
+                        }
+                    }
+                } else {
+                    const char *node = data + block.offset + j * layout_t::node_size;
+
+                    if (!validate_node(node, strings_size, strings_offset, cursor, blocks)) {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return cursor == strings_offset;
+    }
+
+    static bool validate_node(const char *node,
+                              std::uint64_t strings_size,
+                              std::uint64_t nodes_end,
+                              std::uint64_t &cursor,
+                              std::vector<block_t> &blocks)
+    {
+        typedef detail::snapshot_layout_t layout_t;
+
+        std::uint64_t type = detail::load_uint(node, 4);
+        std::uint64_t size = detail::load_uint(node + 4, 4);
+        std::uint64_t payload = detail::load_uint(node + 8, 8);
+
+        switch (type) {
+            case static_cast<std::uint64_t>(value_type_t::string):
+            case static_cast<std::uint64_t>(value_type_t::datetime):
+                return payload <= strings_size && size <= strings_size - payload;
+            case static_cast<std::uint64_t>(value_type_t::integer):
+            case static_cast<std::uint64_t>(value_type_t::floating_point):
+                return size == 0;
+            case static_cast<std::uint64_t>(value_type_t::boolean):
+                return size == 0 && payload <= 1;
+            case static_cast<std::uint64_t>(value_type_t::array):
+            case static_cast<std::uint64_t>(value_type_t::table): {
+                bool table = (type == static_cast<std::uint64_t>(value_type_t::table));
+                std::uint64_t item_size = table ? layout_t::member_size : layout_t::node_size;
+
+                if (payload != cursor || size > (nodes_end - cursor) / item_size) {
+                    return false;
+                }
+
+                cursor += size * item_size;
+                blocks.push_back(block_t{payload, size, table});
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    const char *m_data;
+    std::size_t m_size;
+};
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_SNAPSHOT_HPP
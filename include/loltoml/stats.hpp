@@ -0,0 +1,126 @@
+#ifndef LOLTOML_STATS_HPP
+#define LOLTOML_STATS_HPP
+
+#include "loltoml/detail/common.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+// Define LOLTOML_ENABLE_STATS to make the parser fill loltoml::parse_stats_t.
+// Without it the instrumentation compiles to nothing and the stats stay zero.
+// The macro must be defined the same way in all translation units of a program.
+#ifdef LOLTOML_ENABLE_STATS
+#define LOLTOML_STATS_ENABLED 1
+#else
+#define LOLTOML_STATS_ENABLED 0
+#endif
+
+LOLTOML_OPEN_NAMESPACE
+
+
+//! Events passed to the handler, see loltoml::parse().
+enum class parse_event_t {
+    start_document,
+    finish_document,
+    comment,
+    table,
+    array_table,
+    key,
+    start_array,
+    finish_array,
+    start_inline_table,
+    finish_inline_table,
+    boolean,
+    string,
+    datetime,
+    integer,
+    floating_point
+};
+
+
+/*! Parts of the grammar the input bytes are attributed to.
+ *
+ * A byte belongs to all the productions containing it, e.g. bytes of a string inside an array
+ * are counted both for the string and for the array, and bytes of keys are counted for table headers too.
+ */
+enum class grammar_production_t {
+    //! The whole input.
+    document,
+    //! Comments from '#' to the end of the line.
+    comment,
+    //! [table] and [[array table]] headers.
+    table_header,
+    //! Keys of key-value pairs and of table headers.
+    key,
+    basic_string,
+    multiline_string,
+    literal_string,
+    multiline_literal_string,
+    integer,
+    floating_point,
+    boolean,
+    datetime,
+    array,
+    inline_table,
+    //! Values skipped because of loltoml::action_t::skip_value.
+    skipped_value
+};
+
+
+/*! Counters describing what the parser has done.
+ *
+ * The parser adds to the counters, so one object may collect the stats of many documents.
+ * The counters are filled only if the program is built with LOLTOML_ENABLE_STATS defined, see enabled().
+ */
+struct parse_stats_t {
+    enum : std::size_t {
+        events_count = 15,
+        productions_count = 15
+    };
+
+    /*! Heap allocations made by the parser for its scratch buffers (unescaped strings, table paths,
+     *  brackets of deeply nested skipped values).
+     *
+     * The buffers are checked after every token, so a buffer growing several times within one token counts once.
+     * Memory used by key validation and symbol tables is not counted.
+     */
+    std::size_t allocations;
+    //! Total size of the allocations in bytes.
+    std::size_t allocated_bytes;
+    //! Maximum memory held by the scratch buffers at once, in bytes.
+    std::size_t peak_scratch_size;
+    //! Number of events of every type indexed by loltoml::parse_event_t.
+    std::size_t events[events_count];
+    //! Bytes consumed by every production indexed by loltoml::grammar_production_t.
+    std::size_t bytes[productions_count];
+
+    parse_stats_t() {
+        clear();
+    }
+
+    void clear() {
+        allocations = 0;
+        allocated_bytes = 0;
+        peak_scratch_size = 0;
+        std::fill(events, events + events_count, std::size_t(0));
+        std::fill(bytes, bytes + productions_count, std::size_t(0));
+    }
+
+    std::size_t event_count(parse_event_t event) const {
+        return events[static_cast<std::size_t>(event)];
+    }
+
+    std::size_t consumed(grammar_production_t production) const {
+        return bytes[static_cast<std::size_t>(production)];
+    }
+
+    //! \returns true if the parser is built with LOLTOML_ENABLE_STATS and fills the stats.
+    static bool enabled() {
+        return LOLTOML_STATS_ENABLED != 0;
+    }
+};
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_STATS_HPP
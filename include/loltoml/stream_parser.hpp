@@ -0,0 +1,186 @@
+#ifndef LOLTOML_STREAM_PARSER_HPP
+#define LOLTOML_STREAM_PARSER_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/input_buffer.hpp"
+#include "loltoml/detail/parser.hpp"
+#include "loltoml/detail/statement_scanner.hpp"
+#include "loltoml/error.hpp"
+#include "loltoml/parse.hpp"
+#include "loltoml/string_view.hpp"
+#include "loltoml/symbol_table.hpp"
+
+#include <string>
+
+LOLTOML_OPEN_NAMESPACE
+
+
+/*! Push parser for documents arriving in pieces, e.g. from a non-blocking socket.
+ *
+ * The document is passed to feed() in chunks of any size and finish() is called after the last one.
+ * The handler receives the same events and errors (with offsets from the start of the document)
+ * as with loltoml::parse(). Events for a top-level expression (a key-value pair, a table header or a comment)
+ * are emitted as soon as the new-line ending it arrives. Only the incomplete expression is buffered,
+ * so the memory is bounded by the longest top-level expression (e.g. a long multiline array), not by the document.
+ * See loltoml::parse() for the requirements to the handler.
+ *
+ * If the handler stops the parser (see loltoml::action_t::stop), the rest of the document is ignored
+ * and finish() doesn't call finish_document().
+ *
+ * After an error the parser must be reset() before parsing the next document.
+ *
+ * \tparam Handler Type of the handler.
+ */
+template<class Handler>
+class stream_parser_t {
+public:
+    //! \param[out] handler Parser will feed SAX-events to this object. It must outlive the parser.
+    explicit stream_parser_t(Handler &handler) :
+        m_handler(handler),
+        m_started(false),
+        m_offset(0)
+    { }
+
+    Handler &handler() const {
+        return m_handler;
+    }
+
+    /*! Parse the next chunk of the document.
+     *
+     * The first call starts a new document. The data isn't referenced after the call returns.
+     *
+     * \throws loltoml::parser_error_t if the document is invalid.
+     */
+    void feed(const char *data, std::size_t size) {
+        start();
+
+        if (m_buffers.stopped) {
+            return;
+        }
+
+        std::size_t boundary = m_scanner.scan(data, size);
+
+        if (boundary == detail::statement_scanner_t::npos) {
+            m_pending.append(data, size);
+            return;
+        }
+
+        // Complete expressions are parsed directly from the chunk when nothing is buffered.
+        if (m_pending.empty()) {
+            parse_part(data, boundary);
+        } else {
+            m_pending.append(data, boundary);
+            parse_part(m_pending.data(), m_pending.size());
+            m_pending.clear();
+        }
+
+        if (!m_buffers.stopped) {
+            m_pending.append(data + boundary, size - boundary);
+        }
+    }
+
+    //! Same as feed(data.data(), data.size()).
+    void feed(string_view_t data) {
+        feed(data.data(), data.size());
+    }
+
+    /*! Parse the rest of the document and finish it.
+     *
+     * Then the parser is ready for the next document.
+     *
+     * \returns false if the handler has stopped the parser.
+     * \throws loltoml::parser_error_t if the document is invalid.
+     */
+    bool finish() {
+        start();
+
+        if (!m_buffers.stopped) {
+            parse_part(m_pending.data(), m_pending.size());
+        }
+
+        bool finished = !m_buffers.stopped;
+
+        if (finished) {
+            m_handler.finish_document();
+        }
+
+        clear_document();
+        return finished;
+    }
+
+    //! \returns true if the handler has stopped the parser in the current document.
+    bool stopped() const {
+        return m_buffers.stopped;
+    }
+
+    //! \returns Number of bytes waiting for the end of the current top-level expression.
+    std::size_t buffered() const {
+        return m_pending.size();
+    }
+
+    //! See loltoml::parser_t::set_key_validation().
+    void set_key_validation(bool enabled) {
+        m_buffers.validate_keys = enabled;
+    }
+
+    bool key_validation() const {
+        return m_buffers.validate_keys;
+    }
+
+    //! See loltoml::parser_t::set_symbol_table().
+    void set_symbol_table(symbol_table_t &symbols) {
+        m_buffers.symbols.set_table(&symbols);
+    }
+
+    //! Drops the current document (if any) but keeps the allocated memory.
+    void reset() {
+        clear_document();
+        m_buffers.clear();
+    }
+
+private:
+    stream_parser_t(const stream_parser_t &);
+    stream_parser_t &operator=(const stream_parser_t &);
+
+    void start() {
+        if (!m_started) {
+            m_started = true;
+            m_buffers.start_document();
+            m_handler.start_document();
+        }
+    }
+
+    void parse_part(const char *data, std::size_t size) {
+        detail::input_buffer_t input(data, size);
+        detail::parser_t<detail::input_buffer_t, Handler> parser(input, m_handler, m_buffers);
+
+        try {
+            parser.parse_part();
+        } catch (const parser_error_t &error) {
+            throw parser_error_t(error, m_offset + error.offset());
+        }
+
+        m_offset += size;
+    }
+
+    void clear_document() {
+        m_started = false;
+        m_offset = 0;
+        m_pending.clear();
+        m_scanner.reset();
+    }
+
+    Handler &m_handler;
+    detail::parser_buffers_t m_buffers;
+    detail::statement_scanner_t m_scanner;
+    // The incomplete expression at the end of the data fed so far.
+    std::string m_pending;
+    bool m_started;
+    // Offset of m_pending from the start of the document.
+    std::size_t m_offset;
+};
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_STREAM_PARSER_HPP
@@ -0,0 +1,128 @@
+#ifndef LOLTOML_STRING_VIEW_HPP
+#define LOLTOML_STRING_VIEW_HPP
+
+#include "loltoml/detail/common.hpp"
+
+#include <cstring>
+#include <ostream>
+#include <string>
+
+LOLTOML_OPEN_NAMESPACE
+
+
+/*! Non-owning reference to a contiguous sequence of chars.
+ *
+ * It's a minimal replacement for std::string_view, which is not available in C++11.
+ * The referenced memory must outlive the view.
+ */
+class string_view_t {
+public:
+    typedef const char *const_iterator;
+    typedef const_iterator iterator;
+
+    string_view_t() :
+        m_data(""),
+        m_size(0)
+    { }
+
+    string_view_t(const char *data, std::size_t size) :
+        m_data(data),
+        m_size(size)
+    { }
+
+    string_view_t(const char *string) :
+        m_data(string),
+        m_size(std::strlen(string))
+    { }
+
+    //! Strings with any allocator, e.g. the ones passed to handlers by a parser with a custom allocator.
+    template<class Allocator>
+    string_view_t(const std::basic_string<char, std::char_traits<char>, Allocator> &string) :
+        m_data(string.data()),
+        m_size(string.size())
+    { }
+
+    const char *data() const {
+        return m_data;
+    }
+
+    std::size_t size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    const_iterator begin() const {
+        return m_data;
+    }
+
+    const_iterator end() const {
+        return m_data + m_size;
+    }
+
+    char operator[](std::size_t index) const {
+        return m_data[index];
+    }
+
+    //! \returns A copy of the referenced chars.
+    std::string to_string() const {
+        return std::string(m_data, m_size);
+    }
+
+private:
+    const char *m_data;
+    std::size_t m_size;
+};
+
+
+inline bool operator==(string_view_t left, string_view_t right) {
+    return left.size() == right.size() &&
+           (left.size() == 0 || std::memcmp(left.data(), right.data(), left.size()) == 0);
+}
+
+inline bool operator!=(string_view_t left, string_view_t right) {
+    return !(left == right);
+}
+
+inline bool operator==(string_view_t left, const std::string &right) {
+    return left == string_view_t(right);
+}
+
+inline bool operator==(const std::string &left, string_view_t right) {
+    return string_view_t(left) == right;
+}
+
+inline bool operator!=(string_view_t left, const std::string &right) {
+    return !(left == right);
+}
+
+inline bool operator!=(const std::string &left, string_view_t right) {
+    return !(left == right);
+}
+
+inline bool operator==(string_view_t left, const char *right) {
+    return left == string_view_t(right);
+}
+
+inline bool operator!=(string_view_t left, const char *right) {
+    return !(left == right);
+}
+
+inline bool operator==(const char *left, string_view_t right) {
+    return string_view_t(left) == right;
+}
+
+inline bool operator!=(const char *left, string_view_t right) {
+    return !(left == right);
+}
+
+inline std::ostream &operator<<(std::ostream &output, string_view_t value) {
+    return output.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_STRING_VIEW_HPP
@@ -0,0 +1,146 @@
+#ifndef LOLTOML_SYMBOL_TABLE_HPP
+#define LOLTOML_SYMBOL_TABLE_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/interner.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+
+//! Interned key.
+struct symbol_t {
+    //! Ids are assigned consecutively starting from 0 in order of interning.
+    std::uint32_t id;
+    //! Text of the key. It's stored in the symbol table and is valid as long as the table exists.
+    string_view_t text;
+};
+
+inline bool operator==(const symbol_t &left, const symbol_t &right) {
+    return left.id == right.id;
+}
+
+inline bool operator!=(const symbol_t &left, const symbol_t &right) {
+    return left.id != right.id;
+}
+
+typedef const symbol_t *symbol_iterator_t;
+
+
+/*! Thread-safe set of interned keys.
+ *
+ * The same key always gets the same id, so handlers may dispatch on integers instead of comparing strings.
+ * Symbols are never removed, so a table shared by many parsers (possibly in different threads)
+ * keeps ids stable across all the documents they parse.
+ */
+class symbol_table_t {
+public:
+    symbol_table_t() { }
+
+    //! \returns Symbol of the key, adding it to the table if needed.
+    symbol_t intern(string_view_t key) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::uint32_t id = m_interner.intern(key);
+        return symbol_t {id, m_interner.get(id)};
+    }
+
+    /*! Look up the key without adding it.
+     *
+     * \returns true and sets result if the key is in the table.
+     */
+    bool find(string_view_t key, symbol_t &result) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::uint32_t id = m_interner.find(key);
+
+        if (id == detail::string_interner_t::npos) {
+            return false;
+        }
+
+        result = symbol_t {id, m_interner.get(id)};
+        return true;
+    }
+
+    //! \returns Symbol with the id. The id must have been returned by this table.
+    symbol_t get(std::uint32_t id) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return symbol_t {id, m_interner.get(id)};
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_interner.size();
+    }
+
+private:
+    symbol_table_t(const symbol_table_t &);
+    symbol_table_t &operator=(const symbol_table_t &);
+
+    mutable std::mutex m_mutex;
+    detail::string_interner_t m_interner;
+};
+
+
+namespace detail {
+
+
+// Per-parser cache of a symbol table. Since symbols are never removed from the table,
+// keys seen before by this parser are resolved without locking the shared table.
+class symbol_cache_t {
+public:
+    symbol_cache_t() :
+        m_table(nullptr)
+    { }
+
+    // The table must outlive the cache. If no table is set, a private table is created on the first use.
+    void set_table(symbol_table_t *table) {
+        if (table != m_table) {
+            m_table = table;
+            m_own_table.reset();
+            m_keys.clear();
+            m_symbols.clear();
+        }
+    }
+
+    symbol_table_t *table() const {
+        return m_table;
+    }
+
+    symbol_t get(string_view_t key) {
+        std::uint32_t hash = hash_string(key);
+        std::uint32_t local_id = m_keys.find(key, hash);
+
+        if (local_id != string_interner_t::npos) {
+            return m_symbols[local_id];
+        }
+
+        if (!m_table) {
+            m_own_table.reset(new symbol_table_t);
+            m_table = m_own_table.get();
+        }
+
+        symbol_t symbol = m_table->intern(key);
+        m_keys.intern(key, hash);
+        m_symbols.push_back(symbol);
+
+        return symbol;
+    }
+
+private:
+    symbol_table_t *m_table;
+    std::unique_ptr<symbol_table_t> m_own_table;
+    // Local ids of m_keys index m_symbols.
+    string_interner_t m_keys;
+    std::vector<symbol_t> m_symbols;
+};
+
+
+} // namespace detail
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_SYMBOL_TABLE_HPP
@@ -0,0 +1,465 @@
+#ifndef LOLTOML_WRITER_HPP
+#define LOLTOML_WRITER_HPP
+
+#include "loltoml/detail/common.hpp"
+#include "loltoml/detail/handler_traits.hpp"
+#include "loltoml/detail/number.hpp"
+#include "loltoml/detail/scan.hpp"
+#include "loltoml/string_view.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+LOLTOML_OPEN_NAMESPACE
+
+namespace detail {
+
+
+// Where writer_t puts the text: any output iterator or, with bulk appends, a std::string.
+template<class OutputIterator>
+class writer_output_t {
+public:
+    typedef OutputIterator argument_type;
+    typedef OutputIterator result_type;
+
+    explicit writer_output_t(OutputIterator output) :
+        m_output(output)
+    { }
+
+    void append(const char *data, std::size_t size) {
+        m_output = std::copy(data, data + size, m_output);
+    }
+
+    void push_back(char ch) {
+        *m_output = ch;
+        ++m_output;
+    }
+
+    OutputIterator get() const {
+        return m_output;
+    }
+
+private:
+    OutputIterator m_output;
+};
+
+template<>
+class writer_output_t<std::string> {
+public:
+    typedef std::string &argument_type;
+    typedef std::string &result_type;
+
+    explicit writer_output_t(std::string &output) :
+        m_output(output)
+    { }
+
+    void append(const char *data, std::size_t size) {
+        m_output.append(data, size);
+    }
+
+    void push_back(char ch) {
+        m_output.push_back(ch);
+    }
+
+    std::string &get() const {
+        return m_output;
+    }
+
+private:
+    std::string &m_output;
+};
+
+
+enum : std::size_t {
+    // Enough for any int64 and for any double printed by format_double().
+    max_number_size = 32
+};
+
+// Writes the decimal representation of the value to the end of the buffer and returns pointer to its start.
+inline char *format_integer(std::int64_t value, char *buffer_end) {
+    bool negative = value < 0;
+    // Negation in unsigned arithmetic works for the minimal value too.
+    std::uint64_t absolute = negative ? 0 - static_cast<std::uint64_t>(value) : static_cast<std::uint64_t>(value);
+
+    char *it = buffer_end;
+
+    do {
+        *--it = static_cast<char>('0' + absolute % 10);
+        absolute /= 10;
+    } while (absolute != 0);
+
+    if (negative) {
+        *--it = '-';
+    }
+
+    return it;
+}
+
+// Converts output of printf("%g") to the TOML syntax: the decimal point of the current locale becomes '.',
+// '+' and leading zeros are removed from the exponent and ".0" is appended to integers.
+inline std::size_t normalize_printed_double(const char *printed, char *output) {
+    char *it = output;
+    bool has_point = false;
+    bool exponent = false;
+
+    while (*printed) {
+        char ch = *printed;
+
+        if (ch >= '0' && ch <= '9') {
+            *it++ = ch;
+            ++printed;
+        } else if (ch == '-') {
+            *it++ = ch;
+            ++printed;
+        } else if (ch == '+') {
+            ++printed;
+        } else if (ch == 'e' || ch == 'E') {
+            *it++ = 'e';
+            exponent = true;
+            ++printed;
+
+            if (*printed == '-') {
+                *it++ = '-';
+                ++printed;
+            } else if (*printed == '+') {
+                ++printed;
+            }
+
+            while (printed[0] == '0' && printed[1] != '\0') {
+                ++printed;
+            }
+        } else {
+            // The decimal point may take several bytes in some locales.
+            *it++ = '.';
+            has_point = true;
+
+            while (*printed && !(*printed >= '0' && *printed <= '9')) {
+                ++printed;
+            }
+        }
+    }
+
+    if (!has_point && !exponent) {
+        *it++ = '.';
+        *it++ = '0';
+    }
+
+    return static_cast<std::size_t>(it - output);
+}
+
+// Writes the representation with the fewest significant digits which is parsed back to the same value.
+// 17 digits always round-trip. If a normal double round-trips with at most 15 digits, rounding it to 15 digits
+// gives the same decimal (%g drops the trailing zeros), so only 15, 16 and 17 are tried. Subnormals have less
+// precision, so all the precisions are tried for them. The value must be finite.
+inline std::size_t format_double(double value, char *output) {
+    // Larger than needed, since compilers can't prove that the output fits.
+    char printed[64];
+    bool subnormal = value != 0 && std::fabs(value) < std::numeric_limits<double>::min();
+
+    for (int precision = subnormal ? 1 : 15; ; ++precision) {
+        std::snprintf(printed, sizeof(printed), "%.*g", precision, value);
+        std::size_t size = normalize_printed_double(printed, output);
+
+        if (precision == 17) {
+            return size;
+        }
+
+        bool negative = (output[0] == '-');
+        const char *begin = output + (negative ? 1 : 0);
+
+        if (decimal_to_double(begin, output + size, negative) == value) {
+            return size;
+        }
+    }
+}
+
+
+} // namespace detail
+
+
+/*! Emitter of TOML documents.
+ *
+ * The writer has the same methods as a handler of loltoml::parse(), so a parser may feed it directly,
+ * and a program may call them to generate a document. The calls must describe a valid document:
+ * e.g. values must follow keys, containers must be finished, keys must not repeat.
+ * The writer checks only what it can't print (non-finite floats).
+ *
+ * The text is appended to a std::string or written to an output iterator (e.g. std::ostreambuf_iterator)
+ * without any intermediate buffering or flushes. Strings are written as basic strings; runs of characters
+ * which don't need escaping are found with SIMD and copied at once. Floats are written with the fewest digits
+ * that parse back to the same value.
+ *
+ * \code
+ * std::string buffer;
+ * loltoml::writer_t<> writer(buffer);
+ *
+ * loltoml::parse(input, writer);
+ * \endcode
+ *
+ * \tparam Output std::string or type of an output iterator over chars.
+ */
+template<class Output = std::string>
+class writer_t {
+public:
+    /*! \param[in] output The buffer to append to or the output iterator.
+     */
+    explicit writer_t(typename detail::writer_output_t<Output>::argument_type output) :
+        m_output(output),
+        m_has_content(false)
+    { }
+
+    //! \returns The buffer or the output iterator after the written text.
+    typename detail::writer_output_t<Output>::result_type output() const {
+        return m_output.get();
+    }
+
+    void start_document() { }
+
+    void finish_document() {
+        assert(m_sequences.empty());
+    }
+
+    //! Writes the comment on a separate line.
+    void comment(string_view_t text) {
+        if (!m_sequences.empty()) {
+            // Comments are allowed only inside of multiline arrays.
+            assert(m_sequences.back().type == sequence_type_t::array);
+            m_output.push_back(' ');
+        }
+
+        m_output.push_back('#');
+        write_raw(text);
+        m_output.push_back('\n');
+        m_has_content = true;
+    }
+
+    //! \tparam Iterator Iterator over the keys: strings, string views or loltoml::symbol_t.
+    template<class Iterator>
+    void table(Iterator begin, Iterator end) {
+        write_header(begin, end, "[", "]\n");
+    }
+
+    template<class Iterator>
+    void array_table(Iterator begin, Iterator end) {
+        write_header(begin, end, "[[", "]]\n");
+    }
+
+    //! Keys consisting of letters, digits, '_' and '-' are written bare, others are quoted.
+    void key(string_view_t key) {
+        if (!m_sequences.empty()) {
+            assert(m_sequences.back().type == sequence_type_t::inline_table);
+
+            if (m_sequences.back().items++ > 0) {
+                write_raw(", ");
+            }
+        }
+
+        write_key(key);
+        write_raw(" = ");
+    }
+
+    void start_array() {
+        value_prefix();
+        m_sequences.push_back(sequence_state_t{sequence_type_t::array, 0});
+        m_output.push_back('[');
+    }
+
+    void finish_array(std::size_t) {
+        m_sequences.pop_back();
+        m_output.push_back(']');
+        value_suffix();
+    }
+
+    void start_inline_table() {
+        value_prefix();
+        m_sequences.push_back(sequence_state_t{sequence_type_t::inline_table, 0});
+        m_output.push_back('{');
+    }
+
+    void finish_inline_table(std::size_t) {
+        m_sequences.pop_back();
+        m_output.push_back('}');
+        value_suffix();
+    }
+
+    void boolean(bool value) {
+        value_prefix();
+        write_raw(value ? string_view_t("true", 4) : string_view_t("false", 5));
+        value_suffix();
+    }
+
+    void string(string_view_t value) {
+        value_prefix();
+        write_string(value);
+        value_suffix();
+    }
+
+    //! Writes the datetime as is. It must be in the TOML format.
+    void datetime(string_view_t value) {
+        value_prefix();
+        write_raw(value);
+        value_suffix();
+    }
+
+    void integer(std::int64_t value) {
+        value_prefix();
+
+        char buffer[detail::max_number_size];
+        char *begin = detail::format_integer(value, buffer + sizeof(buffer));
+        m_output.append(begin, static_cast<std::size_t>(buffer + sizeof(buffer) - begin));
+
+        value_suffix();
+    }
+
+    //! \throws std::invalid_argument if the value is infinite or NaN, since TOML can't represent them.
+    void floating_point(double value) {
+        if (!std::isfinite(value)) {
+            throw std::invalid_argument("loltoml: TOML doesn't support infinite and NaN floats");
+        }
+
+        value_prefix();
+
+        char buffer[detail::max_number_size];
+        m_output.append(buffer, detail::format_double(value, buffer));
+
+        value_suffix();
+    }
+
+private:
+    enum class sequence_type_t {
+        array,
+        inline_table
+    };
+
+    struct sequence_state_t {
+        sequence_type_t type;
+        std::size_t items;
+    };
+
+    void value_prefix() {
+        if (!m_sequences.empty() && m_sequences.back().type == sequence_type_t::array) {
+            if (m_sequences.back().items++ > 0) {
+                write_raw(", ");
+            }
+        }
+    }
+
+    void value_suffix() {
+        if (m_sequences.empty()) {
+            m_output.push_back('\n');
+            m_has_content = true;
+        }
+    }
+
+    template<class Iterator>
+    void write_header(Iterator begin, Iterator end, const char *open, const char *close) {
+        assert(m_sequences.empty());
+
+        // Separate tables with empty lines.
+        if (m_has_content) {
+            m_output.push_back('\n');
+        }
+
+        write_raw(open);
+
+        for (Iterator it = begin; it != end; ++it) {
+            if (it != begin) {
+                m_output.push_back('.');
+            }
+
+            write_key(detail::path_key_text(*it));
+        }
+
+        write_raw(close);
+        m_has_content = true;
+    }
+
+    void write_key(string_view_t key) {
+        if (!key.empty() && std::all_of(key.data(), key.data() + key.size(), detail::is_key_character)) {
+            write_raw(key);
+        } else {
+            write_string(key);
+        }
+    }
+
+    void write_string(string_view_t value) {
+        const char *it = value.data();
+        const char *end = value.data() + value.size();
+
+        m_output.push_back('"');
+
+        while (true) {
+            const char *special = detail::scan_basic_string(it, end);
+            m_output.append(it, static_cast<std::size_t>(special - it));
+
+            if (special == end) {
+                break;
+            }
+
+            write_escaped(*special);
+            it = special + 1;
+        }
+
+        m_output.push_back('"');
+    }
+
+    void write_escaped(char ch) {
+        char escaped[6] = {'\\', 0, 0, 0, 0, 0};
+
+        switch (ch) {
+            case '"': escaped[1] = '"'; break;
+            case '\\': escaped[1] = '\\'; break;
+            case '\b': escaped[1] = 'b'; break;
+            case '\t': escaped[1] = 't'; break;
+            case '\n': escaped[1] = 'n'; break;
+            case '\f': escaped[1] = 'f'; break;
+            case '\r': escaped[1] = 'r'; break;
+            default: {
+                const char *hex_digits = "0123456789abcdef";
+                unsigned char code = static_cast<unsigned char>(ch);
+
+                escaped[1] = 'u';
+                escaped[2] = '0';
+                escaped[3] = '0';
+                escaped[4] = hex_digits[code / 16];
+                escaped[5] = hex_digits[code % 16];
+
+                m_output.append(escaped, 6);
+            } return;
+        }
+
+        m_output.append(escaped, 2);
+    }
+
+    void write_raw(string_view_t text) {
+        m_output.append(text.data(), text.size());
+    }
+
+    detail::writer_output_t<Output> m_output;
+    std::vector<sequence_state_t> m_sequences;
+    bool m_has_content;
+};
+
+
+/*! Create a writer emitting to the output iterator.
+ *
+ * \code
+ * auto writer = loltoml::make_writer(std::ostreambuf_iterator<char>(std::cout));
+ * \endcode
+ */
+template<class OutputIterator>
+inline writer_t<OutputIterator> make_writer(OutputIterator output) {
+    return writer_t<OutputIterator>(output);
+}
+
+
+LOLTOML_CLOSE_NAMESPACE
+
+#endif // LOLTOML_WRITER_HPP
@@ -0,0 +1,238 @@
+#include "common.hpp"
+
+#include "loltoml/parser.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+struct allocations_t {
+    std::size_t count = 0;
+    std::size_t bytes = 0;
+    std::size_t live = 0;
+};
+
+
+// Counts the allocations in the shared counters, like a tracked budget of a request would.
+template<class T>
+struct counting_allocator_t {
+    typedef T value_type;
+
+    allocations_t *allocations;
+
+    explicit counting_allocator_t(allocations_t *allocations) :
+        allocations(allocations)
+    { }
+
+    template<class U>
+    counting_allocator_t(const counting_allocator_t<U> &other) :
+        allocations(other.allocations)
+    { }
+
+    T *allocate(std::size_t size) {
+        ++allocations->count;
+        ++allocations->live;
+        allocations->bytes += size * sizeof(T);
+        return std::allocator<T>().allocate(size);
+    }
+
+    void deallocate(T *pointer, std::size_t size) {
+        --allocations->live;
+        std::allocator<T>().deallocate(pointer, size);
+    }
+};
+
+template<class T, class U>
+bool operator==(const counting_allocator_t<T> &left, const counting_allocator_t<U> &right) {
+    return left.allocations == right.allocations;
+}
+
+template<class T, class U>
+bool operator!=(const counting_allocator_t<T> &left, const counting_allocator_t<U> &right) {
+    return !(left == right);
+}
+
+
+typedef counting_allocator_t<char> allocator_t;
+typedef loltoml::basic_parser_string_t<allocator_t> string_t;
+typedef loltoml::basic_key_iterator_t<allocator_t> key_iterator_t;
+
+
+// Accepts only strings with the allocator, so the test doesn't compile if the parser passes std::string.
+struct allocator_handler_t {
+    std::vector<sax_event_t> events;
+    // Allocators of the received strings.
+    std::vector<allocator_t> allocators;
+
+    void start_document() {
+        events.emplace_back(sax_event_t::start_document);
+    }
+
+    void finish_document() {
+        events.emplace_back(sax_event_t::finish_document);
+    }
+
+    void comment(const string_t &value) {
+        add_string(sax_event_t::comment, value);
+    }
+
+    void table(key_iterator_t begin, key_iterator_t end) {
+        add_path(sax_event_t::table, begin, end);
+    }
+
+    void array_table(key_iterator_t begin, key_iterator_t end) {
+        add_path(sax_event_t::table_array_item, begin, end);
+    }
+
+    void key(const string_t &value) {
+        add_string(sax_event_t::key, value);
+    }
+
+    void start_array() {
+        events.emplace_back(sax_event_t::start_array);
+    }
+
+    void finish_array(std::size_t size) {
+        events.emplace_back(sax_event_t::finish_array, size);
+    }
+
+    void start_inline_table() {
+        events.emplace_back(sax_event_t::start_inline_table);
+    }
+
+    void finish_inline_table(std::size_t size) {
+        events.emplace_back(sax_event_t::finish_inline_table, size);
+    }
+
+    void boolean(bool value) {
+        events.emplace_back(sax_event_t::boolean, value);
+    }
+
+    void string(const string_t &value) {
+        add_string(sax_event_t::string, value);
+    }
+
+    void datetime(const string_t &value) {
+        add_string(sax_event_t::datetime, value);
+    }
+
+    void integer(std::int64_t value) {
+        events.emplace_back(sax_event_t::integer, value);
+    }
+
+    void floating_point(double value) {
+        events.emplace_back(sax_event_t::floating_point, value);
+    }
+
+private:
+    void add_string(sax_event_t::type_t type, const string_t &value) {
+        events.emplace_back(type, std::string(value.data(), value.size()));
+        allocators.push_back(value.get_allocator());
+    }
+
+    void add_path(sax_event_t::type_t type, key_iterator_t begin, key_iterator_t end) {
+        std::vector<std::string> keys;
+
+        for (; begin != end; ++begin) {
+            keys.emplace_back(begin->data(), begin->size());
+            allocators.push_back(begin->get_allocator());
+        }
+
+        events.emplace_back(type, keys);
+    }
+};
+
+
+const std::string long_key(100, 'k');
+const std::string long_value(200, 'v');
+
+const std::string document =
+    "# comment\n"
+    "[" + long_key + ".\"quoted\\tkey\"]\n"
+    "s = \"escaped\\t" + long_value + "\"\n"
+    "a = [1, 2]\n"
+    "[[" + long_key + "]]\n"
+    "d = 1979-05-27T07:32:00Z\n";
+
+} // namespace
+
+
+TEST(Allocator, HandlerReceivesAllocatorStrings) {
+    allocations_t allocations;
+    allocator_handler_t handler;
+    loltoml::parse(document.data(), document.size(), handler, allocator_t(&allocations));
+
+    events_aggregator_t expected;
+    loltoml::parse(document.data(), document.size(), expected);
+
+    EXPECT_EQ(expected.events, handler.events);
+
+    for (auto it = handler.allocators.begin(); it != handler.allocators.end(); ++it) {
+        EXPECT_TRUE(*it == allocator_t(&allocations));
+    }
+
+    // The path keys and the unescaped string don't fit into small strings.
+    EXPECT_GE(allocations.bytes, long_key.size() + long_value.size());
+    EXPECT_EQ(0u, allocations.live);
+}
+
+TEST(Allocator, Stream) {
+    allocations_t allocations;
+    allocator_handler_t handler;
+    std::istringstream input(document);
+    loltoml::parse(input, handler, allocator_t(&allocations));
+
+    events_aggregator_t expected;
+    loltoml::parse(document.data(), document.size(), expected);
+
+    EXPECT_EQ(expected.events, handler.events);
+    EXPECT_GE(allocations.bytes, long_key.size() + long_value.size());
+    EXPECT_EQ(0u, allocations.live);
+}
+
+TEST(Allocator, ReusableParser) {
+    allocations_t allocations;
+    allocator_handler_t handler;
+
+    {
+        loltoml::parser_t<allocator_handler_t, allocator_t> parser(handler, allocator_t(&allocations));
+
+        parser.parse(document);
+        std::size_t count = allocations.count;
+        EXPECT_GT(count, 0u);
+
+        // The buffers are kept between the documents.
+        parser.parse(document);
+        EXPECT_EQ(count, allocations.count);
+    }
+
+    EXPECT_EQ(0u, allocations.live);
+}
+
+TEST(Allocator, Parallel) {
+    std::string input;
+
+    for (std::size_t i = 0; input.size() < 512 * 1024; ++i) {
+        input += "[" + long_key + std::to_string(i) + "]\ns = \"\\t" + long_value + "\"\n";
+    }
+
+    events_aggregator_t expected;
+    loltoml::parse(input.data(), input.size(), expected);
+
+    allocations_t allocations;
+    allocator_handler_t handler;
+
+    {
+        loltoml::parser_t<allocator_handler_t, allocator_t> parser(handler, allocator_t(&allocations));
+        parser.parse_parallel(input, 4);
+    }
+
+    EXPECT_EQ(expected.events, handler.events);
+    EXPECT_GT(allocations.count, 0u);
+    EXPECT_EQ(0u, allocations.live);
+}
@@ -0,0 +1,300 @@
+#include "generator.hpp"
+
+#include "loltoml/document.hpp"
+#include "loltoml/parser.hpp"
+#include "loltoml/writer.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Benchmarks of the parser. Each grammar path is measured on a document made mostly of it, whole documents
+ * on tests/documents/complex.toml and on synthetic documents (see generator.hpp) of every shape and of growing sizes.
+ * Every benchmark reports the throughput and the number of allocations per parsed document.
+ *
+ * Synthetic documents take up to 64 MB by default. Set LOLTOML_BENCH_MAX_SIZE (in bytes) to change it,
+ * e.g. to 524288000 for documents up to 500 MB.
+ */
+
+
+namespace {
+
+std::atomic<std::size_t> allocations(0);
+
+} // namespace
+
+
+// All the allocations of the process are counted to report them per document.
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *result = std::malloc(size == 0 ? 1 : size)) {
+        return result;
+    }
+
+    throw std::bad_alloc();
+}
+
+// Not inlined, otherwise compilers take malloc() and free() at call sites for a mismatch with new and delete.
+__attribute__((noinline)) void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+
+namespace {
+
+// Handler doing nothing but touching the values, so that the parser can't be optimized out.
+struct null_handler_t {
+    std::uint64_t checksum = 0;
+
+    void start_document() { }
+    void finish_document() { }
+
+    void comment(loltoml::string_view_t text) {
+        checksum += text.size();
+    }
+
+    void table(loltoml::key_iterator_t begin, loltoml::key_iterator_t end) {
+        checksum += static_cast<std::uint64_t>(end - begin);
+    }
+
+    void array_table(loltoml::key_iterator_t begin, loltoml::key_iterator_t end) {
+        checksum += static_cast<std::uint64_t>(end - begin);
+    }
+
+    void key(loltoml::string_view_t key) {
+        checksum += key.size();
+    }
+
+    void start_array() { }
+
+    void finish_array(std::size_t size) {
+        checksum += size;
+    }
+
+    void start_inline_table() { }
+
+    void finish_inline_table(std::size_t size) {
+        checksum += size;
+    }
+
+    void boolean(bool value) {
+        checksum += value;
+    }
+
+    void string(loltoml::string_view_t value) {
+        checksum += value.size();
+    }
+
+    void datetime(loltoml::string_view_t value) {
+        checksum += value.size();
+    }
+
+    void integer(std::int64_t value) {
+        checksum += static_cast<std::uint64_t>(value);
+    }
+
+    void floating_point(double value) {
+        checksum += static_cast<std::uint64_t>(value != 0);
+    }
+};
+
+
+// Appends line(i) for i = 0, 1, ... until the document reaches the size.
+std::string repeat_lines(std::size_t size, const std::function<void(std::string &, std::size_t)> &line) {
+    std::string result;
+    result.reserve(size + 256);
+
+    for (std::size_t i = 0; result.size() < size; ++i) {
+        line(result, i);
+    }
+
+    return result;
+}
+
+std::string number(std::size_t value) {
+    return std::to_string(value);
+}
+
+std::string float_number(double value) {
+    char buffer[loltoml::detail::max_number_size];
+    return std::string(buffer, loltoml::detail::format_double(value, buffer));
+}
+
+// Documents made mostly of one grammar path. Keys are numbered to stay unique.
+const std::map<std::string, std::function<void(std::string &, std::size_t)>> &grammar_paths() {
+    static const std::map<std::string, std::function<void(std::string &, std::size_t)>> paths = {
+        {"keys", [](std::string &output, std::size_t i) {
+            output += "some_configuration_key_" + number(i) + " = true\n";
+        }},
+        {"basic_strings", [](std::string &output, std::size_t i) {
+            output += "s" + number(i) + " = \"The quick brown fox jumps over the lazy dog. "
+                      "Escapes\\tand \\\"quotes\\\" and \\u00e9 are rare.\"\n";
+        }},
+        {"multiline_strings", [](std::string &output, std::size_t i) {
+            output += "s" + number(i) + " = \"\"\"\n"
+                      "The quick brown fox\n"
+                      "jumps over the lazy dog, \\\n"
+                      "    twice.\"\"\"\n";
+        }},
+        {"literal_strings", [](std::string &output, std::size_t i) {
+            output += "s" + number(i) + " = 'C:\\Users\\nodejs\\templates\\with\\backslashes'\n";
+        }},
+        {"integers", [](std::string &output, std::size_t i) {
+            output += "i" + number(i) + " = " + number(i * 2654435761u % 1000000000000ull) + "\n";
+        }},
+        {"floats", [](std::string &output, std::size_t i) {
+            output += "f" + number(i) + " = " + float_number(static_cast<double>(i) * 0.7071 - 12345.678) + "\n";
+        }},
+        {"datetimes", [](std::string &output, std::size_t i) {
+            output += "d" + number(i) + " = 19" + number(10 + i % 90) + "-05-27T07:32:00." + number(100000 + i % 900000) +
+                      "-07:00\n";
+        }},
+        {"arrays", [](std::string &output, std::size_t i) {
+            output += "a" + number(i) + " = [ [1, 2, 3], [\"a\", \"b\"], [[4], [5, 6]], [] ]\n";
+        }},
+        {"inline_tables", [](std::string &output, std::size_t i) {
+            output += "t" + number(i) + " = {x = 1, y = \"two\", z = {w = true, v = [1, 2]}}\n";
+        }},
+        {"table_headers", [](std::string &output, std::size_t i) {
+            output += "[section_" + number(i) + ".sub.\"quoted key\"]\n";
+        }}
+    };
+
+    return paths;
+}
+
+std::string read_file(const char *path) {
+    std::ifstream input(path, std::ios::binary);
+    std::ostringstream result;
+    result << input.rdbuf();
+    return result.str();
+}
+
+void report(benchmark::State &state, std::size_t document_size, std::size_t allocations_before) {
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * document_size));
+    state.counters["allocs/doc"] = benchmark::Counter(
+        static_cast<double>(allocations.load(std::memory_order_relaxed) - allocations_before),
+        benchmark::Counter::kAvgIterations
+    );
+}
+
+// Parsing with a reused parser_t, as services parsing many documents do.
+void parse_buffer(benchmark::State &state, const std::string &document) {
+    null_handler_t handler;
+    loltoml::parser_t<null_handler_t> parser(handler);
+    std::size_t allocations_before = allocations.load(std::memory_order_relaxed);
+
+    for (auto _ : state) {
+        parser.parse(document.data(), document.size());
+        benchmark::DoNotOptimize(handler.checksum);
+    }
+
+    report(state, document.size(), allocations_before);
+}
+
+void parse_stream(benchmark::State &state, const std::string &document) {
+    null_handler_t handler;
+    loltoml::parser_t<null_handler_t> parser(handler);
+    // The stream is created once and rewound, so copying the document isn't counted in allocs/doc.
+    std::istringstream input(document);
+    std::size_t allocations_before = allocations.load(std::memory_order_relaxed);
+
+    for (auto _ : state) {
+        input.clear();
+        input.seekg(0);
+
+        parser.parse(input);
+        benchmark::DoNotOptimize(handler.checksum);
+    }
+
+    report(state, document.size(), allocations_before);
+}
+
+void parse_document(benchmark::State &state, const std::string &document) {
+    loltoml::document_t dom;
+    std::size_t allocations_before = allocations.load(std::memory_order_relaxed);
+
+    for (auto _ : state) {
+        dom.parse(document.data(), document.size());
+        benchmark::DoNotOptimize(dom.root().as_table().size());
+    }
+
+    report(state, document.size(), allocations_before);
+}
+
+// The documents are generated once and kept for the whole run.
+const std::string &keep(std::string document) {
+    static std::map<std::size_t, std::string> documents;
+    std::size_t id = documents.size();
+    return documents[id] = std::move(document);
+}
+
+} // namespace
+
+
+int main(int argc, char **argv) {
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    const std::size_t grammar_document_size = 1 << 20;
+
+    for (auto it = grammar_paths().begin(); it != grammar_paths().end(); ++it) {
+        const std::string &document = keep(repeat_lines(grammar_document_size, it->second));
+        benchmark::RegisterBenchmark(("grammar/" + it->first).c_str(), parse_buffer, document);
+    }
+
+    const std::string &complex = keep(read_file(TESTS_ROOT "documents/complex.toml"));
+    benchmark::RegisterBenchmark("complex/buffer", parse_buffer, complex);
+    benchmark::RegisterBenchmark("complex/stream", parse_stream, complex);
+    benchmark::RegisterBenchmark("complex/document", parse_document, complex);
+
+    // Every shape of synthetic documents.
+    for (std::size_t i = 1; i < document_generator_t::shapes_count; ++i) {
+        document_generator_t::shape_t shape = static_cast<document_generator_t::shape_t>(i);
+        const std::string &document = keep(document_generator_t(shape).generate(8 << 20));
+
+        benchmark::RegisterBenchmark(
+            (std::string("shapes/") + document_generator_t::shape_name(shape)).c_str(),
+            parse_buffer,
+            document
+        );
+    }
+
+    // Scaling with the size of the document.
+    std::size_t max_size = 64 << 20;
+    if (const char *value = std::getenv("LOLTOML_BENCH_MAX_SIZE")) {
+        max_size = std::strtoull(value, nullptr, 10);
+    }
+
+    std::vector<std::size_t> sizes;
+    for (std::size_t size = 1 << 10; size < max_size; size *= 8) {
+        sizes.push_back(size);
+    }
+    sizes.push_back(max_size);
+
+    for (auto it = sizes.begin(); it != sizes.end(); ++it) {
+        const std::string &document = keep(document_generator_t(document_generator_t::shape_t::mixed).generate(*it));
+        std::string suffix = "/" + number(*it >> 10) + "KB";
+
+        benchmark::RegisterBenchmark(("synthetic/buffer" + suffix).c_str(), parse_buffer, document);
+        benchmark::RegisterBenchmark(("synthetic/document" + suffix).c_str(), parse_document, document);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
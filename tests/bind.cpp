@@ -0,0 +1,163 @@
+#include "common.hpp"
+
+#include "loltoml/bind.hpp"
+
+#include <sstream>
+
+
+namespace {
+
+struct server_t {
+    std::string host;
+    std::uint16_t port;
+    std::vector<std::string> aliases;
+
+    server_t() :
+        port(0)
+    { }
+};
+
+LOLTOML_BIND(server_t, host, port, aliases)
+
+struct limits_t {
+    std::int32_t connections;
+    double ratio;
+    float timeout;
+
+    limits_t() :
+        connections(-1),
+        ratio(0),
+        timeout(0)
+    { }
+};
+
+LOLTOML_BIND(limits_t, connections, ratio, timeout)
+
+struct config_t {
+    std::string name;
+    bool debug;
+    std::string started;
+    std::vector<std::int64_t> ids;
+    std::vector<std::vector<std::int64_t>> matrix;
+    limits_t limits;
+    std::vector<server_t> servers;
+
+    config_t() :
+        debug(false)
+    { }
+};
+
+LOLTOML_BIND(config_t, name, debug, started, ids, matrix, limits, servers)
+
+std::size_t error_offset(const std::string &input) {
+    config_t config;
+
+    try {
+        loltoml::parse_into(input, config);
+    } catch (const loltoml::parser_error_t &e) {
+        return e.offset();
+    }
+
+    ADD_FAILURE() << "No error in " << input;
+    return 0;
+}
+
+} // namespace
+
+
+TEST(Bind, Struct) {
+    const char *input =
+        "name = \"test\"\n"
+        "debug = true\n"
+        "started = 1979-05-27T07:32:00Z\n"
+        "ids = [1, 2, 3]\n"
+        "matrix = [[1], [2, 3]]\n"
+        "unknown = {a = [{b = 1}], c = [[1]]}\n"
+        "\n"
+        "[limits]\n"
+        "connections = 100\n"
+        "ratio = 0.5\n"
+        "timeout = 3\n"
+        "\n"
+        "[[servers]]\n"
+        "host = \"alpha\"\n"
+        "port = 8080\n"
+        "aliases = [\"a\", \"b\"]\n"
+        "\n"
+        "[[servers]]\n"
+        "host = \"beta\"\n"
+        "\n"
+        "[unknown_table.x]\n"
+        "y = 1\n";
+
+    config_t config;
+    loltoml::parse_into(loltoml::string_view_t(input), config);
+
+    EXPECT_EQ("test", config.name);
+    EXPECT_TRUE(config.debug);
+    EXPECT_EQ("1979-05-27T07:32:00Z", config.started);
+    EXPECT_EQ(std::vector<std::int64_t>({1, 2, 3}), config.ids);
+    EXPECT_EQ(std::vector<std::vector<std::int64_t>>({{1}, {2, 3}}), config.matrix);
+    EXPECT_EQ(100, config.limits.connections);
+    EXPECT_EQ(0.5, config.limits.ratio);
+    EXPECT_EQ(3.0f, config.limits.timeout);
+
+    ASSERT_EQ(2u, config.servers.size());
+    EXPECT_EQ("alpha", config.servers[0].host);
+    EXPECT_EQ(8080, config.servers[0].port);
+    EXPECT_EQ(std::vector<std::string>({"a", "b"}), config.servers[0].aliases);
+    EXPECT_EQ("beta", config.servers[1].host);
+    EXPECT_EQ(0, config.servers[1].port);
+}
+
+TEST(Bind, Stream) {
+    std::istringstream input("[limits]\nconnections = 5\n[[servers]]\n[servers.x]\n[[servers]]\nport = 1");
+
+    config_t config;
+    loltoml::parse_into(input, config);
+
+    EXPECT_EQ(5, config.limits.connections);
+    ASSERT_EQ(2u, config.servers.size());
+    EXPECT_EQ(1, config.servers[1].port);
+}
+
+TEST(Bind, MissingMembersKeepValues) {
+    config_t config;
+    config.name = "default";
+
+    loltoml::parse_into(loltoml::string_view_t("debug = true"), config);
+
+    EXPECT_EQ("default", config.name);
+    EXPECT_EQ(-1, config.limits.connections);
+}
+
+TEST(Bind, UnknownValuesAreSkipped) {
+    config_t config;
+
+    // The array is invalid, but it's not parsed.
+    loltoml::parse_into(loltoml::string_view_t("unknown = [1, \"x\", 1.0e1000]\nname = \"test\""), config);
+
+    EXPECT_EQ("test", config.name);
+}
+
+TEST(Bind, TypeMismatch) {
+    // Errors point right after the offending value.
+    EXPECT_EQ(8u, error_offset("name = 1"));
+    EXPECT_EQ(13u, error_offset("debug = \"yes\""));
+    EXPECT_EQ(10u, error_offset("ids = [\"a\"]"));
+    EXPECT_EQ(8u, error_offset("name = [1]"));
+    EXPECT_EQ(6u, error_offset("[name]"));
+    EXPECT_EQ(10u, error_offset("[[limits]]"));
+    EXPECT_EQ(11u, error_offset("[servers.x]"));
+    EXPECT_EQ(10u, error_offset("limits = 1"));
+}
+
+TEST(Bind, IntegerRange) {
+    EXPECT_NE(0u, error_offset("[[servers]]\nport = 65536"));
+    EXPECT_NE(0u, error_offset("[[servers]]\nport = -1"));
+    EXPECT_NE(0u, error_offset("[limits]\nconnections = 2147483648"));
+
+    config_t config;
+    loltoml::parse_into(loltoml::string_view_t("[limits]\nconnections = -2147483648"), config);
+    EXPECT_EQ(-2147483647 - 1, config.limits.connections);
+}
@@ -0,0 +1,136 @@
+#include "common.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+
+namespace {
+    // Parses the document both from a stream and from a buffer and checks that the results are the same.
+    void test_same_as_stream(const std::string &document) {
+        std::string scope = "parse '" + escape_string(document) + "'";
+        SCOPED_TRACE(scope);
+
+        std::istringstream input(document);
+        events_aggregator_t stream_handler;
+        std::string stream_error;
+        std::size_t stream_offset = 0;
+
+        try {
+            loltoml::parse(input, stream_handler);
+        } catch (const loltoml::parser_error_t &e) {
+            stream_error = e.message();
+            stream_offset = e.offset();
+        }
+
+        events_aggregator_t buffer_handler;
+        std::string buffer_error;
+        std::size_t buffer_offset = 0;
+
+        try {
+            loltoml::parse(document.data(), document.size(), buffer_handler);
+        } catch (const loltoml::parser_error_t &e) {
+            buffer_error = e.message();
+            buffer_offset = e.offset();
+        }
+
+        EXPECT_EQ(stream_handler.events, buffer_handler.events);
+        EXPECT_EQ(stream_error, buffer_error);
+        EXPECT_EQ(stream_offset, buffer_offset);
+    }
+}
+
+
+TEST(Buffer, Simple) {
+    std::string input = "key = \"value\"\n[table]\nnumber = 3.5 # comment\n";
+    events_aggregator_t handler;
+
+    loltoml::parse(input.data(), input.size(), handler);
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::key, "key"},
+        {sax_event_t::string, "value"},
+        {sax_event_t::table, {"table"}},
+        {sax_event_t::key, "number"},
+        {sax_event_t::floating_point, 3.5},
+        {sax_event_t::comment, " comment"},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+}
+
+TEST(Buffer, StringView) {
+    events_aggregator_t handler;
+
+    loltoml::parse(loltoml::string_view_t("key = [1, 2]"), handler);
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::key, "key"},
+        {sax_event_t::start_array},
+        {sax_event_t::integer, 1},
+        {sax_event_t::integer, 2},
+        {sax_event_t::finish_array, 2},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+}
+
+TEST(Buffer, DoesNotReadPastTheEnd) {
+    std::string input = "key = 12345";
+    events_aggregator_t handler;
+
+    loltoml::parse(input.data(), 8, handler);
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::key, "key"},
+        {sax_event_t::integer, 12},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+}
+
+TEST(Buffer, SameAsStream) {
+    test_same_as_stream("");
+    test_same_as_stream("\n\r\n");
+    test_same_as_stream("a = 1");
+    test_same_as_stream("a = 1\n");
+    test_same_as_stream("a = \"1\"");
+    test_same_as_stream("a = '1'\r\n");
+    test_same_as_stream("a = \"\"\"\nx\\\n  y\"\"\"");
+    test_same_as_stream("a = '''\nx\ny'''");
+    test_same_as_stream("a = [1, 2, [3]]  # comment");
+    test_same_as_stream("a = {b = true, c = 1979-05-27T07:32:00Z}");
+    test_same_as_stream("[a.\"b\".c]\n[[d]]");
+    test_same_as_stream("a = 1e10\nb = -0.5\nc = +3_000");
+}
+
+TEST(Buffer, SameErrorsAsStream) {
+    test_same_as_stream("a");
+    test_same_as_stream("a =");
+    test_same_as_stream("a = \"abc");
+    test_same_as_stream("a = \"\"\"abc");
+    test_same_as_stream("a = '''abc''");
+    test_same_as_stream("a = [1, 2");
+    test_same_as_stream("a = {b = 1");
+    test_same_as_stream("[a");
+    test_same_as_stream("[[a]");
+    test_same_as_stream("a = 1 b = 2");
+    test_same_as_stream("a = 1979-05-27T07:32");
+    test_same_as_stream("a = 99999999999999999999");
+    test_same_as_stream("a = 01");
+    test_same_as_stream("a = \"\\x\"");
+}
+
+TEST(Buffer, ComplexDocument) {
+    std::ifstream file(TESTS_ROOT "documents/complex.toml");
+    std::string document((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    ASSERT_FALSE(document.empty());
+    test_same_as_stream(document);
+}
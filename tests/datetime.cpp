@@ -1,5 +1,8 @@
 #include "common.hpp"
 
+#include "loltoml/datetime.hpp"
+#include "loltoml/detail/parallel.hpp"
+
 #include <sstream>
 
 
@@ -32,6 +35,55 @@ namespace {
 
         EXPECT_THROW(loltoml::parse(input, handler), loltoml::parser_error_t);
     }
+
+    // Receives datetimes as fields and ignores everything else.
+    struct fields_handler_t {
+        std::vector<loltoml::datetime_t> values;
+
+        void start_document() { }
+        void finish_document() { }
+        void comment(loltoml::string_view_t) { }
+        void table(loltoml::key_iterator_t, loltoml::key_iterator_t) { }
+        void array_table(loltoml::key_iterator_t, loltoml::key_iterator_t) { }
+        void key(loltoml::string_view_t) { }
+        void start_array() { }
+        void finish_array(std::size_t) { }
+        void start_inline_table() { }
+        void finish_inline_table(std::size_t) { }
+        void boolean(bool) { }
+        void string(loltoml::string_view_t) { }
+        void integer(std::int64_t) { }
+        void floating_point(double) { }
+
+        void datetime(const loltoml::datetime_t &value) {
+            values.push_back(value);
+        }
+    };
+
+    loltoml::datetime_t parse_fields(const std::string &str) {
+        std::string input = "key = " + str;
+        fields_handler_t handler;
+
+        loltoml::parse(input, handler);
+
+        EXPECT_EQ(1, handler.values.size());
+        return handler.values.empty() ? loltoml::datetime_t() : handler.values.front();
+    }
+
+    void test_fields_error(const std::string &str, std::size_t expected_offset) {
+        std::string scope = "test error when parse fields of '" + str + "'";
+        SCOPED_TRACE(scope);
+
+        std::istringstream input("key = " + str);
+        fields_handler_t handler;
+
+        try {
+            loltoml::parse(input, handler);
+            ADD_FAILURE() << "Expected parser_error_t";
+        } catch (const loltoml::parser_error_t &error) {
+            EXPECT_EQ(6 + expected_offset, error.offset());
+        }
+    }
 }
 
 
@@ -55,6 +107,26 @@ TEST(Datetime, FractionalSeconds) {
     test_parsing("1971-11-11t00:11:01.090239z");
 }
 
+TEST(Datetime, LongFraction) {
+    const std::string fraction(2000, '7');
+
+    std::istringstream input("key = 1979-05-27T07:32:00." + fraction + "Z");
+    events_aggregator_t handler;
+
+    loltoml::parse(input, handler);
+
+    // Digits beyond the buffer are dropped from the string.
+    ASSERT_EQ(4, handler.events.size());
+    std::string value = handler.events[2].string_data;
+    EXPECT_EQ(795, value.size());
+    EXPECT_EQ("1979-05-27T07:32:00.777", value.substr(0, 23));
+    EXPECT_EQ("7Z", value.substr(value.size() - 2));
+
+    loltoml::datetime_t fields = parse_fields("1979-05-27T07:32:00." + fraction + "+01:30");
+    EXPECT_EQ(777777777, fields.nanoseconds);
+    EXPECT_EQ(90, fields.offset_minutes);
+}
+
 TEST(Datetime, TimezoneCannotBeOmitted) {
     test_error("1111-11-11T00:11:01.0");
     test_error("0014-00-00t03:21:91");
@@ -89,3 +161,90 @@ TEST(Datetime, TCannotBeOmitted) {
     test_error("1971-11-11 00:11:01.090239+32:33");
     test_error("1971-11-11 00:11:01.090239z");
 }
+
+TEST(Datetime, Fields) {
+    loltoml::datetime_t value = parse_fields("1979-05-27T07:32:01Z");
+    EXPECT_EQ(1979, value.year);
+    EXPECT_EQ(5, value.month);
+    EXPECT_EQ(27, value.day);
+    EXPECT_EQ(7, value.hour);
+    EXPECT_EQ(32, value.minute);
+    EXPECT_EQ(1, value.second);
+    EXPECT_EQ(0, value.nanoseconds);
+    EXPECT_EQ(0, value.offset_minutes);
+
+    value = parse_fields("1979-05-27t00:32:00.999999-07:30");
+    EXPECT_EQ(0, value.hour);
+    EXPECT_EQ(999999000, value.nanoseconds);
+    EXPECT_EQ(-450, value.offset_minutes);
+
+    value = parse_fields("2000-02-29T23:59:60.1234567891+14:00");
+    EXPECT_EQ(29, value.day);
+    EXPECT_EQ(60, value.second);
+    EXPECT_EQ(123456789, value.nanoseconds);
+    EXPECT_EQ(840, value.offset_minutes);
+}
+
+TEST(Datetime, FieldsInArraysAndStreams) {
+    std::istringstream input("a = [1979-05-27T07:32:01Z, 1980-01-01T00:00:00.5z]");
+    fields_handler_t handler;
+
+    loltoml::parse(input, handler);
+
+    ASSERT_EQ(2, handler.values.size());
+    EXPECT_EQ(1979, handler.values[0].year);
+    EXPECT_EQ(1980, handler.values[1].year);
+    EXPECT_EQ(500000000, handler.values[1].nanoseconds);
+}
+
+TEST(Datetime, FieldsOutOfRange) {
+    test_fields_error("0014-00-01T03:21:01Z", 5);
+    test_fields_error("1971-13-11T00:11:01Z", 5);
+    test_fields_error("1971-11-00T00:11:01Z", 8);
+    test_fields_error("1971-11-31T00:11:01Z", 8);
+    test_fields_error("1900-02-29T00:11:01Z", 8);
+    test_fields_error("1971-11-11T24:11:01Z", 11);
+    test_fields_error("1971-11-11T00:60:01Z", 14);
+    test_fields_error("1971-11-11T00:11:61Z", 17);
+    test_fields_error("1971-11-11T00:11:01.5+24:00", 21);
+    test_fields_error("1971-11-11T00:11:01-01:60", 19);
+}
+
+TEST(Datetime, FieldsFromParallelParser) {
+    std::string input;
+
+    for (std::size_t i = 0; i < 50; ++i) {
+        input += "[table" + std::to_string(i) + "]\nkey = 1979-05-27T07:32:01Z\n";
+    }
+
+    fields_handler_t handler;
+    loltoml::detail::parser_buffers_t buffers;
+    loltoml::detail::parse_parallel(input.data(), input.size(), handler, buffers, 4, 100);
+
+    ASSERT_EQ(50, handler.values.size());
+    EXPECT_EQ(27, handler.values.back().day);
+
+    input += "[last]\nkey = 1979-02-30T07:32:01Z\n";
+
+    try {
+        loltoml::detail::parse_parallel(input.data(), input.size(), handler, buffers, 4, 100);
+        ADD_FAILURE() << "Expected parser_error_t";
+    } catch (const loltoml::parser_error_t &error) {
+        EXPECT_EQ(input.size() - 13, error.offset());
+    }
+}
+
+TEST(Datetime, ToTimePoint) {
+    using namespace std::chrono;
+
+    EXPECT_EQ(0, duration_cast<seconds>(loltoml::to_time_point(parse_fields("1970-01-01T00:00:00Z")).time_since_epoch()).count());
+    EXPECT_EQ(296638321, duration_cast<seconds>(loltoml::to_time_point(parse_fields("1979-05-27T07:32:01Z")).time_since_epoch()).count());
+    EXPECT_EQ(296638321, duration_cast<seconds>(loltoml::to_time_point(parse_fields("1979-05-27T00:02:01-07:30")).time_since_epoch()).count());
+    EXPECT_EQ(951868800, duration_cast<seconds>(loltoml::to_time_point(parse_fields("2000-03-01T00:00:00Z")).time_since_epoch()).count());
+    EXPECT_EQ(-86400, duration_cast<seconds>(loltoml::to_time_point(parse_fields("1969-12-31T00:00:00Z")).time_since_epoch()).count());
+    EXPECT_EQ(1500, duration_cast<milliseconds>(loltoml::to_time_point(parse_fields("1970-01-01T00:00:01.5Z")).time_since_epoch()).count());
+}
+
+TEST(Datetime, StringsAreNotRangeChecked) {
+    test_parsing("1971-02-31T25:61:61+99:99");
+}
@@ -0,0 +1,206 @@
+#include "common.hpp"
+
+#include "loltoml/document.hpp"
+
+#include <fstream>
+#include <sstream>
+
+
+namespace {
+    void test_error(const std::string &str) {
+        std::string scope = "test error when parse '" + str + "'";
+        SCOPED_TRACE(scope);
+
+        loltoml::document_t document;
+
+        EXPECT_THROW(document.parse(str), loltoml::parser_error_t);
+        EXPECT_TRUE(document.root().as_table().empty());
+    }
+}
+
+
+TEST(Document, Scalars) {
+    loltoml::document_t document;
+    document.parse(loltoml::string_view_t(
+        "s = \"string\"\ni = 42\nf = 1.5\nb = true\nd = 1979-05-27T07:32:00Z\n"
+    ));
+
+    loltoml::table_t root = document.root().as_table();
+    ASSERT_EQ(5, root.size());
+
+    EXPECT_EQ("string", root.find("s")->as_string());
+    EXPECT_EQ(42, root.find("i")->as_integer());
+    EXPECT_EQ(1.5, root.find("f")->as_floating_point());
+    EXPECT_TRUE(root.find("b")->as_boolean());
+    EXPECT_EQ("1979-05-27T07:32:00Z", root.find("d")->as_datetime());
+    EXPECT_EQ(nullptr, root.find("x"));
+
+    std::vector<std::string> keys;
+    for (auto it = root.begin(); it != root.end(); ++it) {
+        keys.push_back(it->key.to_string());
+    }
+
+    std::vector<std::string> expected_keys = {"s", "i", "f", "b", "d"};
+    EXPECT_EQ(expected_keys, keys);
+}
+
+TEST(Document, Containers) {
+    loltoml::document_t document;
+    document.parse(loltoml::string_view_t(
+        "a = [[1, 2], [\"x\"]]\n"
+        "t = {x = 1, y = {z = [{w = 2}]}}\n"
+        "[table.sub]\n"
+        "k = 'v'\n"
+        "[[items]]\n"
+        "n = 1\n"
+        "[items.inner]\n"
+        "m = 2\n"
+        "[[items]]\n"
+        "n = 3\n"
+        "[table]\n"
+        "l = 4\n"
+    ));
+
+    loltoml::table_t root = document.root().as_table();
+
+    loltoml::array_t a = root.find("a")->as_array();
+    ASSERT_EQ(2, a.size());
+    EXPECT_EQ(2, a[0].as_array()[1].as_integer());
+    EXPECT_EQ("x", a[1].as_array()[0].as_string());
+
+    const loltoml::value_t *t = root.find("t");
+    EXPECT_EQ(1, t->as_table().find("x")->as_integer());
+    loltoml::array_t z = t->as_table().find("y")->as_table().find("z")->as_array();
+    ASSERT_EQ(1, z.size());
+    EXPECT_EQ(2, z[0].as_table().find("w")->as_integer());
+
+    loltoml::table_t table = root.find("table")->as_table();
+    EXPECT_EQ("v", table.find("sub")->as_table().find("k")->as_string());
+    EXPECT_EQ(4, table.find("l")->as_integer());
+
+    loltoml::array_t items = root.find("items")->as_array();
+    ASSERT_EQ(2, items.size());
+    EXPECT_EQ(1, items[0].as_table().find("n")->as_integer());
+    EXPECT_EQ(2, items[0].as_table().find("inner")->as_table().find("m")->as_integer());
+    EXPECT_EQ(3, items[1].as_table().find("n")->as_integer());
+    EXPECT_EQ(nullptr, items[1].as_table().find("inner"));
+}
+
+TEST(Document, ComplexDocument) {
+    std::ifstream input(TESTS_ROOT "documents/complex.toml");
+    loltoml::document_t document;
+
+    document.parse(input);
+
+    loltoml::table_t root = document.root().as_table();
+    EXPECT_EQ(1323, root.find("key1")->as_integer());
+    EXPECT_EQ("another value",
+              root.find("table")->as_table().find("subtable")->as_table().find("key")->as_string());
+    EXPECT_TRUE(root.find("x")->as_table().find("y")->as_table().find("z")->as_table().find("w")->is_table());
+}
+
+TEST(Document, ManyValues) {
+    std::string input;
+    for (int i = 0; i < 10000; ++i) {
+        input += "[t" + std::to_string(i) + "]\nkey = \"" + std::string(i % 50, 'x') + "\"\n";
+        input += "array = [" + std::to_string(i) + ", 1, 2]\n";
+    }
+
+    loltoml::document_t document;
+    document.parse(input);
+
+    loltoml::table_t root = document.root().as_table();
+    ASSERT_EQ(10000, root.size());
+
+    for (int i = 0; i < 10000; i += 997) {
+        loltoml::table_t table = root.find("t" + std::to_string(i))->as_table();
+        EXPECT_EQ(std::string(i % 50, 'x'), table.find("key")->as_string());
+        EXPECT_EQ(i, table.find("array")->as_array()[0].as_integer());
+    }
+}
+
+TEST(Document, ManySubtables) {
+    std::string input;
+    for (int i = 0; i < 40000; ++i) {
+        input += "[t.k" + std::to_string(i) + "]\nv = " + std::to_string(i) + "\n";
+    }
+
+    loltoml::document_t document;
+    document.parse(input);
+
+    loltoml::table_t t = document.root().as_table().find("t")->as_table();
+    ASSERT_EQ(40000, t.size());
+
+    for (int i = 0; i < 40000; ++i) {
+        const loltoml::value_t *table = t.find("k" + std::to_string(i));
+        ASSERT_NE(nullptr, table);
+        EXPECT_EQ(i, table->as_table().find("v")->as_integer());
+    }
+
+    EXPECT_EQ(nullptr, t.find("k40000"));
+    EXPECT_EQ(nullptr, t.find(""));
+
+    // Members are still iterated in order of definition.
+    int expected = 0;
+    for (auto it = t.begin(); it != t.end(); ++it, ++expected) {
+        EXPECT_EQ("k" + std::to_string(expected), it->key);
+    }
+}
+
+TEST(Document, ParseReplacesContent) {
+    loltoml::document_t document;
+    document.parse(loltoml::string_view_t("a = 1"));
+    document.parse(loltoml::string_view_t("b = 2"));
+
+    loltoml::table_t root = document.root().as_table();
+    ASSERT_EQ(1, root.size());
+    EXPECT_EQ(2, root.find("b")->as_integer());
+
+    document.clear();
+    EXPECT_TRUE(document.root().as_table().empty());
+}
+
+TEST(Document, Move) {
+    loltoml::document_t document;
+    document.parse(loltoml::string_view_t("a = 'value'"));
+
+    loltoml::document_t other(std::move(document));
+    EXPECT_EQ("value", other.root().as_table().find("a")->as_string());
+    EXPECT_TRUE(document.root().as_table().empty());
+
+    document = std::move(other);
+    EXPECT_EQ("value", document.root().as_table().find("a")->as_string());
+}
+
+TEST(Document, DuplicateKeys) {
+    test_error("a = 1\na = 2");
+    test_error("a = {b = 1, b = 2}");
+    test_error("[a]\n[a]");
+    test_error("[a]\nb = 1\n[a.b]");
+    test_error("a = 1\n[a]");
+    test_error("a = {}\n[a]");
+    test_error("a = {}\n[a.b]");
+    test_error("a = []\n[[a]]");
+    test_error("[[a]]\n[a]");
+    test_error("[a]\n[[a]]");
+}
+
+TEST(Document, ErrorOffset) {
+    loltoml::document_t document;
+
+    try {
+        document.parse(loltoml::string_view_t("a = 1\na = 2"));
+        FAIL();
+    } catch (const loltoml::parser_error_t &e) {
+        EXPECT_EQ(6, e.offset());
+    }
+}
+
+TEST(Document, ImplicitTablesMayBeDefinedLater) {
+    loltoml::document_t document;
+    document.parse(loltoml::string_view_t("[a.b]\nc = 1\n[a]\nd = 2"));
+
+    loltoml::table_t a = document.root().as_table().find("a")->as_table();
+    EXPECT_EQ(1, a.find("b")->as_table().find("c")->as_integer());
+    EXPECT_EQ(2, a.find("d")->as_integer());
+}
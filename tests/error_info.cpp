@@ -0,0 +1,192 @@
+#include "common.hpp"
+
+#include "loltoml/parser.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+
+
+namespace {
+
+// The error reported by the throwing parse().
+loltoml::parser_error_t thrown_error(const std::string &input) {
+    events_aggregator_t handler;
+
+    try {
+        loltoml::parse(input, handler);
+    } catch (const loltoml::parser_error_t &e) {
+        return e;
+    }
+
+    return loltoml::parser_error_t(loltoml::error_code_t::none, "", 0);
+}
+
+} // namespace
+
+
+TEST(ErrorInfo, Valid) {
+    events_aggregator_t handler;
+    loltoml::error_info_t error;
+
+    EXPECT_TRUE(loltoml::parse(loltoml::string_view_t("a = 1\n"), handler, error));
+    EXPECT_FALSE(error);
+    EXPECT_EQ(loltoml::error_code_t::none, error.code);
+}
+
+TEST(ErrorInfo, Codes) {
+    struct test_t {
+        const char *input;
+        loltoml::error_code_t code;
+        std::size_t line;
+        std::size_t column;
+    };
+
+    const test_t tests[] = {
+        {"a = 1\nb = [1, 'x']\n", loltoml::error_code_t::mixed_array, 2, 9},
+        {"a = 1\nb 2", loltoml::error_code_t::unexpected_character, 2, 3},
+        {"[a]\n\n  x = 99999999999999999999", loltoml::error_code_t::number_out_of_range, 3, 7},
+        {"x = 1.", loltoml::error_code_t::invalid_number, 1, 6},
+        {"x = \"\\q\"", loltoml::error_code_t::invalid_escape_sequence, 1, 6},
+        {"x = 1979-05-27T07:32", loltoml::error_code_t::unexpected_character, 1, 20},
+        {"x = [1 2]", loltoml::error_code_t::expected_separator, 1, 8},
+        {"x = 1 y", loltoml::error_code_t::expected_new_line, 1, 7},
+        {" = 1", loltoml::error_code_t::expected_key, 1, 2},
+        {"x = 'a\x01'", loltoml::error_code_t::control_character, 1, 7},
+        {"x = 'a", loltoml::error_code_t::control_character, 1, 6},
+        {"x = \"\"\"\na", loltoml::error_code_t::unexpected_eof, 2, 2}
+    };
+
+    for (std::size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); ++i) {
+        SCOPED_TRACE(tests[i].input);
+
+        events_aggregator_t handler;
+        loltoml::error_info_t error;
+
+        EXPECT_FALSE(loltoml::parse(loltoml::string_view_t(tests[i].input), handler, error));
+        EXPECT_EQ(tests[i].code, error.code);
+        EXPECT_EQ(tests[i].line, error.line);
+        EXPECT_EQ(tests[i].column, error.column);
+
+        // Everything else is the same as with exceptions.
+        loltoml::parser_error_t thrown = thrown_error(tests[i].input);
+        EXPECT_EQ(thrown.code(), error.code);
+        EXPECT_EQ(thrown.offset(), error.offset);
+        EXPECT_STREQ(thrown.message(), error.message());
+    }
+}
+
+TEST(ErrorInfo, Redefinition) {
+    events_aggregator_t handler;
+    loltoml::parser_t<events_aggregator_t> parser(handler);
+    parser.set_key_validation(true);
+
+    loltoml::error_info_t error;
+    EXPECT_FALSE(parser.parse(loltoml::string_view_t("a = 1\na = 2\n"), error));
+    EXPECT_EQ(loltoml::error_code_t::redefinition, error.code);
+    EXPECT_EQ(2u, error.line);
+    EXPECT_STREQ("Duplicate key", error.message());
+
+    // The parser is usable after the error, and the error is cleared.
+    EXPECT_TRUE(parser.parse(loltoml::string_view_t("a = 1\n"), error));
+    EXPECT_FALSE(error);
+}
+
+TEST(ErrorInfo, LazyMessage) {
+    loltoml::parser_error_t error = loltoml::parser_error_t::unexpected_character("tT", 5);
+
+    EXPECT_EQ(loltoml::error_code_t::unexpected_character, error.code());
+    EXPECT_EQ(5u, error.offset());
+    EXPECT_STREQ("Expected one of the following symbols: 't', 'T'", error.message());
+
+    // The same error found at another offset keeps the code and the message.
+    loltoml::parser_error_t moved(error, 10);
+    EXPECT_EQ(loltoml::error_code_t::unexpected_character, moved.code());
+    EXPECT_EQ(10u, moved.offset());
+    EXPECT_STREQ(error.message(), moved.message());
+}
+
+TEST(ErrorInfo, Stream) {
+    events_aggregator_t handler;
+    loltoml::error_info_t error;
+    std::istringstream input("a = 1\nb = [1, 'x']\n");
+
+    EXPECT_FALSE(loltoml::parse(input, handler, error));
+    EXPECT_EQ(loltoml::error_code_t::mixed_array, error.code);
+    EXPECT_EQ(14u, error.offset);
+    EXPECT_EQ(0u, error.line);
+    EXPECT_EQ(0u, error.column);
+
+    // The events preceding the error are passed to the handler as usual.
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::key, "a"},
+        {sax_event_t::integer, 1},
+        {sax_event_t::key, "b"},
+        {sax_event_t::start_array},
+        {sax_event_t::integer, 1},
+        {sax_event_t::string, "x"}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+}
+
+TEST(ErrorInfo, StoppedByHandler) {
+    struct stopping_handler_t : events_aggregator_t {
+        loltoml::action_t key(const std::string &) {
+            return loltoml::action_t::stop;
+        }
+    };
+
+    stopping_handler_t handler;
+    loltoml::error_info_t error;
+
+    EXPECT_FALSE(loltoml::parse(loltoml::string_view_t("a = 1\n"), handler, error));
+    EXPECT_FALSE(error);
+}
+
+TEST(ErrorInfo, BadStream) {
+    // Fails when the stream asks for more data after the first chunk.
+    struct failing_buffer_t : std::streambuf {
+        std::string data;
+
+        explicit failing_buffer_t(const std::string &data) :
+            data(data)
+        {
+            setg(&this->data[0], &this->data[0], &this->data[0] + this->data.size());
+        }
+
+        int_type underflow() {
+            throw std::runtime_error("read failed");
+        }
+    };
+
+    failing_buffer_t buffer("a = 1\nb = \"xy");
+    std::istream input(&buffer);
+    events_aggregator_t handler;
+    loltoml::error_info_t error;
+
+    EXPECT_FALSE(loltoml::parse(input, handler, error));
+    EXPECT_EQ(loltoml::error_code_t::stream_error, error.code);
+    EXPECT_EQ(13u, error.offset);
+    EXPECT_STREQ("Unable to read data from the stream", error.message());
+
+    // The unfinished string isn't emitted.
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::key, "a"},
+        {sax_event_t::integer, 1},
+        {sax_event_t::key, "b"}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+
+    // The throwing parser reports the same error as loltoml::stream_error_t.
+    failing_buffer_t thrown_buffer("a = 1\nb = \"xy");
+    std::istream thrown_input(&thrown_buffer);
+    events_aggregator_t thrown_handler;
+
+    EXPECT_THROW(loltoml::parse(thrown_input, thrown_handler), loltoml::stream_error_t);
+    EXPECT_EQ(expected_events, thrown_handler.events);
+}
@@ -0,0 +1,172 @@
+#include "common.hpp"
+
+#include "loltoml/find_table.hpp"
+
+#include <string>
+#include <vector>
+
+
+namespace {
+
+const char *document =
+    "title = \"shared\"\n"
+    "ignored = [1, \"not validated\"]\n"
+    "# [service.beta]\n"
+    "\n"
+    "[service.alpha]\n"
+    "port = 1\n"
+    "notes = \"\"\"\n"
+    "[service.beta]\n"
+    "\"\"\"\n"
+    "\n"
+    "[[service.list]]\n"
+    "port = 2\n"
+    "\n"
+    "  [ service . \"beta\" ] # comment\n"
+    "port = 3 # port\n"
+    "tags = [\"a\", 'b']\n"
+    "limits = {cpu = 1.5, started = 1979-05-27T07:32:00Z}\n"
+    "\n"
+    "[service.beta.nested]\n"
+    "port = 4\n"
+    "\n"
+    "[service.gamma]\n"
+    "this is not toml\n";
+
+struct symbols_aggregator_t :
+    public events_aggregator_t
+{
+    void table(loltoml::symbol_iterator_t begin, loltoml::symbol_iterator_t end) {
+        std::vector<std::string> path;
+
+        for (; begin != end; ++begin) {
+            path.push_back(begin->text.to_string());
+        }
+
+        events.emplace_back(sax_event_t::table, path);
+    }
+
+    void array_table(loltoml::symbol_iterator_t, loltoml::symbol_iterator_t) { }
+};
+
+} // namespace
+
+
+TEST(FindTable, Found) {
+    events_aggregator_t handler;
+    EXPECT_TRUE(loltoml::find_table(document, {"service", "beta"}, handler));
+
+    std::vector<sax_event_t> expected = {
+        sax_event_t::start_document,
+        sax_event_t(sax_event_t::table, {"service", "beta"}),
+        sax_event_t(sax_event_t::comment, " comment"),
+        sax_event_t(sax_event_t::key, "port"),
+        sax_event_t(sax_event_t::integer, 3),
+        sax_event_t(sax_event_t::comment, " port"),
+        sax_event_t(sax_event_t::key, "tags"),
+        sax_event_t::start_array,
+        sax_event_t(sax_event_t::string, "a"),
+        sax_event_t(sax_event_t::string, "b"),
+        sax_event_t(sax_event_t::finish_array, 2),
+        sax_event_t(sax_event_t::key, "limits"),
+        sax_event_t::start_inline_table,
+        sax_event_t(sax_event_t::key, "cpu"),
+        sax_event_t(sax_event_t::floating_point, 1.5),
+        sax_event_t(sax_event_t::key, "started"),
+        sax_event_t(sax_event_t::datetime, "1979-05-27T07:32:00Z"),
+        sax_event_t(sax_event_t::finish_inline_table, 2),
+        sax_event_t::finish_document
+    };
+
+    EXPECT_EQ(expected, handler.events);
+}
+
+TEST(FindTable, LastTable) {
+    std::string input = document;
+    input.erase(input.find("this is not toml"));
+
+    events_aggregator_t handler;
+    EXPECT_TRUE(loltoml::find_table(input, {"service", "gamma"}, handler));
+
+    std::vector<sax_event_t> expected = {
+        sax_event_t::start_document,
+        sax_event_t(sax_event_t::table, {"service", "gamma"}),
+        sax_event_t::finish_document
+    };
+
+    EXPECT_EQ(expected, handler.events);
+}
+
+TEST(FindTable, NotFound) {
+    std::vector<sax_event_t> expected = {
+        sax_event_t::start_document,
+        sax_event_t::finish_document
+    };
+
+    std::string input = document;
+    input.erase(input.find("this is not toml"));
+
+    std::vector<std::vector<std::string>> paths = {
+        {"service"},
+        {"service", "list"},
+        {"service", "beta", "nested", "x"},
+        {"service", "delta"},
+        {"title"}
+    };
+
+    for (auto it = paths.begin(); it != paths.end(); ++it) {
+        events_aggregator_t handler;
+        EXPECT_FALSE(loltoml::find_table(input.data(), input.size(), it->begin(), it->end(), handler));
+        EXPECT_EQ(expected, handler.events);
+    }
+}
+
+TEST(FindTable, SymbolPaths) {
+    symbols_aggregator_t handler;
+    EXPECT_TRUE(loltoml::find_table(document, {"service", "beta", "nested"}, handler));
+
+    std::vector<sax_event_t> expected = {
+        sax_event_t::start_document,
+        sax_event_t(sax_event_t::table, {"service", "beta", "nested"}),
+        sax_event_t(sax_event_t::key, "port"),
+        sax_event_t(sax_event_t::integer, 4),
+        sax_event_t::finish_document
+    };
+
+    EXPECT_EQ(expected, handler.events);
+}
+
+TEST(FindTable, OnlyHeadersAreParsed) {
+    events_aggregator_t handler;
+
+    // Errors outside the headers preceding the table aren't found.
+    EXPECT_TRUE(loltoml::find_table("a = \"b\n[b]\nc = = d\n[c]\nx = 1\n[d]\n?\n", {"c"}, handler));
+
+    std::vector<sax_event_t> expected = {
+        sax_event_t::start_document,
+        sax_event_t(sax_event_t::table, {"c"}),
+        sax_event_t(sax_event_t::key, "x"),
+        sax_event_t(sax_event_t::integer, 1),
+        sax_event_t::finish_document
+    };
+
+    EXPECT_EQ(expected, handler.events);
+}
+
+TEST(FindTable, Errors) {
+    events_aggregator_t handler;
+
+    try {
+        loltoml::find_table("[a]\n[b\n[c]\n", {"c"}, handler);
+        FAIL();
+    } catch (const loltoml::parser_error_t &e) {
+        EXPECT_EQ(6, e.offset());
+    }
+
+    try {
+        loltoml::find_table("[c]\na = 1\nb = \n[d]\n", {"c"}, handler);
+        FAIL();
+    } catch (const loltoml::parser_error_t &e) {
+        EXPECT_EQ(14, e.offset());
+    }
+}
@@ -1,5 +1,7 @@
 #include "common.hpp"
 
+#include <clocale>
+#include <cmath>
 #include <sstream>
 
 
@@ -21,6 +23,22 @@ namespace {
         EXPECT_EQ(sax_event_t(sax_event_t::finish_document), handler.events[3]);
     }
 
+    // Unlike test_parsing(), requires the result to be exactly the nearest double.
+    void test_exact(const std::string &str, double expected) {
+        std::string scope = "parse '" + str + "' exactly";
+        SCOPED_TRACE(scope);
+
+        std::istringstream input("key = " + str);
+        events_aggregator_t handler;
+
+        loltoml::parse(input, handler);
+
+        ASSERT_EQ(4, handler.events.size());
+        EXPECT_EQ(sax_event_t::floating_point, handler.events[2].type);
+        EXPECT_EQ(expected, handler.events[2].float_data);
+        EXPECT_EQ(std::signbit(expected), std::signbit(handler.events[2].float_data));
+    }
+
     void test_error(const std::string &str) {
         std::string scope = "test error when parse '" + str + "'";
         SCOPED_TRACE(scope);
@@ -162,3 +180,66 @@ TEST(Float, InfNanAreNotSupported) {
     test_error("Nan");
     test_error("nan");
 }
+
+TEST(Float, NegativeZero) {
+    test_exact("-0.0", -0.0);
+    test_exact("-0e10", -0.0);
+    test_exact("0.0", 0.0);
+}
+
+TEST(Float, CorrectRounding) {
+    test_exact("0.1", 0.1);
+    test_exact("0.3", 0.3);
+    test_exact("1e23", 1e23);
+    test_exact("9007199254740993.000000000000000000001", 9007199254740994.0);
+    test_exact("1.7976931348623157e308", 1.7976931348623157e308);
+    test_exact("1.7976931348623158e308", 1.7976931348623157e308);
+    test_exact("2.2250738585072011e-308", 2.2250738585072011e-308);
+    test_exact("2.2250738585072012e-308", 2.2250738585072014e-308);
+    test_exact("3.141592653589793238462643383279502884197", 3.141592653589793);
+    test_exact("123456789012345678901234567890.0", 123456789012345678901234567890.0);
+    test_exact("7.3177701707893310e+15", 7.3177701707893310e+15);
+    test_exact("8.98846567431158e307", 8.98846567431158e307);
+}
+
+TEST(Float, HalfWay) {
+    // 2^53 + 1 and 2^53 + 3 are exactly between two doubles and are rounded to even.
+    test_exact("9007199254740993.0", 9007199254740992.0);
+    test_exact("9007199254740995.0", 9007199254740996.0);
+    // Around the point exactly between the largest subnormal and the smallest normal numbers.
+    test_exact("2.2250738585072011360574097967091319759348195463516456480234261097248222220210769455165295239081350879141491589130396211068700864386945946455276572074078206217433799881410632673292535522868813721490129811224514518898490572223072852551331557550159143974763979834118019993239625482890171070818506906306666559949382757725720157630626906633326475653000092458883164330377797918696120494973903778297049050510806099407302629371289589500035837999672072543043602840788957717961509455167482434710307026091446215722898802581825451803257070188608721131280795122334262883686223215037756666225039825343359745688844239002654981983854879482922068947216898310996983658468140228542433306603398508864458040010349339704275671864433837704860378616227717385456230658746790140867233276367187499999e-308",
+               2.2250738585072009e-308);
+    test_exact("2.22507385850720113605740979670913197593481954635164564802342610972482222202107694551652952390813508791414915891303962110687008643869459464552765720740782062174337998814106326732925355228688137214901298112245145188984905722230728525513315575501591439747639798341180199932396254828901710708185069063066665599493827577257201576306269066333264756530000924588831643303777979186961204949739037782970490505108060994073026293712895895000358379996720725430436028407889577179615094551674824347103070260914462157228988025818254518032570701886087211312807951223342628836862232150377566662250398253433597456888442390026549819838548794829220689472168983109969836584681402285424333066033985088644580400103493397042756718644338377048603786162277173854562306587467901408672332763671875e-308",
+               2.2250738585072014e-308);
+    test_exact("2.2250738585072011360574097967091319759348195463516456480234261097248222220210769455165295239081350879141491589130396211068700864386945946455276572074078206217433799881410632673292535522868813721490129811224514518898490572223072852551331557550159143974763979834118019993239625482890171070818506906306666559949382757725720157630626906633326475653000092458883164330377797918696120494973903778297049050510806099407302629371289589500035837999672072543043602840788957717961509455167482434710307026091446215722898802581825451803257070188608721131280795122334262883686223215037756666225039825343359745688844239002654981983854879482922068947216898310996983658468140228542433306603398508864458040010349339704275671864433837704860378616227717385456230658746790140867233276367187500001e-308",
+               2.2250738585072014e-308);
+}
+
+TEST(Float, Subnormal) {
+    test_exact("4.9406564584124654e-324", 4.9406564584124654e-324);
+    test_exact("2.4703282292062328e-324", 4.9406564584124654e-324);
+    test_exact("1e-310", 1e-310);
+    test_exact("-2.2250738585072009e-308", -2.2250738585072009e-308);
+}
+
+TEST(Float, Underflow) {
+    test_exact("2.4703282292062327e-324", 0.0);
+    test_exact("1e-400", 0.0);
+    test_exact("-1e-400", -0.0);
+    test_exact("0.000000000000000000000000000001e-999999999999", 0.0);
+}
+
+TEST(Float, DoesNotDependOnLocale) {
+    const char *locales[] = {"de_DE.UTF-8", "de_DE", "ru_RU.UTF-8", "fr_FR.UTF-8"};
+
+    std::string previous = std::setlocale(LC_NUMERIC, nullptr);
+
+    for (std::size_t i = 0; i < sizeof(locales) / sizeof(locales[0]); ++i) {
+        if (std::setlocale(LC_NUMERIC, locales[i])) {
+            test_exact("+14.1345", 14.1345);
+            test_exact("2.5e-3", 0.0025);
+        }
+    }
+
+    std::setlocale(LC_NUMERIC, previous.c_str());
+}
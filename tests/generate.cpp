@@ -0,0 +1,105 @@
+#include "generator.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+/*
+ * Writes a synthetic TOML document to the standard output.
+ *
+ * Usage: loltoml-generate [--shape NAME] [--size BYTES[K|M|G]] [--seed N]
+ *
+ * The same arguments always give the same document, so corpora may be regenerated instead of being stored.
+ */
+
+
+namespace {
+
+void usage() {
+    std::fprintf(stderr, "Usage: loltoml-generate [--shape NAME] [--size BYTES[K|M|G]] [--seed N]\nShapes:");
+
+    for (std::size_t i = 0; i < document_generator_t::shapes_count; ++i) {
+        std::fprintf(stderr, " %s", document_generator_t::shape_name(static_cast<document_generator_t::shape_t>(i)));
+    }
+
+    std::fprintf(stderr, "\n");
+}
+
+bool parse_size(const char *text, std::size_t &result) {
+    char *suffix = nullptr;
+    unsigned long long value = std::strtoull(text, &suffix, 10);
+
+    if (suffix == text) {
+        return false;
+    }
+
+    if (std::strcmp(suffix, "K") == 0) {
+        value <<= 10;
+    } else if (std::strcmp(suffix, "M") == 0) {
+        value <<= 20;
+    } else if (std::strcmp(suffix, "G") == 0) {
+        value <<= 30;
+    } else if (*suffix != '\0') {
+        return false;
+    }
+
+    result = static_cast<std::size_t>(value);
+    return true;
+}
+
+} // namespace
+
+
+int main(int argc, char **argv) {
+    document_generator_t::shape_t shape = document_generator_t::shape_t::mixed;
+    std::size_t size = 1 << 20;
+    std::uint64_t seed = 42;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+
+        if (i + 1 == argc) {
+            usage();
+            return 1;
+        }
+
+        const char *value = argv[++i];
+        bool valid = false;
+
+        if (option == "--shape") {
+            valid = document_generator_t::parse_shape(value, shape);
+        } else if (option == "--size") {
+            valid = parse_size(value, size);
+        } else if (option == "--seed") {
+            char *end = nullptr;
+            seed = std::strtoull(value, &end, 10);
+            valid = (end != value && *end == '\0');
+        }
+
+        if (!valid) {
+            usage();
+            return 1;
+        }
+    }
+
+    // Generate in chunks to keep memory usage low for huge documents.
+    document_generator_t generator(shape, seed);
+    std::string chunk;
+    std::size_t written = 0;
+
+    while (written < size) {
+        chunk.clear();
+        generator.generate(std::min<std::size_t>(size - written, 1 << 20), chunk);
+
+        if (std::fwrite(chunk.data(), 1, chunk.size(), stdout) != chunk.size()) {
+            std::perror("loltoml-generate");
+            return 1;
+        }
+
+        written += chunk.size();
+    }
+
+    return 0;
+}
@@ -0,0 +1,341 @@
+#ifndef LOLTOML_TESTS_GENERATOR_HPP
+#define LOLTOML_TESTS_GENERATOR_HPP
+
+#include "loltoml/writer.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+/*
+ * Generator of large valid TOML documents for benchmarks and stress tests.
+ * The output depends only on the shape, the seed and the size, so the same corpus may be regenerated anywhere.
+ * Random numbers come from splitmix64 instead of <random> distributions, which differ between standard libraries.
+ */
+
+
+class document_generator_t {
+public:
+    enum class shape_t {
+        // All the shapes below interleaved.
+        mixed,
+        // Headers of deeply nested tables and deeply nested arrays and inline tables.
+        deep_tables,
+        // Inline tables with hundreds of keys.
+        wide_inline_tables,
+        // Long multiline arrays of floats of all magnitudes.
+        float_arrays,
+        // Floods of [[array tables]] with nested array tables.
+        array_tables,
+        // Long multiline basic and literal strings.
+        multiline_strings,
+        // Basic strings consisting mostly of escape sequences and non-ASCII characters.
+        escapes
+    };
+
+    enum : std::size_t {
+        shapes_count = 7
+    };
+
+    static const char *shape_name(shape_t shape) {
+        static const char *names[shapes_count] = {
+            "mixed",
+            "deep_tables",
+            "wide_inline_tables",
+            "float_arrays",
+            "array_tables",
+            "multiline_strings",
+            "escapes"
+        };
+
+        return names[static_cast<std::size_t>(shape)];
+    }
+
+    //! \returns false if there is no shape with the name.
+    static bool parse_shape(const std::string &name, shape_t &shape) {
+        for (std::size_t i = 0; i < shapes_count; ++i) {
+            if (name == shape_name(static_cast<shape_t>(i))) {
+                shape = static_cast<shape_t>(i);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    explicit document_generator_t(shape_t shape, std::uint64_t seed = 42) :
+        m_shape(shape),
+        m_state(seed),
+        m_sections(0)
+    { }
+
+    //! Appends sections to the output until at least size bytes are added.
+    void generate(std::size_t size, std::string &output) {
+        std::size_t start = output.size();
+
+        while (output.size() - start < size) {
+            section(output);
+        }
+    }
+
+    std::string generate(std::size_t size) {
+        std::string result;
+        result.reserve(size + 64 * 1024);
+        generate(size, result);
+        return result;
+    }
+
+private:
+    // Every section starts with its own header and uses a unique name, so sections never conflict.
+    void section(std::string &output) {
+        std::size_t index = m_sections++;
+        shape_t shape = m_shape;
+
+        if (shape == shape_t::mixed) {
+            shape = static_cast<shape_t>(1 + uniform(shapes_count - 1));
+        }
+
+        switch (shape) {
+            case shape_t::mixed:
+            case shape_t::deep_tables: deep_tables(output, index); break;
+            case shape_t::wide_inline_tables: wide_inline_table(output, index); break;
+            case shape_t::float_arrays: float_array(output, index); break;
+            case shape_t::array_tables: array_tables(output, index); break;
+            case shape_t::multiline_strings: multiline_strings(output, index); break;
+            case shape_t::escapes: escapes(output, index); break;
+        }
+
+        output += '\n';
+    }
+
+    void deep_tables(std::string &output, std::size_t index) {
+        output += "[deep" + number(index);
+
+        std::size_t depth = 1 + uniform(32);
+        for (std::size_t i = 0; i < depth; ++i) {
+            output += '.';
+            key(output);
+        }
+
+        output += "]\n";
+
+        output += "arrays = ";
+        std::size_t array_depth = 1 + uniform(24);
+        output.append(array_depth, '[');
+        output += number(uniform(1000));
+        output.append(array_depth, ']');
+        output += '\n';
+
+        output += "tables = ";
+        std::size_t table_depth = 1 + uniform(24);
+        for (std::size_t i = 0; i < table_depth; ++i) {
+            output += "{ level" + number(i) + " = ";
+        }
+        output += "true";
+        output.append(table_depth, '}');
+        output += '\n';
+    }
+
+    void wide_inline_table(std::string &output, std::size_t index) {
+        output += "[wide" + number(index) + "]\nrow = {";
+
+        std::size_t width = 16 + uniform(256);
+        for (std::size_t i = 0; i < width; ++i) {
+            output += (i > 0) ? ", k" : "k";
+            output += number(i) + " = ";
+            scalar(output);
+        }
+
+        output += "}\n";
+    }
+
+    void float_array(std::string &output, std::size_t index) {
+        output += "[floats" + number(index) + "]\nvalues = [\n";
+
+        std::size_t size = 64 + uniform(1024);
+        for (std::size_t i = 0; i < size; ++i) {
+            output += (i % 8 == 0) ? "    " : " ";
+            floating_point(output);
+            output += (i % 8 == 7 || i + 1 == size) ? ",\n" : ",";
+        }
+
+        output += "]\n";
+    }
+
+    void array_tables(std::string &output, std::size_t index) {
+        std::size_t items = 1 + uniform(16);
+
+        for (std::size_t i = 0; i < items; ++i) {
+            output += "[[items]]\nid = " + number(index) + "\nname = ";
+            basic_string(output, 4 + uniform(32));
+            output += '\n';
+
+            std::size_t parts = uniform(4);
+            for (std::size_t j = 0; j < parts; ++j) {
+                output += "[[items.parts]]\nweight = ";
+                floating_point(output);
+                output += '\n';
+            }
+        }
+    }
+
+    void multiline_strings(std::string &output, std::size_t index) {
+        output += "[text" + number(index) + "]\nbasic = \"\"\"\n";
+
+        std::size_t lines = 2 + uniform(200);
+        for (std::size_t i = 0; i < lines; ++i) {
+            words(output, 1 + uniform(16));
+            // Line ending backslashes trim the new-line and the following whitespace.
+            output += uniform(4) == 0 ? " \\\n    " : "\n";
+        }
+
+        output += "\"\"\"\nliteral = '''\n";
+
+        lines = 2 + uniform(200);
+        for (std::size_t i = 0; i < lines; ++i) {
+            output += "C:\\path\\";
+            words(output, 1 + uniform(16));
+            output += '\n';
+        }
+
+        output += "'''\n";
+    }
+
+    void escapes(std::string &output, std::size_t index) {
+        output += "[escapes" + number(index) + "]\n";
+
+        std::size_t keys = 1 + uniform(8);
+        for (std::size_t i = 0; i < keys; ++i) {
+            output += "s" + number(i) + " = \"";
+
+            std::size_t size = 16 + uniform(256);
+            for (std::size_t j = 0; j < size; ++j) {
+                escape(output);
+            }
+
+            output += "\"\n";
+        }
+    }
+
+    void escape(std::string &output) {
+        static const char *simple[] = {"\\\"", "\\\\", "\\n", "\\t", "\\r", "\\b", "\\f", "a", " ", "\xd1\x8f"};
+
+        switch (uniform(4)) {
+            case 0: {
+                output += "\\u" + hex(code_point(0xFFFF), 4);
+            } break;
+            case 1: {
+                output += "\\U" + hex(code_point(0x10FFFF), 8);
+            } break;
+            default: {
+                output += simple[uniform(sizeof(simple) / sizeof(simple[0]))];
+            } break;
+        }
+    }
+
+    void scalar(std::string &output) {
+        switch (uniform(5)) {
+            case 0: output += number(uniform(1000000)); break;
+            case 1: floating_point(output); break;
+            case 2: output += uniform(2) ? "true" : "false"; break;
+            case 3: output += "1979-05-27T07:32:00Z"; break;
+            default: basic_string(output, uniform(24)); break;
+        }
+    }
+
+    void floating_point(std::string &output) {
+        double value = 0;
+
+        if (uniform(2) == 0) {
+            // Short decimals, as written by people.
+            value = static_cast<double>(uniform(2000000)) / 1000 - 1000;
+        } else {
+            // Any finite double.
+            do {
+                std::uint64_t bits = next();
+                std::memcpy(&value, &bits, sizeof(value));
+            } while (!std::isfinite(value));
+        }
+
+        char buffer[loltoml::detail::max_number_size];
+        output.append(buffer, loltoml::detail::format_double(value, buffer));
+    }
+
+    void basic_string(std::string &output, std::size_t size) {
+        output += '"';
+        words(output, size / 6 + 1);
+        output += '"';
+    }
+
+    void words(std::string &output, std::size_t count) {
+        static const char *dictionary[] = {
+            "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit", "sed", "do",
+            "eiusmod", "tempor", "incididunt", "ut", "labore", "et", "dolore", "magna", "aliqua"
+        };
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i > 0) {
+                output += ' ';
+            }
+
+            output += dictionary[uniform(sizeof(dictionary) / sizeof(dictionary[0]))];
+        }
+    }
+
+    void key(std::string &output) {
+        if (uniform(8) == 0) {
+            output += "\"quoted key ";
+            output += number(uniform(100));
+            output += '"';
+        } else {
+            output += 'k';
+            output += number(uniform(100));
+        }
+    }
+
+    // Unicode scalar values, i.e. without surrogates.
+    std::uint32_t code_point(std::uint32_t max) {
+        while (true) {
+            std::uint32_t result = static_cast<std::uint32_t>(uniform(max + 1));
+
+            if (result < 0xD800 || result > 0xDFFF) {
+                return result;
+            }
+        }
+    }
+
+    static std::string hex(std::uint32_t value, std::size_t digits) {
+        std::string result(digits, '0');
+
+        for (std::size_t i = digits; i > 0; --i) {
+            result[i - 1] = "0123456789ABCDEF"[value % 16];
+            value /= 16;
+        }
+
+        return result;
+    }
+
+    static std::string number(std::uint64_t value) {
+        return std::to_string(value);
+    }
+
+    // splitmix64.
+    std::uint64_t next() {
+        std::uint64_t result = (m_state += 0x9E3779B97F4A7C15ull);
+        result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ull;
+        result = (result ^ (result >> 27)) * 0x94D049BB133111EBull;
+        return result ^ (result >> 31);
+    }
+
+    // Slightly biased, which doesn't matter here.
+    std::size_t uniform(std::size_t bound) {
+        return static_cast<std::size_t>(next() % bound);
+    }
+
+    shape_t m_shape;
+    std::uint64_t m_state;
+    std::size_t m_sections;
+};
+
+#endif // LOLTOML_TESTS_GENERATOR_HPP
@@ -242,3 +242,71 @@ TEST(Integer, LeadingZerosAreNotAllowed3) {
 
     EXPECT_THROW(loltoml::parse(input, handler), loltoml::parser_error_t);
 }
+
+TEST(Integer, EightDigitBlocks) {
+    EXPECT_TRUE(loltoml::detail::is_eight_digits(loltoml::detail::load_eight_chars("01234567")));
+    EXPECT_TRUE(loltoml::detail::is_eight_digits(loltoml::detail::load_eight_chars("99999999")));
+    EXPECT_FALSE(loltoml::detail::is_eight_digits(loltoml::detail::load_eight_chars("0123456_")));
+    EXPECT_FALSE(loltoml::detail::is_eight_digits(loltoml::detail::load_eight_chars("/1234567")));
+    EXPECT_FALSE(loltoml::detail::is_eight_digits(loltoml::detail::load_eight_chars("0123:567")));
+    EXPECT_FALSE(loltoml::detail::is_eight_digits(loltoml::detail::load_eight_chars("\xb0" "1234567")));
+
+    EXPECT_EQ(1234567u, loltoml::detail::parse_eight_digits(loltoml::detail::load_eight_chars("01234567")));
+    EXPECT_EQ(99999999u, loltoml::detail::parse_eight_digits(loltoml::detail::load_eight_chars("99999999")));
+    EXPECT_EQ(80000001u, loltoml::detail::parse_eight_digits(loltoml::detail::load_eight_chars("80000001")));
+}
+
+TEST(Integer, BufferSameAsStream) {
+    std::vector<std::string> numbers = {
+        "1", "12345678", "123456789", "1_2345_6789", "12345678_9", "1234567890123456789",
+        "9223372036854775807", "-9223372036854775808", "9_223_372_036_854_775_807",
+        "9223372036854775808", "-9223372036854775809", "92233720368547758070", "99999999999999999999999999",
+        "100000000000000000000000", "-1000000000000000000", "+12345678901234", "0", "-0", "012345678",
+        "12345678_", "12345678__9", "123456789012345678901234567890.5", "1234567812345678e1", "1_2"
+    };
+
+    for (auto it = numbers.begin(); it != numbers.end(); ++it) {
+        std::string document = "key = " + *it + "\n";
+
+        events_aggregator_t stream_handler;
+        std::string stream_error = "no error";
+
+        try {
+            std::istringstream input(document);
+            loltoml::parse(input, stream_handler);
+        } catch (const loltoml::parser_error_t &e) {
+            stream_error = std::string(e.message()) + " at " + std::to_string(e.offset());
+        }
+
+        events_aggregator_t buffer_handler;
+        std::string buffer_error = "no error";
+
+        try {
+            loltoml::parse(document, buffer_handler);
+        } catch (const loltoml::parser_error_t &e) {
+            buffer_error = std::string(e.message()) + " at " + std::to_string(e.offset());
+        }
+
+        EXPECT_EQ(stream_error, buffer_error) << *it;
+        EXPECT_EQ(stream_handler.events, buffer_handler.events) << *it;
+    }
+}
+
+TEST(Integer, LongNumbers) {
+    events_aggregator_t handler;
+    loltoml::parse(loltoml::string_view_t("a = 1234567812345678\nb = -9223372036854775808\nc = 9_223372036854775807"),
+                   handler);
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::key, "a"},
+        {sax_event_t::integer, std::int64_t(1234567812345678)},
+        {sax_event_t::key, "b"},
+        {sax_event_t::integer, std::numeric_limits<std::int64_t>::min()},
+        {sax_event_t::key, "c"},
+        {sax_event_t::integer, std::numeric_limits<std::int64_t>::max()},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+}
@@ -0,0 +1,106 @@
+#include "common.hpp"
+
+#include "loltoml/parser.hpp"
+
+#include <sstream>
+
+
+namespace {
+
+void parse_validated(const std::string &input) {
+    events_aggregator_t handler;
+    loltoml::parser_t<events_aggregator_t> parser(handler);
+    parser.set_key_validation(true);
+    parser.parse(input);
+}
+
+std::size_t error_offset(const std::string &input) {
+    try {
+        parse_validated(input);
+    } catch (const loltoml::parser_error_t &e) {
+        return e.offset();
+    }
+
+    ADD_FAILURE() << "No error in " << input;
+    return 0;
+}
+
+} // namespace
+
+
+TEST(KeyValidation, DisabledByDefault) {
+    events_aggregator_t handler;
+    loltoml::parser_t<events_aggregator_t> parser(handler);
+
+    EXPECT_FALSE(parser.key_validation());
+    EXPECT_NO_THROW(parser.parse(loltoml::string_view_t("a = 1\na = 2")));
+
+    parser.set_key_validation(true);
+    EXPECT_TRUE(parser.key_validation());
+    EXPECT_THROW(parser.parse(loltoml::string_view_t("a = 1\na = 2")), loltoml::parser_error_t);
+}
+
+TEST(KeyValidation, ValidDocuments) {
+    EXPECT_NO_THROW(parse_validated("a = 1\nb = 2\n[c]\na = 1\n[d.c]\na = 1"));
+    EXPECT_NO_THROW(parse_validated("[a.b]\nc = 1\n[a]\nd = 2"));
+    EXPECT_NO_THROW(parse_validated("[a.b.c]\n[a.b.d]\n[a.b]\n[a]"));
+    EXPECT_NO_THROW(parse_validated("[[a]]\nb = 1\n[a.c]\n[[a]]\nb = 2\n[a.c]"));
+    EXPECT_NO_THROW(parse_validated("[[a]]\n[[a.b]]\n[[a.b]]\n[[a]]\n[[a.b]]"));
+    EXPECT_NO_THROW(parse_validated("a = [{b = 1}, {b = 2}]\nc = {d = {e = 1}, e = 1}"));
+    EXPECT_NO_THROW(parse_validated("a = [[1, 2], [3]]\nb = 1"));
+    EXPECT_NO_THROW(parse_validated("[a]\n\"b\" = 1\n[\"a\".c]\n\"b\" = 2"));
+}
+
+TEST(KeyValidation, Redefinitions) {
+    EXPECT_THROW(parse_validated("a = 1\na = 2"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("a = 1\n\"a\" = 2"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("a = {b = 1, b = 2}"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("a = [{b = 1, b = 2}]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("[a]\n[a]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("[a.b]\n[a]\n[a]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("[a]\nb = 1\n[a.b]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("[a]\nb = 1\n[a.b.c]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("[a]\nb = 1\n[a]\nc = 1"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("[a.b]\n[a]\nb = 1"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("a = 1\n[a]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("a = {}\n[a]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("a = {}\n[a.b]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("a = []\n[[a]]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("[[a]]\n[a]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("[a]\n[[a]]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("[a.b]\n[[a]]"), loltoml::parser_error_t);
+    EXPECT_THROW(parse_validated("[[a]]\nb = 1\nb = 2"), loltoml::parser_error_t);
+}
+
+TEST(KeyValidation, ErrorOffsets) {
+    EXPECT_EQ(6u, error_offset("a = 1\na = 2"));
+    EXPECT_EQ(12u, error_offset("a = {b = 1, b = 2}"));
+    EXPECT_EQ(4u, error_offset("[a]\n[a]"));
+    EXPECT_EQ(6u, error_offset("a = 1\n[[a]]"));
+}
+
+TEST(KeyValidation, KeysAreForgottenBetweenDocuments) {
+    events_aggregator_t handler;
+    loltoml::parser_t<events_aggregator_t> parser(handler);
+    parser.set_key_validation(true);
+
+    parser.parse(loltoml::string_view_t("[a]\nb = 1"));
+    EXPECT_NO_THROW(parser.parse(loltoml::string_view_t("[a]\nb = 1")));
+    EXPECT_THROW(parser.parse(loltoml::string_view_t("[a]\na = 1\na = 2")), loltoml::parser_error_t);
+    EXPECT_NO_THROW(parser.parse(loltoml::string_view_t("a = 1")));
+
+    std::istringstream input("[a]\nb = 1");
+    EXPECT_NO_THROW(parser.parse(input));
+}
+
+TEST(KeyValidation, ManyTables) {
+    std::string input;
+
+    for (std::size_t i = 0; i < 100000; ++i) {
+        std::string index = std::to_string(i);
+        input += "[section" + index + ".sub]\nkey = " + index + "\n";
+    }
+
+    EXPECT_NO_THROW(parse_validated(input));
+    EXPECT_THROW(parse_validated(input + "[section99999.sub]\n"), loltoml::parser_error_t);
+}
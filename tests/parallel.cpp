@@ -0,0 +1,150 @@
+#include "common.hpp"
+
+#include "loltoml/detail/parallel.hpp"
+#include "loltoml/parser.hpp"
+
+
+namespace {
+
+// Document with headers-like lines inside strings and arrays, which must not split the document.
+std::string make_document(std::size_t hosts) {
+    std::string result = "# inventory\ntitle = \"hosts\"\n\n";
+
+    for (std::size_t i = 0; i < hosts; ++i) {
+        std::string index = std::to_string(i);
+
+        result += "[[host]]\n";
+        result += "name = \"host" + index + "\" # comment [x]\n";
+        result += "address = '10.0.0." + std::to_string(i % 256) + "'\n";
+        result += "ports = [\n[80, 443],\n  [" + index + "]\n]\n";
+        result += "notes = \"\"\"\n[not.a.table]\n\\\"\"\"\n[[nor.this]]\"\"\"\n";
+        result += "raw = '''\n[raw]\n'''\n";
+        result += "meta = {weight = " + index + ".5, enabled = true, \"k]\" = 1979-05-27T07:32:00Z}\n";
+        result += "  [host.nested]\n  value = \"escaped \\u0041 " + index + "\"\n\n";
+    }
+
+    return result;
+}
+
+std::vector<sax_event_t> parse_sequentially(const std::string &input) {
+    events_aggregator_t handler;
+    loltoml::parse(input, handler);
+    return handler.events;
+}
+
+} // namespace
+
+
+TEST(Parallel, FindHeaderLines) {
+    std::string input =
+        "a = 1\n"
+        "[b]\n"
+        "c = [\n"
+        "[1]\n"
+        "]\n"
+        "d = \"\"\"\n"
+        "[e]\"\"\"\n"
+        "  [[f]]\n"
+        "g = '''\n"
+        "[h]'''\n"
+        "# [i]\n"
+        "[j]\n";
+
+    std::vector<std::size_t> result;
+    loltoml::detail::find_header_lines(input.data(), input.size(), 0, result);
+
+    std::vector<std::size_t> expected = {
+        input.find("[b]"),
+        input.find("  [[f]]"),
+        input.find("[j]")
+    };
+
+    EXPECT_EQ(expected, result);
+
+    result.clear();
+    loltoml::detail::find_header_lines(input.data(), input.size(), 20, result);
+
+    expected = {
+        input.find("  [[f]]"),
+        input.find("[j]")
+    };
+
+    EXPECT_EQ(expected, result);
+}
+
+TEST(Parallel, SameEventsAsSequential) {
+    std::string input = make_document(200);
+    std::vector<sax_event_t> expected = parse_sequentially(input);
+
+    for (std::size_t threads = 1; threads <= 4; ++threads) {
+        events_aggregator_t handler;
+        loltoml::detail::parser_buffers_t buffers;
+        loltoml::detail::parse_parallel(input.data(), input.size(), handler, buffers, threads, 100);
+
+        EXPECT_EQ(expected, handler.events);
+    }
+}
+
+TEST(Parallel, LargeDocument) {
+    std::string input = make_document(5000);
+    std::vector<sax_event_t> expected = parse_sequentially(input);
+
+    events_aggregator_t handler;
+    loltoml::parser_t<events_aggregator_t> parser(handler);
+    parser.parse_parallel(input, 4);
+
+    EXPECT_EQ(expected, handler.events);
+}
+
+TEST(Parallel, SameErrorsAsSequential) {
+    std::string valid = make_document(50);
+    std::vector<std::string> inputs = {
+        valid + "[[host]]\nname = \"unterminated\n",
+        valid.substr(0, valid.size() / 2) + "\n[bad key]\n" + valid.substr(valid.size() / 2),
+        "[a]\nb = [\n" + valid,
+        "x = \"\"\"\n" + valid
+    };
+
+    for (auto it = inputs.begin(); it != inputs.end(); ++it) {
+        events_aggregator_t sequential;
+        std::size_t expected_offset = 0;
+
+        try {
+            loltoml::parse(*it, sequential);
+            ADD_FAILURE() << "No error in the sequential parser";
+        } catch (const loltoml::parser_error_t &e) {
+            expected_offset = e.offset();
+        }
+
+        events_aggregator_t parallel;
+        loltoml::detail::parser_buffers_t buffers;
+
+        try {
+            loltoml::detail::parse_parallel(it->data(), it->size(), parallel, buffers, 4, 100);
+            ADD_FAILURE() << "No error in the parallel parser";
+        } catch (const loltoml::parser_error_t &e) {
+            EXPECT_EQ(expected_offset, e.offset());
+        }
+
+        EXPECT_EQ(sequential.events, parallel.events);
+    }
+}
+
+TEST(Parallel, KeyValidation) {
+    std::string valid = make_document(50);
+    std::string invalid = valid + "[[host]]\n[host.nested]\n[host.nested]\n";
+
+    events_aggregator_t handler;
+    loltoml::detail::parser_buffers_t buffers;
+    buffers.validate_keys = true;
+
+    loltoml::detail::parse_parallel(valid.data(), valid.size(), handler, buffers, 4, 100);
+    EXPECT_EQ(parse_sequentially(valid), handler.events);
+
+    try {
+        loltoml::detail::parse_parallel(invalid.data(), invalid.size(), handler, buffers, 4, 100);
+        FAIL();
+    } catch (const loltoml::parser_error_t &e) {
+        EXPECT_EQ(invalid.rfind("[host.nested]"), e.offset());
+    }
+}
@@ -0,0 +1,112 @@
+#include "common.hpp"
+
+#include "loltoml/parse_file.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <system_error>
+
+#include <unistd.h>
+
+
+namespace {
+    std::vector<sax_event_t> parse_stream(const std::string &path) {
+        std::ifstream input(path);
+        events_aggregator_t handler;
+        loltoml::parse(input, handler);
+        return handler.events;
+    }
+}
+
+
+TEST(ParseFile, RegularFile) {
+    const std::string path = TESTS_ROOT "documents/complex.toml";
+    events_aggregator_t handler;
+
+    loltoml::parse_file(path, handler);
+
+    EXPECT_EQ(parse_stream(path), handler.events);
+}
+
+TEST(ParseFile, EmptyFile) {
+    char path[] = "/tmp/loltoml-test-XXXXXX";
+    int descriptor = ::mkstemp(path);
+    ASSERT_NE(-1, descriptor);
+    ::close(descriptor);
+
+    events_aggregator_t handler;
+    loltoml::parse_file(path, handler);
+    ::unlink(path);
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+}
+
+TEST(ParseFile, Pipe) {
+    int descriptors[2];
+    ASSERT_EQ(0, ::pipe(descriptors));
+
+    const std::string document = "key = [1, 2]\n";
+    ASSERT_EQ(static_cast<ssize_t>(document.size()), ::write(descriptors[1], document.data(), document.size()));
+    ::close(descriptors[1]);
+
+    events_aggregator_t handler;
+    loltoml::parse_file("/dev/fd/" + std::to_string(descriptors[0]), handler);
+    ::close(descriptors[0]);
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::key, "key"},
+        {sax_event_t::start_array},
+        {sax_event_t::integer, 1},
+        {sax_event_t::integer, 2},
+        {sax_event_t::finish_array, 2},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+}
+
+TEST(ParseFile, ErrorOffset) {
+    char path[] = "/tmp/loltoml-test-XXXXXX";
+    int descriptor = ::mkstemp(path);
+    ASSERT_NE(-1, descriptor);
+
+    const std::string document = "a = 1\nb = 2\nc = ?\n";
+    ASSERT_EQ(static_cast<ssize_t>(document.size()), ::write(descriptor, document.data(), document.size()));
+    ::close(descriptor);
+
+    events_aggregator_t handler;
+
+    try {
+        loltoml::parse_file(path, handler);
+        ::unlink(path);
+        FAIL();
+    } catch (const loltoml::parser_error_t &e) {
+        ::unlink(path);
+        EXPECT_EQ(16, e.offset());
+    }
+}
+
+TEST(ParseFile, NonexistentFile) {
+    events_aggregator_t handler;
+
+    EXPECT_THROW(loltoml::parse_file(TESTS_ROOT "documents/nonexistent.toml", handler), std::system_error);
+}
+
+TEST(ParseFile, ReadErrorCode) {
+    events_aggregator_t handler;
+
+    // Directories can be opened but not read.
+    try {
+        loltoml::parse_file(TESTS_ROOT "documents", handler);
+        FAIL();
+    } catch (const std::system_error &e) {
+        EXPECT_EQ(EISDIR, e.code().value());
+    }
+}
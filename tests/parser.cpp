@@ -0,0 +1,78 @@
+#include "common.hpp"
+
+#include "loltoml/parser.hpp"
+
+#include <sstream>
+
+
+TEST(Parser, ManyDocuments) {
+    events_aggregator_t handler;
+    loltoml::parser_t<events_aggregator_t> parser(handler);
+
+    parser.parse(loltoml::string_view_t("[a.b.c]\nkey = \"value\""));
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::table, {"a", "b", "c"}},
+        {sax_event_t::key, "key"},
+        {sax_event_t::string, "value"},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+
+    handler.events.clear();
+    std::istringstream input("[[x]]\n[y.z]\nk = 'v'");
+    parser.parse(input);
+
+    expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::table_array_item, {"x"}},
+        {sax_event_t::table, {"y", "z"}},
+        {sax_event_t::key, "k"},
+        {sax_event_t::string, "v"},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+}
+
+TEST(Parser, ParseAfterError) {
+    events_aggregator_t handler;
+    loltoml::parser_t<events_aggregator_t> parser(handler);
+
+    EXPECT_THROW(parser.parse(loltoml::string_view_t("[a.b.c]\nkey = \"val")), loltoml::parser_error_t);
+
+    handler.events.clear();
+    parser.parse(loltoml::string_view_t("[d]"));
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::table, {"d"}},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+}
+
+TEST(Parser, Reset) {
+    events_aggregator_t handler;
+    loltoml::parser_t<events_aggregator_t> parser(handler);
+
+    parser.parse(loltoml::string_view_t("[a.b]\nkey = \"escaped\\tstring\""));
+    parser.reset();
+
+    handler.events.clear();
+    parser.parse(loltoml::string_view_t("[c]\nkey = \"\\u0041\""));
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::table, {"c"}},
+        {sax_event_t::key, "key"},
+        {sax_event_t::string, "A"},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+    EXPECT_EQ(&handler, &parser.handler());
+}
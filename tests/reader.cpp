@@ -0,0 +1,168 @@
+#include "common.hpp"
+
+#include "loltoml/reader.hpp"
+
+#include <fstream>
+#include <iterator>
+
+
+namespace {
+
+std::vector<sax_event_t> read_all(loltoml::reader_t &reader) {
+    std::vector<sax_event_t> result;
+
+    while (true) {
+        switch (reader.next()) {
+            case loltoml::event_type_t::start_document: {
+                result.emplace_back(sax_event_t::start_document);
+            } break;
+            case loltoml::event_type_t::finish_document: {
+                result.emplace_back(sax_event_t::finish_document);
+            } break;
+            case loltoml::event_type_t::comment: {
+                result.emplace_back(sax_event_t::comment, reader.string().to_string());
+            } break;
+            case loltoml::event_type_t::table:
+            case loltoml::event_type_t::array_table: {
+                std::vector<std::string> path;
+
+                for (std::size_t i = 0; i < reader.size(); ++i) {
+                    path.push_back(reader.path(i).to_string());
+                }
+
+                result.emplace_back(reader.event() == loltoml::event_type_t::table ? sax_event_t::table
+                                                                                   : sax_event_t::table_array_item,
+                                    path);
+            } break;
+            case loltoml::event_type_t::key: {
+                result.emplace_back(sax_event_t::key, reader.string().to_string());
+            } break;
+            case loltoml::event_type_t::start_array: {
+                result.emplace_back(sax_event_t::start_array);
+            } break;
+            case loltoml::event_type_t::finish_array: {
+                result.emplace_back(sax_event_t::finish_array, reader.size());
+            } break;
+            case loltoml::event_type_t::start_inline_table: {
+                result.emplace_back(sax_event_t::start_inline_table);
+            } break;
+            case loltoml::event_type_t::finish_inline_table: {
+                result.emplace_back(sax_event_t::finish_inline_table, reader.size());
+            } break;
+            case loltoml::event_type_t::boolean: {
+                result.emplace_back(sax_event_t::boolean, reader.boolean());
+            } break;
+            case loltoml::event_type_t::string: {
+                result.emplace_back(sax_event_t::string, reader.string().to_string());
+            } break;
+            case loltoml::event_type_t::datetime: {
+                result.emplace_back(sax_event_t::datetime, reader.string().to_string());
+            } break;
+            case loltoml::event_type_t::integer: {
+                result.emplace_back(sax_event_t::integer, reader.integer());
+            } break;
+            case loltoml::event_type_t::floating_point: {
+                result.emplace_back(sax_event_t::floating_point, reader.floating_point());
+            } break;
+            case loltoml::event_type_t::end: {
+                return result;
+            }
+        }
+    }
+}
+
+void test_same_as_parse(const std::string &input) {
+    SCOPED_TRACE("read '" + input.substr(0, 100) + "'");
+
+    events_aggregator_t handler;
+    bool expected_error = false;
+    std::size_t expected_offset = 0;
+
+    try {
+        loltoml::parse(input, handler);
+    } catch (const loltoml::parser_error_t &e) {
+        expected_error = true;
+        expected_offset = e.offset();
+    }
+
+    loltoml::reader_t reader(input);
+    std::vector<sax_event_t> events;
+
+    try {
+        events = read_all(reader);
+        EXPECT_FALSE(expected_error);
+        EXPECT_EQ(handler.events, events);
+    } catch (const loltoml::parser_error_t &e) {
+        EXPECT_TRUE(expected_error);
+        EXPECT_EQ(expected_offset, e.offset());
+    }
+}
+
+} // namespace
+
+
+TEST(Reader, SameEventsAsParse) {
+    test_same_as_parse("");
+    test_same_as_parse("\n\n# comment\n");
+    test_same_as_parse(
+        "a = \"with \\\"escapes\\\"\"\n"
+        "b = [\"x\\ty\", 'z', \"\"\"\nmulti\\\n  line\"\"\"] # comment\n"
+        "[c.\"d e\"]\n"
+        "f = {g = 1, h = [1.5, 2.5], i = {j = true}}\n"
+        "[[k]]\n"
+        "l = 1979-05-27T07:32:00Z\n"
+        "\"m\\n\" = false"
+    );
+}
+
+TEST(Reader, ComplexDocument) {
+    std::ifstream file(TESTS_ROOT "documents/complex.toml");
+    std::string document((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    ASSERT_FALSE(document.empty());
+    test_same_as_parse(document);
+}
+
+TEST(Reader, Errors) {
+    test_same_as_parse("a = 1\nb = \"unterminated\n");
+    test_same_as_parse("a = 1\n[b\n");
+    test_same_as_parse("a = [1, \"x\"]\n");
+    test_same_as_parse("a = 1 2\n");
+}
+
+TEST(Reader, ParsesLazily) {
+    loltoml::reader_t reader("a = 1\nb = \"\\x\"\n");
+
+    EXPECT_EQ(loltoml::event_type_t::start_document, reader.next());
+    EXPECT_EQ(loltoml::event_type_t::key, reader.next());
+    EXPECT_EQ("a", reader.string());
+    EXPECT_EQ(loltoml::event_type_t::integer, reader.next());
+    EXPECT_EQ(1, reader.integer());
+    EXPECT_EQ(loltoml::event_type_t::key, reader.next());
+    EXPECT_EQ("b", reader.string());
+
+    // The error is in the value of the next key.
+    EXPECT_THROW(reader.next(), loltoml::parser_error_t);
+}
+
+TEST(Reader, EndIsRepeated) {
+    loltoml::reader_t reader("");
+
+    EXPECT_EQ(loltoml::event_type_t::start_document, reader.next());
+    EXPECT_EQ(loltoml::event_type_t::finish_document, reader.next());
+    EXPECT_EQ(loltoml::event_type_t::end, reader.next());
+    EXPECT_EQ(loltoml::event_type_t::end, reader.next());
+    EXPECT_EQ(loltoml::event_type_t::end, reader.event());
+}
+
+TEST(Reader, KeyValidation) {
+    loltoml::reader_t reader("a = 1\na = 2\n");
+    reader.set_key_validation(true);
+
+    try {
+        while (reader.next() != loltoml::event_type_t::end) { }
+        FAIL();
+    } catch (const loltoml::parser_error_t &e) {
+        EXPECT_EQ(6, e.offset());
+    }
+}
@@ -0,0 +1,93 @@
+#include "common.hpp"
+
+#include "loltoml/detail/scan.hpp"
+
+
+namespace {
+    typedef const char *(*scan_function_t)(const char *, const char *);
+    typedef bool (*predicate_t)(char);
+
+    // Places every possible byte at every position of buffers of various lengths
+    // and checks that the scanner stops exactly where the scalar predicate says.
+    void test_scanner(scan_function_t scan, predicate_t is_special) {
+        for (std::size_t length = 0; length < 100; ++length) {
+            for (std::size_t position = 0; position < length; position += 7) {
+                for (int ch = 0; ch < 256; ++ch) {
+                    std::string buffer(length, 'a');
+                    buffer[position] = static_cast<char>(ch);
+
+                    const char *begin = buffer.data();
+                    const char *end = begin + buffer.size();
+
+                    const char *expected = begin;
+                    while (expected != end && !is_special(*expected)) {
+                        ++expected;
+                    }
+
+                    ASSERT_EQ(expected - begin, scan(begin, end) - begin)
+                        << "length " << length << ", position " << position << ", char " << ch;
+                }
+            }
+        }
+    }
+}
+
+
+TEST(Scan, BasicString) {
+    test_scanner(&loltoml::detail::scan_basic_string, &loltoml::detail::is_special<'"', '\\', false, false>);
+}
+
+TEST(Scan, MultilineString) {
+    test_scanner(&loltoml::detail::scan_multiline_string, &loltoml::detail::is_special<'"', '\\', false, true>);
+}
+
+TEST(Scan, LiteralString) {
+    test_scanner(&loltoml::detail::scan_literal_string, &loltoml::detail::is_special<'\'', '\'', true, false>);
+}
+
+TEST(Scan, MultilineLiteralString) {
+    test_scanner(&loltoml::detail::scan_multiline_literal_string, &loltoml::detail::is_special<'\'', '\'', true, true>);
+}
+
+TEST(Scan, Comment) {
+    test_scanner(&loltoml::detail::scan_comment, &loltoml::detail::is_special<'\0', '\0', true, false>);
+}
+
+TEST(Scan, LongStrings) {
+    std::string value(1000, 'x');
+    value[500] = '\t';
+
+    std::string document = "a = \"" + std::string(1000, 'x') + "\"\n" +
+                           "b = '" + value + "'\n" +
+                           "c = \"\"\"\n" + value.substr(0, 300) + "\n\"" + value.substr(600) + "\"\"\"\n" +
+                           "# " + value + "\n";
+
+    events_aggregator_t handler;
+    loltoml::parse(document.data(), document.size(), handler);
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::key, "a"},
+        {sax_event_t::string, std::string(1000, 'x')},
+        {sax_event_t::key, "b"},
+        {sax_event_t::string, value},
+        {sax_event_t::key, "c"},
+        {sax_event_t::string, value.substr(0, 300) + "\n\"" + value.substr(600)},
+        {sax_event_t::comment, " " + value},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+}
+
+TEST(Scan, LongStringErrors) {
+    std::string document = "a = \"" + std::string(100, 'x') + "\x01\"";
+    events_aggregator_t handler;
+
+    try {
+        loltoml::parse(document.data(), document.size(), handler);
+        FAIL();
+    } catch (const loltoml::parser_error_t &e) {
+        EXPECT_EQ(105, e.offset());
+    }
+}
@@ -0,0 +1,221 @@
+#include "common.hpp"
+
+#include "loltoml/section_index.hpp"
+
+#include <string>
+#include <vector>
+
+
+namespace {
+
+const char *document =
+    "title = \"index\"\n"
+    "# [not.a.table]\n"
+    "\n"
+    "[service.alpha]\n"
+    "port = 1\n"
+    "notes = \"\"\"\n"
+    "[service.beta]\n"
+    "\"\"\"\n"
+    "\n"
+    "[[service.list]]\n"
+    "port = 2\n"
+    "\n"
+    "  [ service . \"beta\" ] # comment\n"
+    "ports = [\n"
+    "[1],\n"
+    "]\n"
+    "\n"
+    "[[service.list]]\n"
+    "port = 3\n";
+
+std::vector<sax_event_t> parse_section(const loltoml::section_index_t &index,
+                                       const std::string &input,
+                                       const loltoml::section_index_t::section_t &section)
+{
+    events_aggregator_t handler;
+    EXPECT_TRUE(index.parse(input.data(), input.size(), section, handler, true));
+    return handler.events;
+}
+
+} // namespace
+
+
+TEST(SectionIndex, Sections) {
+    std::string input = document;
+
+    loltoml::section_index_t index;
+    index.build(input.data(), input.size());
+
+    typedef loltoml::section_index_t::section_type_t type_t;
+    const std::vector<loltoml::section_index_t::section_t> &sections = index.sections();
+
+    ASSERT_EQ(5, sections.size());
+    EXPECT_EQ(input.size(), index.document_size());
+
+    EXPECT_EQ(type_t::root, sections[0].type);
+    EXPECT_TRUE(sections[0].path.empty());
+    EXPECT_EQ(0, sections[0].begin);
+    EXPECT_EQ(input.find("[service.alpha]"), sections[0].end);
+
+    EXPECT_EQ(type_t::table, sections[1].type);
+    EXPECT_EQ(std::vector<std::string>({"service", "alpha"}), sections[1].path);
+    EXPECT_EQ(input.find("[[service.list]]"), sections[1].end);
+
+    EXPECT_EQ(type_t::array_table, sections[2].type);
+    EXPECT_EQ(std::vector<std::string>({"service", "list"}), sections[2].path);
+    EXPECT_EQ(input.find("  [ service"), sections[2].end);
+
+    EXPECT_EQ(type_t::table, sections[3].type);
+    EXPECT_EQ(std::vector<std::string>({"service", "beta"}), sections[3].path);
+
+    EXPECT_EQ(type_t::array_table, sections[4].type);
+    EXPECT_EQ(input.size(), sections[4].end);
+
+    for (std::size_t i = 1; i < sections.size(); ++i) {
+        EXPECT_EQ(sections[i - 1].end, sections[i].begin);
+    }
+}
+
+TEST(SectionIndex, Find) {
+    std::string input = document;
+
+    loltoml::section_index_t index;
+    index.build(input.data(), input.size());
+
+    const loltoml::section_index_t::section_t *beta = index.find({"service", "beta"});
+    ASSERT_NE(nullptr, beta);
+
+    std::vector<sax_event_t> expected = {
+        sax_event_t::start_document,
+        sax_event_t(sax_event_t::table, {"service", "beta"}),
+        sax_event_t(sax_event_t::comment, " comment"),
+        sax_event_t(sax_event_t::key, "ports"),
+        sax_event_t::start_array,
+        sax_event_t::start_array,
+        sax_event_t(sax_event_t::integer, 1),
+        sax_event_t(sax_event_t::finish_array, 1),
+        sax_event_t(sax_event_t::finish_array, 1),
+        sax_event_t::finish_document
+    };
+
+    EXPECT_EQ(expected, parse_section(index, input, *beta));
+
+    EXPECT_EQ(nullptr, index.find({"service"}));
+    EXPECT_EQ(nullptr, index.find({"service", "list"}));
+    EXPECT_EQ(nullptr, index.find({"not", "a", "table"}));
+
+    std::vector<const loltoml::section_index_t::section_t *> list;
+    index.find_array_tables({"service", "list"}, list);
+    ASSERT_EQ(2, list.size());
+
+    expected = {
+        sax_event_t::start_document,
+        sax_event_t(sax_event_t::table_array_item, {"service", "list"}),
+        sax_event_t(sax_event_t::key, "port"),
+        sax_event_t(sax_event_t::integer, 3),
+        sax_event_t::finish_document
+    };
+
+    EXPECT_EQ(expected, parse_section(index, input, *list[1]));
+
+    expected = {
+        sax_event_t::start_document,
+        sax_event_t(sax_event_t::key, "title"),
+        sax_event_t(sax_event_t::string, "index"),
+        sax_event_t(sax_event_t::comment, " [not.a.table]"),
+        sax_event_t::finish_document
+    };
+
+    EXPECT_EQ(expected, parse_section(index, input, index.sections().front()));
+}
+
+TEST(SectionIndex, FirstLineHeader) {
+    std::string input = " [a]\nb = 1\n";
+
+    loltoml::section_index_t index;
+    index.build(input.data(), input.size());
+
+    ASSERT_EQ(2, index.sections().size());
+    EXPECT_EQ(0, index.sections()[0].end);
+    ASSERT_NE(nullptr, index.find({"a"}));
+    EXPECT_EQ(input.size(), index.find({"a"})->end - index.find({"a"})->begin);
+
+    index.build("", 0);
+    ASSERT_EQ(1, index.sections().size());
+    EXPECT_EQ(0, index.sections()[0].end);
+}
+
+TEST(SectionIndex, SaveLoad) {
+    std::string input = document;
+
+    loltoml::section_index_t index;
+    index.build(input.data(), input.size());
+
+    std::string saved;
+    index.save(saved);
+
+    loltoml::section_index_t loaded;
+    ASSERT_TRUE(loaded.load(saved));
+    EXPECT_EQ(index.document_size(), loaded.document_size());
+    ASSERT_EQ(index.sections().size(), loaded.sections().size());
+
+    for (std::size_t i = 0; i < index.sections().size(); ++i) {
+        EXPECT_EQ(index.sections()[i].type, loaded.sections()[i].type);
+        EXPECT_EQ(index.sections()[i].path, loaded.sections()[i].path);
+        EXPECT_EQ(index.sections()[i].begin, loaded.sections()[i].begin);
+        EXPECT_EQ(index.sections()[i].end, loaded.sections()[i].end);
+    }
+
+    ASSERT_NE(nullptr, loaded.find({"service", "alpha"}));
+    EXPECT_EQ(index.find({"service", "alpha"})->begin, loaded.find({"service", "alpha"})->begin);
+
+    // Every truncation must be detected.
+    for (std::size_t size = 0; size < saved.size(); ++size) {
+        EXPECT_FALSE(loaded.load(saved.data(), size));
+        EXPECT_TRUE(loaded.sections().empty());
+    }
+
+    std::string corrupted = saved;
+    corrupted[0] = 'X';
+    EXPECT_FALSE(loaded.load(corrupted));
+
+    corrupted = saved;
+    corrupted.push_back('\0');
+    EXPECT_FALSE(loaded.load(corrupted));
+
+    // The count of sections.
+    corrupted = saved;
+    corrupted[24 + 7] = '\x7F';
+    EXPECT_FALSE(loaded.load(corrupted));
+
+    // The end of the root section.
+    corrupted = saved;
+    corrupted[32 + 9] = static_cast<char>(corrupted[32 + 9] + 1);
+    EXPECT_FALSE(loaded.load(corrupted));
+}
+
+TEST(SectionIndex, Errors) {
+    loltoml::section_index_t index;
+
+    try {
+        index.build("a = 1\n[b\n", 9);
+        FAIL();
+    } catch (const loltoml::parser_error_t &e) {
+        EXPECT_EQ(8, e.offset());
+        EXPECT_TRUE(index.sections().empty());
+    }
+
+    std::string input = "[a]\nb = 1\n[c]\nd = \n";
+    index.build(input.data(), input.size());
+
+    events_aggregator_t handler;
+    EXPECT_THROW(index.parse(input.data(), input.size() - 1, *index.find({"c"}), handler), std::invalid_argument);
+
+    try {
+        index.parse(input.data(), input.size(), *index.find({"c"}), handler);
+        FAIL();
+    } catch (const loltoml::parser_error_t &e) {
+        EXPECT_EQ(18, e.offset());
+    }
+}
@@ -0,0 +1,422 @@
+#include "common.hpp"
+
+#include "loltoml/action.hpp"
+#include "loltoml/detail/parallel.hpp"
+#include "loltoml/parser.hpp"
+#include "loltoml/reader.hpp"
+#include "loltoml/stream_parser.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+
+namespace {
+
+struct skipping_handler_t :
+    public events_aggregator_t
+{
+    std::set<std::string> skipped;
+
+    loltoml::action_t key(const std::string &key) {
+        events.emplace_back(sax_event_t::key, key);
+        return skipped.count(key) > 0 ? loltoml::action_t::skip_value : loltoml::action_t::proceed;
+    }
+};
+
+// Events of the full parse without the values of the skipped keys.
+std::vector<sax_event_t> expected_events(const std::string &input, const std::set<std::string> &skipped) {
+    events_aggregator_t handler;
+    loltoml::parse(input, handler);
+
+    std::vector<sax_event_t> result;
+
+    for (auto it = handler.events.begin(); it != handler.events.end(); ++it) {
+        result.push_back(*it);
+
+        if (it->type == sax_event_t::key && skipped.count(it->string_data) > 0) {
+            std::size_t depth = 0;
+
+            do {
+                ++it;
+
+                if (it->type == sax_event_t::start_array || it->type == sax_event_t::start_inline_table) {
+                    ++depth;
+                } else if (it->type == sax_event_t::finish_array || it->type == sax_event_t::finish_inline_table) {
+                    --depth;
+                }
+            } while (depth > 0);
+        }
+    }
+
+    return result;
+}
+
+void test_skip(const std::string &input, const std::set<std::string> &skipped) {
+    SCOPED_TRACE("parse '" + input.substr(0, 100) + "'");
+
+    std::vector<sax_event_t> expected = expected_events(input, skipped);
+
+    skipping_handler_t buffer_handler;
+    buffer_handler.skipped = skipped;
+    loltoml::parse(input, buffer_handler);
+    EXPECT_EQ(expected, buffer_handler.events);
+
+    skipping_handler_t stream_handler;
+    stream_handler.skipped = skipped;
+    std::istringstream stream(input);
+    loltoml::parse(stream, stream_handler);
+    EXPECT_EQ(expected, stream_handler.events);
+}
+
+std::size_t skip_error_offset(const std::string &input) {
+    skipping_handler_t handler;
+    handler.skipped = {"a"};
+
+    try {
+        loltoml::parse(input, handler);
+    } catch (const loltoml::parser_error_t &e) {
+        return e.offset();
+    }
+
+    ADD_FAILURE() << "No error in " << input;
+    return 0;
+}
+
+} // namespace
+
+
+TEST(Skip, Values) {
+    std::set<std::string> skipped = {"a"};
+
+    test_skip("a = 1\nb = 2", skipped);
+    test_skip("a = -1.5e3 # comment\nb = 2", skipped);
+    test_skip("a = true\nb = false", skipped);
+    test_skip("a = 1979-05-27T07:32:00.999999-07:00\nb = 2", skipped);
+    test_skip("a = \"string with \\\"quotes\\\" and [brackets]\"\nb = 2", skipped);
+    test_skip("a = \"\"\nb = ''\n", skipped);
+    test_skip("a = \"\"\"\nmulti \"\" \\\"\"\"\nline \\\n  ] }\"\"\"\nb = 2", skipped);
+    test_skip("a = 'literal \\'\nb = 2", skipped);
+    test_skip("a = '''\nmulti '' line ]'''\nb = 2", skipped);
+    test_skip("a = [[1], [[2, 3]], [\"]\", ']'], [{x = 1}]]\nb = 2", skipped);
+    test_skip("a = [\n  1, # ] comment\n  2,\n]\nb = 2", skipped);
+    test_skip("a = {x = {y = [1, 2]}, z = \"}\"}\nb = 2", skipped);
+    test_skip("b = 2\na = [1]", skipped);
+}
+
+TEST(Skip, InsideInlineTables) {
+    test_skip("t = {a = [1, 2], b = 1, a = 'x'}\n", {"a"});
+    test_skip("t = {b = 1, a = {c = 1}}\n", {"a"});
+    test_skip("t = {a = 1}\n", {"a"});
+    test_skip("t = [{a = 1, b = 2}, {b = 3, a = [\"}\"]}]\n", {"a"});
+}
+
+TEST(Skip, ComplexDocument) {
+    std::ifstream file(TESTS_ROOT "documents/complex.toml");
+    std::string document((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    ASSERT_FALSE(document.empty());
+
+    // Collect all the keys and skip each of them in turn.
+    events_aggregator_t handler;
+    loltoml::parse(document, handler);
+
+    std::set<std::string> keys;
+
+    for (auto it = handler.events.begin(); it != handler.events.end(); ++it) {
+        if (it->type == sax_event_t::key) {
+            keys.insert(it->string_data);
+        }
+    }
+
+    for (auto it = keys.begin(); it != keys.end(); ++it) {
+        test_skip(document, {*it});
+    }
+
+    test_skip(document, keys);
+}
+
+TEST(Skip, ContentIsNotValidated) {
+    const char *inputs[] = {
+        "a = [1, \"mixed\"]\n",
+        "a = [1.0e1000]\n",
+        "a = \"\\q\"\n",
+        "a = 99999999999999999999\n",
+        "a = {b = 1, b = 2}\n"
+    };
+
+    std::vector<sax_event_t> expected = {
+        sax_event_t::start_document,
+        sax_event_t(sax_event_t::key, "a"),
+        sax_event_t::finish_document
+    };
+
+    for (std::size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        skipping_handler_t handler;
+        handler.skipped = {"a"};
+
+        loltoml::parser_t<skipping_handler_t> parser(handler);
+        parser.set_key_validation(true);
+        parser.parse(loltoml::string_view_t(inputs[i]));
+
+        EXPECT_EQ(expected, handler.events) << inputs[i];
+    }
+}
+
+TEST(Skip, Errors) {
+    EXPECT_EQ(4, skip_error_offset("a = \n"));
+    EXPECT_EQ(4, skip_error_offset("a = ]\n"));
+    EXPECT_EQ(6, skip_error_offset("a = 1 2\n"));
+    EXPECT_EQ(8, skip_error_offset("a = \"abc\nb = 1\n"));
+    EXPECT_EQ(8, skip_error_offset("a = 'abc\nb = 1\n"));
+    EXPECT_EQ(5, skip_error_offset("a = \"\\\nb\"\n"));
+    EXPECT_EQ(10, skip_error_offset("a = [1, 2]]\n"));
+    EXPECT_EQ(16, skip_error_offset("a = [1, 2\nb = 1\n"));
+    EXPECT_EQ(17, skip_error_offset("a = \"\"\"abc\nb = 1\n"));
+    EXPECT_EQ(11, skip_error_offset("t = {a = 1 b = 2}\n"));
+    EXPECT_EQ(5, skip_error_offset("a = [}\n"));
+    EXPECT_EQ(11, skip_error_offset("a = {x = [1}}\n"));
+    EXPECT_EQ(135, skip_error_offset("a = " + std::string(65, '[') + std::string(65, '{') + "}]\n"));
+}
+
+TEST(Skip, DeeplyNested) {
+    std::string value = "1";
+    for (int i = 0; i < 100; ++i) {
+        value = (i % 3 == 0) ? "{x = " + value + "}" : "[" + value + "]";
+    }
+
+    test_skip("a = " + value + "\nb = 1\n", {"a"});
+}
+
+TEST(Skip, Reader) {
+    loltoml::reader_t reader(
+        "a = [1, {b = 2}]\n"
+        "c = {d = [\"x\"], e = 3}\n"
+        "f = \"bad escape \\q\" # comment\n"
+        "g = 4\n"
+    );
+
+    EXPECT_EQ(loltoml::event_type_t::start_document, reader.next());
+    EXPECT_EQ(loltoml::event_type_t::key, reader.next());
+    EXPECT_EQ("a", reader.string());
+    reader.skip_value();
+    EXPECT_EQ("a", reader.string());
+
+    EXPECT_EQ(loltoml::event_type_t::key, reader.next());
+    EXPECT_EQ("c", reader.string());
+    EXPECT_EQ(loltoml::event_type_t::start_inline_table, reader.next());
+    EXPECT_EQ(loltoml::event_type_t::key, reader.next());
+    EXPECT_EQ("d", reader.string());
+    reader.skip_value();
+    EXPECT_EQ(loltoml::event_type_t::key, reader.next());
+    EXPECT_EQ("e", reader.string());
+    reader.skip_value();
+    EXPECT_EQ(loltoml::event_type_t::finish_inline_table, reader.next());
+    EXPECT_EQ(2, reader.size());
+
+    // The value is invalid, but it's not parsed.
+    EXPECT_EQ(loltoml::event_type_t::key, reader.next());
+    EXPECT_EQ("f", reader.string());
+    reader.skip_value();
+    EXPECT_EQ(loltoml::event_type_t::comment, reader.next());
+    EXPECT_EQ(" comment", reader.string());
+
+    EXPECT_EQ(loltoml::event_type_t::key, reader.next());
+    EXPECT_EQ("g", reader.string());
+    EXPECT_EQ(loltoml::event_type_t::integer, reader.next());
+    EXPECT_EQ(4, reader.integer());
+    EXPECT_EQ(loltoml::event_type_t::finish_document, reader.next());
+}
+
+TEST(Skip, Parallel) {
+    std::string input;
+
+    for (std::size_t i = 0; i < 100; ++i) {
+        input += "[t" + std::to_string(i) + "]\na = [{b = 2}, {c = 3}]\nd = {a = 1, e = 2}\n";
+    }
+
+    std::set<std::string> skipped = {"a"};
+    std::vector<sax_event_t> expected = expected_events(input, skipped);
+
+    skipping_handler_t handler;
+    handler.skipped = skipped;
+    loltoml::detail::parser_buffers_t buffers;
+    loltoml::detail::parse_parallel(input.data(), input.size(), handler, buffers, 4, 100);
+
+    EXPECT_EQ(expected, handler.events);
+}
+
+namespace {
+
+struct table_skipping_handler_t :
+    public events_aggregator_t
+{
+    std::string skipped;
+
+    loltoml::action_t table(loltoml::key_iterator_t begin, loltoml::key_iterator_t end) {
+        events.emplace_back(sax_event_t::table, begin, end);
+        return (end - begin == 1 && *begin == skipped) ? loltoml::action_t::skip_value : loltoml::action_t::proceed;
+    }
+
+    loltoml::action_t array_table(loltoml::key_iterator_t begin, loltoml::key_iterator_t end) {
+        events.emplace_back(sax_event_t::table_array_item, begin, end);
+        return (end - begin == 1 && *begin == skipped) ? loltoml::action_t::skip_value : loltoml::action_t::proceed;
+    }
+};
+
+struct stopping_handler_t :
+    public events_aggregator_t
+{
+    std::string stop_at;
+
+    loltoml::action_t key(const std::string &key) {
+        events.emplace_back(sax_event_t::key, key);
+        return key == stop_at ? loltoml::action_t::stop : loltoml::action_t::proceed;
+    }
+
+    loltoml::action_t table(loltoml::key_iterator_t begin, loltoml::key_iterator_t end) {
+        events.emplace_back(sax_event_t::table, begin, end);
+        return (end - begin == 1 && *begin == stop_at) ? loltoml::action_t::stop : loltoml::action_t::proceed;
+    }
+};
+
+} // namespace
+
+
+TEST(Skip, Tables) {
+    std::string input =
+        "a = 1\n"
+        "[t]\n"
+        "b = [1, 2] # comment\n"
+        "# comment\n"
+        "\"c\" = {d = \"\\u0041\"}\n"
+        "[u]\n"
+        "e = 2\n"
+        "[[t]]\n"
+        "f = 3\n"
+        "[[v]]\n"
+        "g = 4\n";
+
+    std::vector<sax_event_t> expected = {
+        sax_event_t::start_document,
+        sax_event_t(sax_event_t::key, "a"),
+        sax_event_t(sax_event_t::integer, 1),
+        sax_event_t(sax_event_t::table, {"t"}),
+        sax_event_t(sax_event_t::table, {"u"}),
+        sax_event_t(sax_event_t::key, "e"),
+        sax_event_t(sax_event_t::integer, 2),
+        sax_event_t(sax_event_t::table_array_item, {"t"}),
+        sax_event_t(sax_event_t::table_array_item, {"v"}),
+        sax_event_t(sax_event_t::key, "g"),
+        sax_event_t(sax_event_t::integer, 4),
+        sax_event_t::finish_document
+    };
+
+    table_skipping_handler_t buffer_handler;
+    buffer_handler.skipped = "t";
+    EXPECT_TRUE(loltoml::parse(input, buffer_handler));
+    EXPECT_EQ(expected, buffer_handler.events);
+
+    table_skipping_handler_t stream_handler;
+    stream_handler.skipped = "t";
+    std::istringstream stream(input);
+    EXPECT_TRUE(loltoml::parse(stream, stream_handler));
+    EXPECT_EQ(expected, stream_handler.events);
+
+    // Headers of the skipped tables are still validated.
+    table_skipping_handler_t handler;
+    handler.skipped = "t";
+    loltoml::parser_t<table_skipping_handler_t> parser(handler);
+    parser.set_key_validation(true);
+    EXPECT_THROW(parser.parse(input + "[t]\n"), loltoml::parser_error_t);
+}
+
+TEST(Skip, Stop) {
+    std::string input =
+        "a = 1\n"
+        "t = {b = [{c = 2}, {d = 3}], e = 4}\n"
+        "[f]\n"
+        "g = 5\n"
+        "this is not toml\n";
+
+    std::vector<sax_event_t> all = expected_events(input.substr(0, input.find("this")), {});
+
+    // Stopping at each of the keys or the table emits the events up to it and doesn't call finish_document().
+    std::vector<std::string> stop_points = {"a", "b", "c", "d", "e", "f", "g"};
+
+    for (auto it = stop_points.begin(); it != stop_points.end(); ++it) {
+        SCOPED_TRACE("stop at " + *it);
+
+        std::vector<sax_event_t> expected;
+
+        for (auto event = all.begin(); event != all.end(); ++event) {
+            expected.push_back(*event);
+
+            if ((event->type == sax_event_t::key && event->string_data == *it) ||
+                (event->type == sax_event_t::table && event->keys == std::vector<std::string>({*it})))
+            {
+                break;
+            }
+        }
+
+        stopping_handler_t buffer_handler;
+        buffer_handler.stop_at = *it;
+        EXPECT_FALSE(loltoml::parse(input, buffer_handler));
+        EXPECT_EQ(expected, buffer_handler.events);
+
+        stopping_handler_t stream_handler;
+        stream_handler.stop_at = *it;
+        std::istringstream stream(input);
+        EXPECT_FALSE(loltoml::parse(stream, stream_handler));
+        EXPECT_EQ(expected, stream_handler.events);
+    }
+}
+
+TEST(Skip, StopStreamParser) {
+    stopping_handler_t handler;
+    handler.stop_at = "b";
+
+    loltoml::stream_parser_t<stopping_handler_t> parser(handler);
+    parser.feed("a = 1\nb = ");
+    EXPECT_FALSE(parser.stopped());
+    parser.feed("2\nc = 3\n");
+    EXPECT_TRUE(parser.stopped());
+    parser.feed("this is not toml\n");
+    EXPECT_FALSE(parser.finish());
+
+    std::vector<sax_event_t> expected = {
+        sax_event_t::start_document,
+        sax_event_t(sax_event_t::key, "a"),
+        sax_event_t(sax_event_t::integer, 1),
+        sax_event_t(sax_event_t::key, "b")
+    };
+
+    EXPECT_EQ(expected, handler.events);
+
+    // The next document is parsed as usual.
+    handler.events.clear();
+    parser.feed("a = 1\n");
+    EXPECT_TRUE(parser.finish());
+    EXPECT_EQ(sax_event_t::finish_document, handler.events.back().type);
+}
+
+TEST(Skip, StopParallel) {
+    std::string input;
+
+    for (std::size_t i = 0; i < 100; ++i) {
+        input += "[t" + std::to_string(i) + "]\na = 1\n";
+    }
+
+    std::vector<sax_event_t> expected = expected_events(input, {});
+    expected.resize(std::find(expected.begin(), expected.end(), sax_event_t(sax_event_t::table, {"t50"})) -
+                    expected.begin() + 1);
+
+    stopping_handler_t handler;
+    handler.stop_at = "t50";
+    loltoml::detail::parser_buffers_t buffers;
+    EXPECT_FALSE(loltoml::detail::parse_parallel(input.data(), input.size(), handler, buffers, 4, 100));
+
+    EXPECT_EQ(expected, handler.events);
+}
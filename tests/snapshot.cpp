@@ -0,0 +1,194 @@
+#include "common.hpp"
+
+#include "loltoml/snapshot.hpp"
+
+#include <string>
+
+
+namespace {
+
+const char *source =
+    "title = \"snapshot\"\n"
+    "negative = -42\n"
+    "ratio = 0.25\n"
+    "enabled = true\n"
+    "created = 1979-05-27T07:32:00Z\n"
+    "empty = []\n"
+    "matrix = [[1, 2], [3]]\n"
+    "point = {x = 1, y = {z = \"deep\"}}\n"
+    "[[items]]\n"
+    "name = \"first\"\n"
+    "[[items]]\n"
+    "name = \"second\"\n"
+    "[server.limits]\n"
+    "cpu = 1.5\n";
+
+// Checks that the snapshot holds the same tree as the document.
+void expect_equal(const loltoml::value_t &expected, const loltoml::snapshot_value_t &actual) {
+    ASSERT_EQ(expected.type(), actual.type());
+
+    switch (expected.type()) {
+        case loltoml::value_type_t::string: {
+            EXPECT_EQ(expected.as_string(), actual.as_string());
+        } break;
+        case loltoml::value_type_t::datetime: {
+            EXPECT_EQ(expected.as_datetime(), actual.as_datetime());
+        } break;
+        case loltoml::value_type_t::integer: {
+            EXPECT_EQ(expected.as_integer(), actual.as_integer());
+        } break;
+        case loltoml::value_type_t::floating_point: {
+            EXPECT_EQ(expected.as_floating_point(), actual.as_floating_point());
+        } break;
+        case loltoml::value_type_t::boolean: {
+            EXPECT_EQ(expected.as_boolean(), actual.as_boolean());
+        } break;
+        case loltoml::value_type_t::array: {
+            loltoml::array_t array = expected.as_array();
+            ASSERT_EQ(array.size(), actual.as_array().size());
+
+            for (std::size_t i = 0; i < array.size(); ++i) {
+                expect_equal(array[i], actual.as_array()[i]);
+            }
+        } break;
+        case loltoml::value_type_t::table: {
+            loltoml::table_t table = expected.as_table();
+            ASSERT_EQ(table.size(), actual.as_table().size());
+
+            std::size_t i = 0;
+            for (auto it = table.begin(); it != table.end(); ++it, ++i) {
+                loltoml::snapshot_member_t member = actual.as_table()[i];
+                EXPECT_EQ(it->key, member.key);
+                expect_equal(it->value, member.value);
+            }
+        } break;
+    }
+}
+
+// Reads every value, so that sanitizers would catch reads outside of the snapshot.
+std::size_t visit(const loltoml::snapshot_value_t &value) {
+    std::size_t result = 1;
+
+    if (value.is_string()) {
+        result += value.as_string().to_string().size();
+    } else if (value.is_array()) {
+        for (std::size_t i = 0; i < value.as_array().size(); ++i) {
+            result += visit(value.as_array()[i]);
+        }
+    } else if (value.is_table()) {
+        for (std::size_t i = 0; i < value.as_table().size(); ++i) {
+            result += value.as_table()[i].key.to_string().size() + visit(value.as_table()[i].value);
+        }
+    }
+
+    return result;
+}
+
+} // namespace
+
+
+TEST(Snapshot, Roundtrip) {
+    loltoml::document_t document;
+    document.parse(loltoml::string_view_t(source));
+
+    std::string data = "prefix";
+    loltoml::write_snapshot(document, data);
+    data.erase(0, 6);
+
+    // The snapshot doesn't depend on its position in memory.
+    std::string copy = " " + data;
+
+    loltoml::snapshot_t snapshot;
+    ASSERT_TRUE(snapshot.load(copy.data() + 1, data.size()));
+    EXPECT_EQ(data.size(), snapshot.size());
+
+    expect_equal(document.root(), snapshot.root());
+
+    loltoml::snapshot_value_t value;
+    ASSERT_TRUE(snapshot.root().as_table().find("negative", value));
+    EXPECT_EQ(-42, value.as_integer());
+
+    ASSERT_TRUE(snapshot.root().as_table().find("items", value));
+    EXPECT_EQ("second", value.as_array()[1].as_table()[0].value.as_string());
+
+    EXPECT_FALSE(snapshot.root().as_table().find("missing", value));
+}
+
+TEST(Snapshot, ManyKeys) {
+    std::string input;
+    for (int i = 999; i >= 0; --i) {
+        input += "k" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+    }
+
+    input += "k = -1\n";
+
+    loltoml::document_t document;
+    document.parse(input);
+
+    std::string data;
+    loltoml::write_snapshot(document, data);
+
+    loltoml::snapshot_t snapshot;
+    ASSERT_TRUE(snapshot.load(data));
+
+    // Members are still listed in order of definition.
+    expect_equal(document.root(), snapshot.root());
+
+    loltoml::snapshot_table_t root = snapshot.root().as_table();
+    loltoml::snapshot_value_t value;
+
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(root.find("k" + std::to_string(i), value));
+        EXPECT_EQ(i, value.as_integer());
+    }
+
+    ASSERT_TRUE(root.find("k", value));
+    EXPECT_EQ(-1, value.as_integer());
+
+    EXPECT_FALSE(root.find("", value));
+    EXPECT_FALSE(root.find("k1000", value));
+    EXPECT_FALSE(root.find("j", value));
+    EXPECT_FALSE(root.find("l", value));
+}
+
+TEST(Snapshot, EmptyDocument) {
+    loltoml::document_t document;
+
+    std::string data;
+    loltoml::write_snapshot(document, data);
+
+    loltoml::snapshot_t snapshot;
+    ASSERT_TRUE(snapshot.load(data));
+    EXPECT_TRUE(snapshot.root().as_table().empty());
+}
+
+TEST(Snapshot, Corrupted) {
+    loltoml::document_t document;
+    document.parse(loltoml::string_view_t(source));
+
+    std::string data;
+    loltoml::write_snapshot(document, data);
+
+    loltoml::snapshot_t snapshot;
+    EXPECT_TRUE(snapshot.empty());
+
+    for (std::size_t size = 0; size < data.size(); ++size) {
+        EXPECT_FALSE(snapshot.load(data.data(), size));
+        EXPECT_TRUE(snapshot.empty());
+    }
+
+    // A flipped bit either is detected or leaves the snapshot safe to read.
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        for (int bit = 0; bit < 8; ++bit) {
+            std::string corrupted = data;
+            corrupted[i] = static_cast<char>(corrupted[i] ^ (1 << bit));
+
+            if (snapshot.load(corrupted)) {
+                visit(snapshot.root());
+            }
+        }
+    }
+
+    std::string grown = data + '\0';
+    EXPECT_FALSE(snapshot.load(grown));
+}
@@ -0,0 +1,210 @@
+#include "common.hpp"
+
+#include "loltoml/parser.hpp"
+#include "loltoml/stats.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+// This file is compiled twice: into loltoml-unittests and, with LOLTOML_ENABLE_STATS, into loltoml-stats-tests.
+
+
+namespace {
+
+const std::string document =
+    "# c\n"
+    "[a.b]\n"
+    "x = \"s\"\n"
+    "y = [1, 2]\n"
+    "f = 2.5\n"
+    "z = {t = true}\n"
+    "d = 1979-05-27T07:32:00Z\n"
+    "[[arr]]\n"
+    "l = 'lit'\n";
+
+void expect_document_stats(const loltoml::parse_stats_t &stats, std::size_t runs) {
+    using loltoml::parse_event_t;
+    using loltoml::grammar_production_t;
+
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::start_document));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::finish_document));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::comment));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::table));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::array_table));
+    EXPECT_EQ(7 * runs, stats.event_count(parse_event_t::key));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::start_array));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::finish_array));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::start_inline_table));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::finish_inline_table));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::boolean));
+    EXPECT_EQ(2 * runs, stats.event_count(parse_event_t::string));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::datetime));
+    EXPECT_EQ(2 * runs, stats.event_count(parse_event_t::integer));
+    EXPECT_EQ(1 * runs, stats.event_count(parse_event_t::floating_point));
+
+    EXPECT_EQ(document.size() * runs, stats.consumed(grammar_production_t::document));
+    EXPECT_EQ(3 * runs, stats.consumed(grammar_production_t::comment));
+    EXPECT_EQ(12 * runs, stats.consumed(grammar_production_t::table_header));
+    EXPECT_EQ(12 * runs, stats.consumed(grammar_production_t::key));
+    EXPECT_EQ(3 * runs, stats.consumed(grammar_production_t::basic_string));
+    EXPECT_EQ(0 * runs, stats.consumed(grammar_production_t::multiline_string));
+    EXPECT_EQ(5 * runs, stats.consumed(grammar_production_t::literal_string));
+    EXPECT_EQ(0 * runs, stats.consumed(grammar_production_t::multiline_literal_string));
+    EXPECT_EQ(2 * runs, stats.consumed(grammar_production_t::integer));
+    EXPECT_EQ(3 * runs, stats.consumed(grammar_production_t::floating_point));
+    EXPECT_EQ(4 * runs, stats.consumed(grammar_production_t::boolean));
+    EXPECT_EQ(20 * runs, stats.consumed(grammar_production_t::datetime));
+    EXPECT_EQ(6 * runs, stats.consumed(grammar_production_t::array));
+    EXPECT_EQ(10 * runs, stats.consumed(grammar_production_t::inline_table));
+    EXPECT_EQ(0 * runs, stats.consumed(grammar_production_t::skipped_value));
+}
+
+void expect_zero(const loltoml::parse_stats_t &stats) {
+    EXPECT_EQ(loltoml::parse_stats_t(), stats);
+}
+
+} // namespace
+
+
+namespace loltoml {
+
+bool operator==(const parse_stats_t &left, const parse_stats_t &right) {
+    return left.allocations == right.allocations &&
+           left.allocated_bytes == right.allocated_bytes &&
+           left.peak_scratch_size == right.peak_scratch_size &&
+           std::equal(left.events, left.events + parse_stats_t::events_count, right.events) &&
+           std::equal(left.bytes, left.bytes + parse_stats_t::productions_count, right.bytes);
+}
+
+} // namespace loltoml
+
+
+TEST(Stats, Buffer) {
+    events_aggregator_t handler;
+    loltoml::parse_stats_t stats;
+    loltoml::parse(document.data(), document.size(), handler, stats);
+
+    if (!loltoml::parse_stats_t::enabled()) {
+        expect_zero(stats);
+        return;
+    }
+
+    expect_document_stats(stats, 1);
+    EXPECT_GT(stats.allocations, 0u);
+    EXPECT_GT(stats.peak_scratch_size, 0u);
+
+    // The counters are accumulated.
+    loltoml::parse(document, handler, stats);
+    expect_document_stats(stats, 2);
+}
+
+TEST(Stats, Stream) {
+    events_aggregator_t handler;
+    loltoml::parse_stats_t stats;
+    std::istringstream input(document);
+    loltoml::parse(input, handler, stats);
+
+    if (!loltoml::parse_stats_t::enabled()) {
+        expect_zero(stats);
+        return;
+    }
+
+    expect_document_stats(stats, 1);
+}
+
+TEST(Stats, ReusedBuffers) {
+    events_aggregator_t handler;
+    loltoml::parser_t<events_aggregator_t> parser(handler);
+    loltoml::parse_stats_t stats;
+    parser.set_stats(&stats);
+
+    // Escapes make the parser unescape the string into its own buffer.
+    std::string value(1000, 'a');
+    std::string input = "s = \"\\t" + value + "\"\n";
+
+    parser.parse(input);
+
+    if (!loltoml::parse_stats_t::enabled()) {
+        expect_zero(stats);
+        return;
+    }
+
+    EXPECT_GE(stats.allocated_bytes, value.size());
+    EXPECT_GE(stats.peak_scratch_size, value.size());
+    EXPECT_EQ(input.size() - 5, stats.consumed(loltoml::grammar_production_t::basic_string));
+
+    // The buffers are kept by the parser, so the next run doesn't allocate.
+    loltoml::parse_stats_t second;
+    parser.set_stats(&second);
+    parser.parse(input);
+
+    EXPECT_EQ(0u, second.allocations);
+    EXPECT_EQ(0u, second.allocated_bytes);
+    EXPECT_EQ(1u, second.event_count(loltoml::parse_event_t::string));
+
+    parser.set_stats(nullptr);
+    parser.parse(input);
+    EXPECT_EQ(1u, second.event_count(loltoml::parse_event_t::string));
+}
+
+TEST(Stats, Productions) {
+    struct skipping_handler_t : events_aggregator_t {
+        loltoml::action_t key(const std::string &key) {
+            events_aggregator_t::key(key);
+            return key == "skipped" ? loltoml::action_t::skip_value : loltoml::action_t::proceed;
+        }
+    };
+
+    skipping_handler_t handler;
+    loltoml::parse_stats_t stats;
+    loltoml::parse(loltoml::string_view_t("m = \"\"\"\nab\"\"\"\nl = '''x'''\nskipped = [1, 2]\n"), handler, stats);
+
+    if (!loltoml::parse_stats_t::enabled()) {
+        expect_zero(stats);
+        return;
+    }
+
+    EXPECT_EQ(9u, stats.consumed(loltoml::grammar_production_t::multiline_string));
+    EXPECT_EQ(7u, stats.consumed(loltoml::grammar_production_t::multiline_literal_string));
+    EXPECT_EQ(6u, stats.consumed(loltoml::grammar_production_t::skipped_value));
+    EXPECT_EQ(0u, stats.consumed(loltoml::grammar_production_t::array));
+    EXPECT_EQ(0u, stats.event_count(loltoml::parse_event_t::integer));
+}
+
+TEST(Stats, SkippedBrackets) {
+    struct skipping_handler_t : events_aggregator_t {
+        loltoml::action_t key(const std::string &key) {
+            events_aggregator_t::key(key);
+            return loltoml::action_t::skip_value;
+        }
+    };
+
+    // Brackets deeper than 64 levels are kept in a buffer of the parser.
+    const std::size_t depth = 200;
+    std::string input = "a = " + std::string(depth, '[') + std::string(depth, ']') + "\n";
+
+    skipping_handler_t handler;
+    loltoml::parser_t<skipping_handler_t> parser(handler);
+    loltoml::parse_stats_t stats;
+    parser.set_stats(&stats);
+    parser.parse(input);
+
+    if (!loltoml::parse_stats_t::enabled()) {
+        expect_zero(stats);
+        return;
+    }
+
+    EXPECT_EQ(input.size() - 5, stats.consumed(loltoml::grammar_production_t::skipped_value));
+    EXPECT_GT(stats.allocations, 0u);
+    EXPECT_GE(stats.allocated_bytes, depth - 64);
+    EXPECT_GE(stats.peak_scratch_size, depth - 64);
+
+    // The buffer is kept by the parser, so the next run doesn't allocate.
+    loltoml::parse_stats_t second;
+    parser.set_stats(&second);
+    parser.parse(input);
+
+    EXPECT_EQ(0u, second.allocations);
+    EXPECT_EQ(stats.peak_scratch_size, second.peak_scratch_size);
+}
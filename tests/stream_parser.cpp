@@ -0,0 +1,217 @@
+#include "common.hpp"
+
+#include "loltoml/stream_parser.hpp"
+
+#include <fstream>
+#include <iterator>
+
+
+namespace {
+
+struct result_t {
+    std::vector<sax_event_t> events;
+    bool failed;
+    std::string message;
+    std::size_t offset;
+};
+
+result_t parse_sequentially(const std::string &input) {
+    result_t result;
+    result.failed = false;
+    result.offset = 0;
+
+    events_aggregator_t handler;
+
+    try {
+        loltoml::parse(input, handler);
+    } catch (const loltoml::parser_error_t &e) {
+        result.failed = true;
+        result.message = e.message();
+        result.offset = e.offset();
+    }
+
+    result.events = handler.events;
+    return result;
+}
+
+result_t parse_in_chunks(const std::string &input, std::size_t chunk_size) {
+    result_t result;
+    result.failed = false;
+    result.offset = 0;
+
+    events_aggregator_t handler;
+    loltoml::stream_parser_t<events_aggregator_t> parser(handler);
+
+    try {
+        for (std::size_t i = 0; i < input.size(); i += chunk_size) {
+            parser.feed(input.data() + i, std::min(chunk_size, input.size() - i));
+        }
+
+        parser.finish();
+    } catch (const loltoml::parser_error_t &e) {
+        result.failed = true;
+        result.message = e.message();
+        result.offset = e.offset();
+    }
+
+    result.events = handler.events;
+    return result;
+}
+
+void test_same_as_sequential(const std::string &input) {
+    SCOPED_TRACE("parse '" + input.substr(0, 100) + "'");
+
+    result_t expected = parse_sequentially(input);
+    std::vector<std::size_t> chunk_sizes = {1, 2, 3, 5, 8, 13, 64, input.size() + 1};
+
+    for (auto it = chunk_sizes.begin(); it != chunk_sizes.end(); ++it) {
+        SCOPED_TRACE("chunk size " + std::to_string(*it));
+
+        result_t result = parse_in_chunks(input, *it);
+
+        EXPECT_EQ(expected.events, result.events);
+        EXPECT_EQ(expected.failed, result.failed);
+        EXPECT_EQ(expected.message, result.message);
+        EXPECT_EQ(expected.offset, result.offset);
+    }
+}
+
+} // namespace
+
+
+TEST(StreamParser, Empty) {
+    test_same_as_sequential("");
+    test_same_as_sequential("\n");
+    test_same_as_sequential("  # comment");
+}
+
+TEST(StreamParser, SameEventsAsSequential) {
+    test_same_as_sequential(
+        "# [comment] \"with\" 'quotes'\r\n"
+        "title = \"[not a table]\" # \"\n"
+        "[a]\n"
+        "b = [\n"
+        "  [1, 2], # ]\n"
+        "  [\"]\", ']'],\n"
+        "]\n"
+        "c = \"\"\"\n"
+        "[d]\n"
+        "\\\"\"\" \"\" \\\n"
+        "  e\"\"\"\n"
+        "f = '''\n"
+        "[g]''\n"
+        "'''\n"
+        "h = {i = \"\", j = '', k = \"\\\"\", l = [{m = 1}]}\n"
+        "\"quoted [key]\" = 1979-05-27T07:32:00Z\n"
+        "  [[n.\"o\"]]\n"
+        "p = 1.5e-3\r\n"
+        "q = true"
+    );
+}
+
+TEST(StreamParser, ComplexDocument) {
+    std::ifstream file(TESTS_ROOT "documents/complex.toml");
+    std::string document((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    ASSERT_FALSE(document.empty());
+    test_same_as_sequential(document);
+}
+
+TEST(StreamParser, SameErrorsAsSequential) {
+    test_same_as_sequential("a = 1\nb = \"unterminated\nc = 2\n");
+    test_same_as_sequential("a = 1\n[b\n]\nc = 2\n");
+    test_same_as_sequential("a = [1,\n2\nb = 1\n");
+    test_same_as_sequential("a = ]\nb = [\n1]\n");
+    test_same_as_sequential("a = \"\"\"\nb = 1\n");
+    test_same_as_sequential("a = '''\nb = 1\n''' c\n");
+    test_same_as_sequential("a = {b = 1,\nc = 2}\n");
+    test_same_as_sequential("a = 1\nb =\n2\n");
+    test_same_as_sequential("a = 1 b = 2\n");
+    test_same_as_sequential("a = 1\n\nb = 99999999999999999999\n");
+    test_same_as_sequential("a = 1\n[b]\nc = [\n");
+}
+
+TEST(StreamParser, MemoryIsBoundedByExpression) {
+    std::string document;
+
+    for (std::size_t i = 0; i < 1000; ++i) {
+        document += "[table" + std::to_string(i) + "]\nkey = \"value\" # comment\n";
+    }
+
+    events_aggregator_t handler;
+    loltoml::stream_parser_t<events_aggregator_t> parser(handler);
+    std::size_t max_buffered = 0;
+
+    for (std::size_t i = 0; i < document.size(); ++i) {
+        parser.feed(document.data() + i, 1);
+        max_buffered = std::max(max_buffered, parser.buffered());
+    }
+
+    parser.finish();
+
+    EXPECT_EQ(parse_sequentially(document).events, handler.events);
+    EXPECT_GT(30, max_buffered);
+}
+
+TEST(StreamParser, EventsArriveWithNewLines) {
+    events_aggregator_t handler;
+    loltoml::stream_parser_t<events_aggregator_t> parser(handler);
+
+    parser.feed("a = 1");
+    EXPECT_EQ(1, handler.events.size());
+
+    parser.feed("2\nb = [\n");
+    EXPECT_EQ(3, handler.events.size());
+
+    parser.feed("1]\n");
+    EXPECT_EQ(7, handler.events.size());
+
+    parser.finish();
+    EXPECT_EQ(8, handler.events.size());
+    EXPECT_EQ(parse_sequentially("a = 12\nb = [\n1]\n").events, handler.events);
+}
+
+TEST(StreamParser, Reuse) {
+    events_aggregator_t handler;
+    loltoml::stream_parser_t<events_aggregator_t> parser(handler);
+
+    parser.feed("a = 1\n");
+    parser.finish();
+    parser.feed("b = 2\n");
+    parser.finish();
+
+    std::vector<sax_event_t> expected = parse_sequentially("a = 1\n").events;
+    std::vector<sax_event_t> second = parse_sequentially("b = 2\n").events;
+    expected.insert(expected.end(), second.begin(), second.end());
+
+    EXPECT_EQ(expected, handler.events);
+
+    handler.events.clear();
+    EXPECT_THROW(parser.feed("a = 1 2\n"), loltoml::parser_error_t);
+    parser.reset();
+    handler.events.clear();
+
+    parser.feed("c = 3");
+    parser.finish();
+
+    EXPECT_EQ(parse_sequentially("c = 3").events, handler.events);
+}
+
+TEST(StreamParser, KeyValidation) {
+    events_aggregator_t handler;
+    loltoml::stream_parser_t<events_aggregator_t> parser(handler);
+    parser.set_key_validation(true);
+
+    parser.feed("[a]\nb = 1\n[c]\n");
+
+    try {
+        parser.feed("[a]\n");
+        FAIL();
+    } catch (const loltoml::parser_error_t &e) {
+        EXPECT_EQ(14, e.offset());
+    }
+
+    parser.reset();
+    parser.feed("[a]\nb = 1\n");
+    parser.finish();
+}
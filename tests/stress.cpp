@@ -0,0 +1,71 @@
+#include "common.hpp"
+#include "generator.hpp"
+
+#include "loltoml/document.hpp"
+#include "loltoml/parser.hpp"
+#include "loltoml/stream_parser.hpp"
+#include "loltoml/writer.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+// Every shape is parsed by all the parsers, which must agree on the events.
+void stress(document_generator_t::shape_t shape, std::uint64_t seed) {
+    SCOPED_TRACE(document_generator_t::shape_name(shape));
+
+    std::string input = document_generator_t(shape, seed).generate(256 * 1024);
+
+    events_aggregator_t expected;
+    ASSERT_NO_THROW(loltoml::parse(input.data(), input.size(), expected));
+
+    events_aggregator_t from_stream;
+    std::istringstream stream(input);
+    loltoml::parse(stream, from_stream);
+    EXPECT_EQ(expected.events, from_stream.events);
+
+    events_aggregator_t from_chunks;
+    loltoml::stream_parser_t<events_aggregator_t> stream_parser(from_chunks);
+    for (std::size_t offset = 0; offset < input.size(); offset += 4093) {
+        stream_parser.feed(input.data() + offset, std::min<std::size_t>(4093, input.size() - offset));
+    }
+    stream_parser.finish();
+    EXPECT_EQ(expected.events, from_chunks.events);
+
+    events_aggregator_t from_threads;
+    loltoml::parser_t<events_aggregator_t> parser(from_threads);
+    parser.parse_parallel(input.data(), input.size(), 4);
+    EXPECT_EQ(expected.events, from_threads.events);
+
+    // The generated documents must be valid, including uniqueness of keys.
+    loltoml::document_t document;
+    EXPECT_NO_THROW(document.parse(input));
+
+    std::string written;
+    loltoml::writer_t<> writer(written);
+    loltoml::parse(input.data(), input.size(), writer);
+
+    events_aggregator_t rewritten;
+    loltoml::parse(written.data(), written.size(), rewritten);
+    EXPECT_EQ(expected.events, rewritten.events);
+}
+
+} // namespace
+
+
+TEST(Stress, Shapes) {
+    for (std::size_t i = 0; i < document_generator_t::shapes_count; ++i) {
+        stress(static_cast<document_generator_t::shape_t>(i), 1);
+    }
+}
+
+TEST(Stress, GeneratorIsDeterministic) {
+    document_generator_t::shape_t shape = document_generator_t::shape_t::mixed;
+
+    EXPECT_EQ(document_generator_t(shape, 7).generate(64 * 1024), document_generator_t(shape, 7).generate(64 * 1024));
+    EXPECT_NE(document_generator_t(shape, 7).generate(64 * 1024), document_generator_t(shape, 8).generate(64 * 1024));
+}
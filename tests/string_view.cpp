@@ -0,0 +1,91 @@
+#include "common.hpp"
+
+#include <sstream>
+
+
+namespace {
+    // Handler accepting string views. It also counts how many of them point into the input buffer.
+    struct view_handler_t :
+        public events_aggregator_t
+    {
+        const char *input_begin;
+        const char *input_end;
+        std::size_t views_into_input;
+
+        view_handler_t(const std::string &input) :
+            input_begin(input.data()),
+            input_end(input.data() + input.size()),
+            views_into_input(0)
+        { }
+
+        void count(loltoml::string_view_t value) {
+            if (value.data() >= input_begin && value.data() + value.size() <= input_end) {
+                ++views_into_input;
+            }
+        }
+
+        void comment(loltoml::string_view_t value) {
+            count(value);
+            events.emplace_back(sax_event_t::comment, value.to_string());
+        }
+
+        void key(loltoml::string_view_t value) {
+            count(value);
+            events.emplace_back(sax_event_t::key, value.to_string());
+        }
+
+        void string(loltoml::string_view_t value) {
+            count(value);
+            events.emplace_back(sax_event_t::string, value.to_string());
+        }
+
+        void datetime(loltoml::string_view_t value) {
+            events.emplace_back(sax_event_t::datetime, value.to_string());
+        }
+    };
+
+    void test_parsing(const std::string &document, std::size_t expected_views_into_input) {
+        std::string scope = "parse '" + escape_string(document) + "'";
+        SCOPED_TRACE(scope);
+
+        std::istringstream input(document);
+        events_aggregator_t expected_handler;
+        loltoml::parse(input, expected_handler);
+
+        view_handler_t handler(document);
+        loltoml::parse(document.data(), document.size(), handler);
+
+        EXPECT_EQ(expected_handler.events, handler.events);
+        EXPECT_EQ(expected_views_into_input, handler.views_into_input);
+
+        std::istringstream stream_input(document);
+        view_handler_t stream_handler(document);
+        loltoml::parse(stream_input, stream_handler);
+
+        EXPECT_EQ(expected_handler.events, stream_handler.events);
+        EXPECT_EQ(0, stream_handler.views_into_input);
+    }
+}
+
+
+TEST(StringView, PlainTokensReferenceInput) {
+    test_parsing("key = \"value\"\n", 2);
+    test_parsing("\"quoted key\" = 'literal'\n", 2);
+    test_parsing("key = \"\"\"\nmulti\n\"line\" \"\"\"\n", 2);
+    test_parsing("key = '''\nmulti\n'line'''\n", 2);
+    test_parsing("# comment\n", 1);
+    test_parsing("key = {a = \"b\", c = ['d']}\n", 5);
+}
+
+TEST(StringView, EscapedTokensAreCopied) {
+    test_parsing("key = \"esc\\taped\"\n", 1);
+    test_parsing("\"k\\u00e9y\" = 1\n", 0);
+    test_parsing("key = \"\"\"\nline \\\n    continuation\"\"\"\n", 1);
+    test_parsing("key = \"\"\"\r\ncrlf\r\nstring\"\"\"\n", 1);
+    test_parsing("key = '''\r\ncrlf\r\nstring'''\n", 1);
+}
+
+TEST(StringView, TokensAtTheEndOfInput) {
+    test_parsing("key = true # comment", 1);
+    test_parsing("key = 1979-05-27T07:32:00Z", 1);
+}
@@ -0,0 +1,155 @@
+#include "common.hpp"
+
+#include "loltoml/parser.hpp"
+#include "loltoml/symbol_table.hpp"
+
+#include <thread>
+
+
+namespace {
+
+struct symbol_handler_t : public events_aggregator_t {
+    using events_aggregator_t::key;
+    using events_aggregator_t::table;
+    using events_aggregator_t::array_table;
+
+    std::vector<std::uint32_t> ids;
+
+    void key(const loltoml::symbol_t &key) {
+        ids.push_back(key.id);
+        events_aggregator_t::key(key.text.to_string());
+    }
+
+    void table(loltoml::symbol_iterator_t begin, loltoml::symbol_iterator_t end) {
+        events.push_back({sax_event_t::table, path(begin, end)});
+    }
+
+    void array_table(loltoml::symbol_iterator_t begin, loltoml::symbol_iterator_t end) {
+        events.push_back({sax_event_t::table_array_item, path(begin, end)});
+    }
+
+    std::vector<std::string> path(loltoml::symbol_iterator_t begin, loltoml::symbol_iterator_t end) {
+        std::vector<std::string> result;
+
+        for (; begin != end; ++begin) {
+            ids.push_back(begin->id);
+            result.push_back(begin->text.to_string());
+        }
+
+        return result;
+    }
+};
+
+} // namespace
+
+
+TEST(SymbolTable, Intern) {
+    loltoml::symbol_table_t symbols;
+
+    loltoml::symbol_t a = symbols.intern("a");
+    loltoml::symbol_t b = symbols.intern(std::string("b"));
+
+    EXPECT_EQ(0u, a.id);
+    EXPECT_EQ(1u, b.id);
+    EXPECT_EQ("a", a.text);
+    EXPECT_EQ("b", b.text);
+    EXPECT_EQ(a, symbols.intern("a"));
+    EXPECT_EQ(2u, symbols.size());
+
+    loltoml::symbol_t found;
+    EXPECT_TRUE(symbols.find("b", found));
+    EXPECT_EQ(b, found);
+    EXPECT_FALSE(symbols.find("c", found));
+
+    EXPECT_EQ("a", symbols.get(0).text);
+}
+
+TEST(SymbolTable, ManySymbols) {
+    loltoml::symbol_table_t symbols;
+
+    for (std::uint32_t i = 0; i < 10000; ++i) {
+        EXPECT_EQ(i, symbols.intern(std::to_string(i)).id);
+    }
+
+    for (std::uint32_t i = 0; i < 10000; ++i) {
+        loltoml::symbol_t symbol = symbols.get(i);
+        EXPECT_EQ(i, symbol.id);
+        EXPECT_EQ(std::to_string(i), symbol.text);
+    }
+}
+
+TEST(SymbolTable, Handler) {
+    loltoml::symbol_table_t symbols;
+    symbol_handler_t handler;
+    loltoml::parser_t<symbol_handler_t> parser(handler);
+    parser.set_symbol_table(symbols);
+
+    parser.parse(loltoml::string_view_t("a = 1\n[b.\"a\"]\nb = {a = 2}\n[[c]]"));
+
+    std::vector<sax_event_t> expected_events = {
+        {sax_event_t::start_document},
+        {sax_event_t::key, "a"},
+        {sax_event_t::integer, std::int64_t(1)},
+        {sax_event_t::table, {"b", "a"}},
+        {sax_event_t::key, "b"},
+        {sax_event_t::start_inline_table},
+        {sax_event_t::key, "a"},
+        {sax_event_t::integer, std::int64_t(2)},
+        {sax_event_t::finish_inline_table, std::size_t(1)},
+        {sax_event_t::table_array_item, {"c"}},
+        {sax_event_t::finish_document}
+    };
+
+    EXPECT_EQ(expected_events, handler.events);
+
+    std::vector<std::uint32_t> expected_ids = {0, 1, 0, 1, 0, 2};
+    EXPECT_EQ(expected_ids, handler.ids);
+    EXPECT_EQ(3u, symbols.size());
+}
+
+TEST(SymbolTable, PrivateTable) {
+    symbol_handler_t handler;
+    loltoml::parse(loltoml::string_view_t("x = 1\ny = 2\n[x.y]"), handler);
+
+    std::vector<std::uint32_t> expected_ids = {0, 1, 0, 1};
+    EXPECT_EQ(expected_ids, handler.ids);
+}
+
+TEST(SymbolTable, SharedBetweenThreads) {
+    loltoml::symbol_table_t symbols;
+    std::string document;
+
+    for (std::size_t i = 0; i < 1000; ++i) {
+        document += "[table" + std::to_string(i % 100) + "]\nkey" + std::to_string(i) + " = 1\n";
+    }
+
+    std::vector<symbol_handler_t> handlers(4);
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 0; i < handlers.size(); ++i) {
+        symbol_handler_t *handler = &handlers[i];
+
+        threads.emplace_back([&symbols, &document, handler] {
+            loltoml::parser_t<symbol_handler_t> parser(*handler);
+            parser.set_symbol_table(symbols);
+
+            for (std::size_t j = 0; j < 10; ++j) {
+                handler->ids.clear();
+                parser.parse(document);
+            }
+        });
+    }
+
+    for (auto it = threads.begin(); it != threads.end(); ++it) {
+        it->join();
+    }
+
+    EXPECT_EQ(1100u, symbols.size());
+
+    for (std::size_t i = 1; i < handlers.size(); ++i) {
+        EXPECT_EQ(handlers[0].ids, handlers[i].ids);
+    }
+
+    EXPECT_EQ(symbols.intern("table5").id, handlers[0].ids[10]);
+    EXPECT_EQ(symbols.intern("key5").id, handlers[0].ids[11]);
+}
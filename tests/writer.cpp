@@ -0,0 +1,181 @@
+#include "common.hpp"
+
+#include "loltoml/writer.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+std::string format_double(double value) {
+    char buffer[loltoml::detail::max_number_size];
+    return std::string(buffer, loltoml::detail::format_double(value, buffer));
+}
+
+std::vector<sax_event_t> parse_events(const std::string &input) {
+    events_aggregator_t handler;
+    loltoml::parse(input.data(), input.size(), handler);
+    return handler.events;
+}
+
+} // namespace
+
+
+TEST(Writer, Document) {
+    std::string output;
+    loltoml::writer_t<> writer(output);
+
+    std::vector<std::string> path = {"server", "main node"};
+
+    writer.start_document();
+    writer.key("title");
+    writer.string("TOML \"example\"");
+    writer.comment(" servers");
+    writer.table(path.cbegin(), path.cend());
+    writer.key("ports");
+    writer.start_array();
+    writer.integer(8001);
+    writer.integer(-8002);
+    writer.finish_array(2);
+    writer.key("limits");
+    writer.start_inline_table();
+    writer.key("cpu");
+    writer.floating_point(1.5);
+    writer.key("enabled");
+    writer.boolean(false);
+    writer.finish_inline_table(2);
+    writer.array_table(path.cbegin(), path.cbegin() + 1);
+    writer.key("started");
+    writer.datetime("1979-05-27T07:32:00Z");
+    writer.finish_document();
+
+    EXPECT_EQ(
+        "title = \"TOML \\\"example\\\"\"\n"
+        "# servers\n"
+        "\n"
+        "[server.\"main node\"]\n"
+        "ports = [8001, -8002]\n"
+        "limits = {cpu = 1.5, enabled = false}\n"
+        "\n"
+        "[[server]]\n"
+        "started = 1979-05-27T07:32:00Z\n",
+        output
+    );
+}
+
+TEST(Writer, Strings) {
+    std::string output;
+    loltoml::writer_t<> writer(output);
+
+    std::string value = "a long string which is scanned with SIMD \\ \"quoted\"\b\t\n\f\r";
+    value.push_back('\0');
+    value += "\x1f\x7f \xd1\x8f";
+
+    writer.key("s");
+    writer.string(value);
+    writer.key("key with spaces");
+    writer.string("");
+
+    EXPECT_EQ(
+        "s = \"a long string which is scanned with SIMD \\\\ \\\"quoted\\\"\\b\\t\\n\\f\\r\\u0000\\u001f\x7f \xd1\x8f\"\n"
+        "\"key with spaces\" = \"\"\n",
+        output
+    );
+
+    std::vector<sax_event_t> events = parse_events(output);
+    ASSERT_EQ(6, events.size());
+    EXPECT_EQ(value, events[2].string_data);
+}
+
+TEST(Writer, Integers) {
+    std::string output;
+    loltoml::writer_t<> writer(output);
+
+    writer.key("a");
+    writer.start_array();
+    writer.integer(0);
+    writer.integer(std::numeric_limits<std::int64_t>::max());
+    writer.integer(std::numeric_limits<std::int64_t>::min());
+    writer.finish_array(3);
+
+    EXPECT_EQ("a = [0, 9223372036854775807, -9223372036854775808]\n", output);
+}
+
+TEST(Writer, Floats) {
+    EXPECT_EQ("0.0", format_double(0.0));
+    EXPECT_EQ("-0.0", format_double(-0.0));
+    EXPECT_EQ("1.0", format_double(1.0));
+    EXPECT_EQ("0.1", format_double(0.1));
+    EXPECT_EQ("-2.5", format_double(-2.5));
+    EXPECT_EQ("1e20", format_double(1e20));
+    EXPECT_EQ("1.5e-7", format_double(1.5e-7));
+    EXPECT_EQ("0.30000000000000004", format_double(0.1 + 0.2));
+    EXPECT_EQ("1.7976931348623157e308", format_double(std::numeric_limits<double>::max()));
+    EXPECT_EQ("5e-324", format_double(std::numeric_limits<double>::denorm_min()));
+
+    // Pseudo-random bit patterns must round-trip through the writer and the parser.
+    std::uint64_t state = 42;
+
+    for (int i = 0; i < 10000; ++i) {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+
+        double value;
+        std::memcpy(&value, &state, sizeof(value));
+
+        if (!std::isfinite(value)) {
+            continue;
+        }
+
+        std::string output;
+        loltoml::writer_t<> writer(output);
+        writer.key("f");
+        writer.floating_point(value);
+
+        std::vector<sax_event_t> events = parse_events(output);
+        ASSERT_EQ(4, events.size()) << output;
+        EXPECT_EQ(value, events[2].float_data) << output;
+    }
+
+    std::string output;
+    loltoml::writer_t<> writer(output);
+    writer.key("f");
+    EXPECT_THROW(writer.floating_point(std::numeric_limits<double>::infinity()), std::invalid_argument);
+    EXPECT_THROW(writer.floating_point(std::numeric_limits<double>::quiet_NaN()), std::invalid_argument);
+}
+
+TEST(Writer, OutputIterator) {
+    std::vector<char> output;
+    auto writer = loltoml::make_writer(std::back_inserter(output));
+
+    writer.key("a");
+    writer.string("b");
+
+    EXPECT_EQ("a = \"b\"\n", std::string(output.begin(), output.end()));
+}
+
+TEST(Writer, Roundtrip) {
+    std::string input =
+        "# header\n"
+        "a = [ [1, 2], # first\n"
+        "  [\"x\", 'y\\z'] ]\n"
+        "b = {c = 1979-05-27T07:32:00Z, d = [{e = 2.5e-3}]}\n"
+        "[\"quoted key\".bare]\n"
+        "s = \"\"\"\n"
+        "multi\\\n"
+        "  line\"\"\"\n"
+        "[[array]]\n"
+        "[[array]]\n"
+        "t = true\n";
+
+    std::ostringstream stream;
+    auto writer = loltoml::make_writer(std::ostreambuf_iterator<char>(stream));
+    loltoml::parse(input.data(), input.size(), writer);
+
+    EXPECT_EQ(parse_events(input), parse_events(stream.str()));
+}